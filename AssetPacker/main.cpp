@@ -0,0 +1,459 @@
+#include "AssetPack.h"
+#include "Ktx2Texture.h"
+#include "MipChain.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#undef STB_IMAGE_IMPLEMENTATION
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// 128x128 RGBA8 tiles are 64 KiB, which is also the standard sparse block size for 32-bit texels
+	std::uint32_t constexpr g_VirtualTileSize{ 128 };
+	std::uint32_t constexpr g_BytesPerPixel{ 4 };
+
+	// virtual textures are streamed into the pack from virtualSourcePath while it gets written, the payload of
+	// every other texture is kept in memory until then
+	struct PackedTexture final
+	{
+		fro::AssetPackEntry entry;
+		std::vector<std::uint8_t> vPayload;
+		std::filesystem::path virtualSourcePath;
+	};
+
+	// an image read top to bottom one RGBA row at a time, so images bigger than memory can be packed
+	struct ImageRows final
+	{
+		std::uint32_t width;
+		std::uint32_t height;
+		std::function<void(std::uint8_t* const pRow)> readRow;
+	};
+
+	std::uint64_t alignUp(std::uint64_t const value, std::uint64_t const alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	void setName(fro::AssetPackEntry& entry, std::string const& name)
+	{
+		if (name.size() >= entry.aName.size())
+			throw std::runtime_error(std::format("{} is too long to be an asset pack entry name!", name));
+
+		std::ranges::copy(name, entry.aName.begin());
+	}
+
+	std::string readPpmToken(std::istream& stream)
+	{
+		std::string token{};
+		while (stream >> token and token.starts_with('#'))
+			stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+		return token;
+	}
+
+	// binary PPMs (P6) are streamed straight from disk, anything else goes through stbi and has to fit in memory
+	ImageRows openImageRows(std::filesystem::path const& filePath)
+	{
+		if (filePath.extension() == ".ppm")
+		{
+			auto const pFile{ std::make_shared<std::ifstream>(filePath, std::ifstream::binary) };
+			if (not pFile->is_open())
+				throw std::runtime_error(std::format("couldn't open {}!", filePath.string()));
+
+			std::string const magic{ readPpmToken(*pFile) };
+			std::string const width{ readPpmToken(*pFile) };
+			std::string const height{ readPpmToken(*pFile) };
+			std::string const maximumValue{ readPpmToken(*pFile) };
+			pFile->get();
+
+			if (not *pFile or magic != "P6" or maximumValue != "255")
+				throw std::runtime_error(std::format("{} is not an 8-bit binary PPM!", filePath.string()));
+
+			ImageRows imageRows{ static_cast<std::uint32_t>(std::stoul(width)), static_cast<std::uint32_t>(std::stoul(height)) };
+			imageRows.readRow = [pFile, filePath, vRgb = std::vector<char>(imageRows.width * std::size_t{ 3 })](std::uint8_t* const pRow) mutable
+				{
+					if (not pFile->read(vRgb.data(), static_cast<std::streamsize>(vRgb.size())))
+						throw std::runtime_error(std::format("{} is truncated!", filePath.string()));
+
+					for (std::size_t x{}; x < vRgb.size() / 3; ++x)
+					{
+						std::memcpy(pRow + x * g_BytesPerPixel, vRgb.data() + x * 3, 3);
+						pRow[x * g_BytesPerPixel + 3] = 255;
+					}
+				};
+
+			return imageRows;
+		}
+
+		int width;
+		int height;
+		int channels;
+
+		std::shared_ptr<stbi_uc> const pPixels
+		{
+			stbi_load(filePath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha),
+			stbi_image_free
+		};
+		if (not pPixels)
+			throw std::runtime_error(std::format("stbi_load() failed for {}!", filePath.string()));
+
+		ImageRows imageRows{ static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height) };
+		imageRows.readRow = [pPixels, rowSize = imageRows.width * std::size_t{ g_BytesPerPixel }, row = std::size_t{}](std::uint8_t* const pRow) mutable
+			{
+				std::memcpy(pRow, pPixels.get() + row++ * rowSize, rowSize);
+			};
+
+		return imageRows;
+	}
+
+	// cuts every level into tiles as soon as a tile row's worth of texels has arrived, and box filters that strip
+	// into the next level; only one strip per level is ever held in memory
+	class VirtualTextureWriter final
+	{
+	public:
+		VirtualTextureWriter(std::ofstream& file, fro::AssetPackEntry const& entry)
+			: m_File{ file }
+			, m_Entry{ entry }
+			, m_vTile(static_cast<std::size_t>(entry.tileBytes))
+		{
+			for (std::uint32_t level{}; level < entry.levelCount; ++level)
+				m_vStrips.push_back({ std::vector<std::uint8_t>(static_cast<std::size_t>(entry.aLevels[level].width) * entry.tileSize * g_BytesPerPixel) });
+		}
+
+		~VirtualTextureWriter() = default;
+
+		void pushRow(std::uint32_t const level, std::uint8_t const* const pRow)
+		{
+			Strip& strip{ m_vStrips[level] };
+			std::size_t const rowSize{ static_cast<std::size_t>(m_Entry.aLevels[level].width) * g_BytesPerPixel };
+
+			std::memcpy(strip.vRows.data() + strip.rowCount * rowSize, pRow, rowSize);
+			++strip.rowCount;
+			++strip.pushedRows;
+
+			if (strip.rowCount == m_Entry.tileSize or strip.pushedRows == m_Entry.aLevels[level].height)
+				flush(level);
+		}
+
+	private:
+		struct Strip final
+		{
+			std::vector<std::uint8_t> vRows;
+			std::uint32_t rowCount;
+			std::uint32_t pushedRows;
+			std::uint32_t tileRow;
+		};
+
+		VirtualTextureWriter(VirtualTextureWriter const&) = delete;
+		VirtualTextureWriter(VirtualTextureWriter&&) noexcept = delete;
+
+		VirtualTextureWriter& operator=(VirtualTextureWriter const&) = delete;
+		VirtualTextureWriter& operator=(VirtualTextureWriter&&) noexcept = delete;
+
+		void flush(std::uint32_t const level)
+		{
+			Strip& strip{ m_vStrips[level] };
+			fro::AssetPackLevel const& packLevel{ m_Entry.aLevels[level] };
+			std::uint32_t const tileCountX{ fro::getTileCountX(m_Entry, level) };
+
+			// the tiles of a tile row are contiguous in the payload; texels past the edge repeat the last one
+			m_File.seekp(static_cast<std::streamoff>(m_Entry.payloadOffset + packLevel.offset + static_cast<std::uint64_t>(strip.tileRow) * tileCountX * m_Entry.tileBytes));
+			for (std::uint32_t tileX{}; tileX < tileCountX; ++tileX)
+			{
+				for (std::uint32_t y{}; y < m_Entry.tileSize; ++y)
+				{
+					std::uint8_t const* const pRow{ strip.vRows.data() + std::min(y, strip.rowCount - 1) * static_cast<std::size_t>(packLevel.width) * g_BytesPerPixel };
+
+					for (std::uint32_t x{}; x < m_Entry.tileSize; ++x)
+						std::memcpy(m_vTile.data() + (static_cast<std::size_t>(y) * m_Entry.tileSize + x) * g_BytesPerPixel,
+							pRow + std::min(tileX * m_Entry.tileSize + x, packLevel.width - 1) * g_BytesPerPixel, g_BytesPerPixel);
+				}
+
+				m_File.write(reinterpret_cast<char const*>(m_vTile.data()), static_cast<std::streamsize>(m_vTile.size()));
+			}
+
+			if (level + 1 < m_Entry.levelCount)
+			{
+				fro::AssetPackLevel const& nextLevel{ m_Entry.aLevels[level + 1] };
+				std::uint32_t const nextRowCount{ std::min((strip.rowCount + 1) / 2, nextLevel.height - m_vStrips[level + 1].pushedRows) };
+
+				std::vector<std::uint8_t> vNextRows(static_cast<std::size_t>(nextLevel.width) * nextRowCount * g_BytesPerPixel);
+				fro::downsampleMipLevel(strip.vRows.data(), packLevel.width, strip.rowCount, vNextRows.data(), nextLevel.width, nextRowCount, m_Entry.format == VK_FORMAT_R8G8B8A8_SRGB);
+
+				for (std::uint32_t row{}; row < nextRowCount; ++row)
+					pushRow(level + 1, vNextRows.data() + static_cast<std::size_t>(row) * nextLevel.width * g_BytesPerPixel);
+			}
+
+			strip.rowCount = 0;
+			++strip.tileRow;
+		}
+
+		std::ofstream& m_File;
+		fro::AssetPackEntry const& m_Entry;
+
+		std::vector<std::uint8_t> m_vTile;
+		std::vector<Strip> m_vStrips{};
+	};
+
+	// only the header is read here, the texels are streamed in by writeAssetPack()
+	PackedTexture packVirtualTexture(std::filesystem::path const& filePath)
+	{
+		PackedTexture packedTexture{ .virtualSourcePath{ filePath } };
+		setName(packedTexture.entry, filePath.stem().string());
+
+		ImageRows const imageRows{ openImageRows(filePath) };
+
+		fro::AssetPackEntry& entry{ packedTexture.entry };
+		entry.format = VK_FORMAT_R8G8B8A8_SRGB;
+		entry.tileSize = g_VirtualTileSize;
+		entry.tileBytes = g_VirtualTileSize * g_VirtualTileSize * g_BytesPerPixel;
+
+		// down to the first level that fits in a single tile, coarser ones would only be padding
+		std::uint32_t width{ imageRows.width };
+		std::uint32_t height{ imageRows.height };
+		for (;;)
+		{
+			if (entry.levelCount == fro::g_AssetPackMaxLevels)
+				throw std::runtime_error(std::format("{} needs more than {} mip levels!", filePath.string(), fro::g_AssetPackMaxLevels));
+
+			fro::AssetPackLevel& level{ entry.aLevels[entry.levelCount] };
+			level = { width, height, entry.payloadSize };
+			level.size = static_cast<std::uint64_t>(fro::getTileCountX(entry, entry.levelCount)) * fro::getTileCountY(entry, entry.levelCount) * entry.tileBytes;
+
+			entry.payloadSize += level.size;
+			++entry.levelCount;
+
+			if (width <= g_VirtualTileSize and height <= g_VirtualTileSize)
+				break;
+
+			width = std::max(width / 2, 1u);
+			height = std::max(height / 2, 1u);
+		}
+
+		return packedTexture;
+	}
+
+	void writeVirtualTexture(std::ofstream& file, PackedTexture const& packedTexture)
+	{
+		ImageRows const imageRows{ openImageRows(packedTexture.virtualSourcePath) };
+		VirtualTextureWriter writer{ file, packedTexture.entry };
+
+		std::vector<std::uint8_t> vRow(static_cast<std::size_t>(imageRows.width) * g_BytesPerPixel);
+		for (std::uint32_t row{}; row < imageRows.height; ++row)
+		{
+			imageRows.readRow(vRow.data());
+			writer.pushRow(0, vRow.data());
+		}
+	}
+
+	PackedTexture packTexture(std::filesystem::path const& filePath)
+	{
+		PackedTexture packedTexture{};
+		setName(packedTexture.entry, filePath.stem().string());
+
+		std::vector<fro::MipLevel> vLevels{};
+		if (filePath.extension() == ".ktx2")
+		{
+			// already block-compressed and mipped offline, the levels are repacked as-is
+			fro::Ktx2Texture ktx2Texture{ fro::readKtx2Texture(filePath.string()) };
+
+			packedTexture.entry.format = ktx2Texture.format;
+			packedTexture.vPayload.resize(ktx2Texture.vLevels.back().offset + ktx2Texture.vLevels.back().size);
+			fro::readKtx2Levels(filePath.string(), ktx2Texture, packedTexture.vPayload.data());
+			vLevels = std::move(ktx2Texture.vLevels);
+		}
+		else
+		{
+			int width;
+			int height;
+			int channels;
+
+			std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> const pPixels
+			{
+				stbi_load(filePath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha),
+				stbi_image_free
+			};
+			if (not pPixels)
+				throw std::runtime_error(std::format("stbi_load() failed for {}!", filePath.string()));
+
+			// expanded to RGBA and mipped here, so the runtime neither decodes nor blits
+			fro::MipChain mipChain{ fro::generateMipChain(pPixels.get(), static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), true) };
+
+			packedTexture.entry.format = VK_FORMAT_R8G8B8A8_SRGB;
+			packedTexture.vPayload = std::move(mipChain.vPixels);
+			vLevels = std::move(mipChain.vLevels);
+		}
+
+		if (vLevels.size() > fro::g_AssetPackMaxLevels)
+			throw std::runtime_error(std::format("{} has more than {} mip levels!", filePath.string(), fro::g_AssetPackMaxLevels));
+
+		packedTexture.entry.levelCount = static_cast<std::uint32_t>(vLevels.size());
+		packedTexture.entry.payloadSize = packedTexture.vPayload.size();
+		for (std::size_t level{}; level < vLevels.size(); ++level)
+			packedTexture.entry.aLevels[level] = { vLevels[level].width, vLevels[level].height, vLevels[level].offset, vLevels[level].size };
+
+		return packedTexture;
+	}
+
+	void writeAssetPack(std::string const& outputPath, std::vector<PackedTexture>& vPackedTextures)
+	{
+		fro::AssetPackHeader const header
+		{
+			.aMagic{ fro::g_aAssetPackMagic },
+			.version{ fro::g_AssetPackVersion },
+			.entryCount{ static_cast<std::uint32_t>(vPackedTextures.size()) },
+			.tocOffset{ sizeof(fro::AssetPackHeader) }
+		};
+
+		std::uint64_t payloadOffset{ header.tocOffset + vPackedTextures.size() * sizeof(fro::AssetPackEntry) };
+		for (PackedTexture& packedTexture : vPackedTextures)
+		{
+			payloadOffset = alignUp(payloadOffset, fro::g_AssetPackPayloadAlignment);
+			packedTexture.entry.payloadOffset = payloadOffset;
+			payloadOffset += packedTexture.entry.payloadSize;
+		}
+
+		std::ofstream file{ outputPath, std::ofstream::binary };
+		if (not file.is_open())
+			throw std::runtime_error(std::format("couldn't open {}!", outputPath));
+
+		file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		for (PackedTexture const& packedTexture : vPackedTextures)
+			file.write(reinterpret_cast<char const*>(&packedTexture.entry), sizeof(packedTexture.entry));
+
+		// seeking past the end leaves the alignment padding zero-filled
+		for (PackedTexture const& packedTexture : vPackedTextures)
+		{
+			if (not packedTexture.virtualSourcePath.empty())
+			{
+				writeVirtualTexture(file, packedTexture);
+				continue;
+			}
+
+			file.seekp(static_cast<std::streamoff>(packedTexture.entry.payloadOffset));
+			file.write(reinterpret_cast<char const*>(packedTexture.vPayload.data()), static_cast<std::streamsize>(packedTexture.vPayload.size()));
+		}
+
+		if (not file)
+			throw std::runtime_error(std::format("couldn't write {}!", outputPath));
+	}
+
+	// an input preceded by --virtual is packed as a tiled virtual texture
+	void pack(std::string const& outputPath, std::vector<std::string> const& vInputPaths)
+	{
+		std::vector<PackedTexture> vPackedTextures{};
+		for (auto inputPath{ vInputPaths.begin() }; inputPath != vInputPaths.end(); ++inputPath)
+		{
+			if (*inputPath == "--virtual")
+			{
+				if (++inputPath == vInputPaths.end())
+					throw std::runtime_error("--virtual needs an image!");
+
+				vPackedTextures.push_back(packVirtualTexture(*inputPath));
+			}
+			else
+				vPackedTextures.push_back(packTexture(*inputPath));
+
+			std::cout << std::format("packed {} ({} levels, {} bytes)\n",
+				*inputPath, vPackedTextures.back().entry.levelCount, vPackedTextures.back().entry.payloadSize);
+		}
+
+		writeAssetPack(outputPath, vPackedTextures);
+	}
+
+	// compares what the runtime does per texture on either path: decoding into memory that then gets copied
+	// into staging, against copying a mapped payload into staging; the OS file cache is warm for both
+	void bench(std::string const& packPath, std::string const& imagePath, std::size_t const textureCount)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		std::vector<std::uint8_t> vStaging{};
+
+		Clock::time_point const decodeStart{ Clock::now() };
+		for (std::size_t index{}; index < textureCount; ++index)
+		{
+			int width;
+			int height;
+			int channels;
+
+			std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> const pPixels
+			{
+				stbi_load(imagePath.c_str(), &width, &height, &channels, STBI_rgb_alpha),
+				stbi_image_free
+			};
+			if (not pPixels)
+				throw std::runtime_error(std::format("stbi_load() failed for {}!", imagePath));
+
+			vStaging.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4);
+			std::memcpy(vStaging.data(), pPixels.get(), vStaging.size());
+		}
+		Clock::duration const decodeTime{ Clock::now() - decodeStart };
+
+		Clock::time_point const packStart{ Clock::now() };
+		fro::AssetPack const assetPack{ packPath };
+		std::span<fro::AssetPackEntry const> const entries{ assetPack.getEntries() };
+		if (entries.empty())
+			throw std::runtime_error(std::format("{} is empty!", packPath));
+
+		for (std::size_t index{}; index < textureCount; ++index)
+		{
+			std::span<std::uint8_t const> const payload{ assetPack.getPayload(entries[index % entries.size()]) };
+
+			vStaging.resize(payload.size());
+			std::memcpy(vStaging.data(), payload.data(), payload.size());
+		}
+		Clock::duration const packTime{ Clock::now() - packStart };
+
+		auto const toMilliseconds{ [](Clock::duration const duration) { return std::chrono::duration<double, std::milli>(duration).count(); } };
+		double const decodeMilliseconds{ toMilliseconds(decodeTime) };
+		double const packMilliseconds{ toMilliseconds(packTime) };
+		double const count{ static_cast<double>(textureCount) };
+
+		std::cout << std::format("stbi_load:  {} textures in {:.2f} ms ({:.4f} ms each, level 0 only)\n", textureCount, decodeMilliseconds, decodeMilliseconds / count);
+		std::cout << std::format("asset pack: {} textures in {:.2f} ms ({:.4f} ms each, full mip chain)\n", textureCount, packMilliseconds, packMilliseconds / count);
+		std::cout << std::format("speedup:    {:.1f}x\n", decodeMilliseconds / packMilliseconds);
+	}
+}
+
+int main(int argumentCount, char** ppArguments)
+{
+	std::vector<std::string> const vArguments(ppArguments + 1, ppArguments + argumentCount);
+
+	try
+	{
+		if (vArguments.size() >= 3 and vArguments[0] == "pack")
+			pack(vArguments[1], { vArguments.begin() + 2, vArguments.end() });
+
+		else if ((vArguments.size() == 3 or vArguments.size() == 4) and vArguments[0] == "bench")
+			bench(vArguments[1], vArguments[2], vArguments.size() == 4 ? std::stoull(vArguments[3]) : 1000);
+
+		else
+		{
+			std::cout <<
+				"usage:\n"
+				"  AssetPacker pack <output.frpk> <texture.ktx2|image|--virtual image.ppm>...\n"
+				"  AssetPacker bench <input.frpk> <image> [texture count, default 1000]\n";
+
+			return 1;
+		}
+	}
+	catch (std::exception const& exception)
+	{
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
\ No newline at end of file
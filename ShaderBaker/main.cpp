@@ -0,0 +1,162 @@
+#include "ShaderCompiler.h"
+#include "ShaderVariants.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::optional<shaderc_shader_kind> getShaderKind(std::filesystem::path const& filePath)
+	{
+		if (filePath.extension() == ".vert")
+			return shaderc_shader_kind::shaderc_vertex_shader;
+
+		if (filePath.extension() == ".frag")
+			return shaderc_shader_kind::shaderc_fragment_shader;
+
+		if (filePath.extension() == ".comp")
+			return shaderc_shader_kind::shaderc_compute_shader;
+
+		return std::nullopt;
+	}
+
+	// compiles every variant of every shader in shadersDirectory into one header; variants that compile to the same
+	// SPIR-V share an array
+	void bake(std::filesystem::path const& shadersDirectory, std::filesystem::path const& outputPath)
+	{
+		std::vector<std::filesystem::path> vShaderPaths{};
+		for (std::filesystem::directory_entry const& entry : std::filesystem::directory_iterator{ shadersDirectory })
+			if (getShaderKind(entry.path()))
+				vShaderPaths.push_back(entry.path());
+
+		// sorted, so the header only changes when the shaders do
+		std::ranges::sort(vShaderPaths);
+
+		std::string arrays{};
+		std::string featureTable{};
+		std::string table{};
+		std::size_t arrayCount{};
+		for (std::filesystem::path const& shaderPath : vShaderPaths)
+		{
+			std::string const shaderFileName{ shaderPath.filename().string() };
+			fro::ShaderVariants shaderVariants{ shadersDirectory.string(), shaderFileName, getShaderKind(shaderPath).value() };
+			std::vector<std::string> const& vFeatureNames{ shaderVariants.getFeatureNames() };
+
+			std::string featureNames{};
+			for (std::string const& featureName : vFeatureNames)
+				featureNames += featureNames.empty() ? featureName : std::format(" {}", featureName);
+
+			featureTable += std::format("\t\t{{ \"{}\", \"{}\" }},\n", shaderFileName, featureNames);
+
+			std::map<std::vector<std::uint32_t> const*, std::size_t> mArrayIndices{};
+			for (std::uint32_t featureMask{}; featureMask < 1u << vFeatureNames.size(); ++featureMask)
+			{
+				std::vector<std::string_view> vEnabledFeatureNames{};
+				for (std::size_t featureIndex{}; featureIndex < vFeatureNames.size(); ++featureIndex)
+					if (featureMask & (1u << featureIndex))
+						vEnabledFeatureNames.push_back(vFeatureNames[featureIndex]);
+
+				std::vector<std::uint32_t> const& vBytecode{ shaderVariants.getBytecode(vEnabledFeatureNames) };
+				auto const [arrayIterator, isInserted] { mArrayIndices.try_emplace(&vBytecode, arrayCount) };
+				if (isInserted)
+				{
+					arrays += std::format("\tstd::uint32_t constexpr g_aShaderBytecode{}[]\n\t{{", arrayCount++);
+					for (std::size_t wordIndex{}; wordIndex < vBytecode.size(); ++wordIndex)
+						arrays += std::format("{}0x{:08x}u,", wordIndex % 8 == 0 ? "\n\t\t" : " ", vBytecode[wordIndex]);
+
+					arrays += "\n\t};\n\n";
+				}
+
+				table += std::format("\t\t{{ \"{}\", g_aShaderBytecode{} }},\n", fro::getShaderVariantName(shaderFileName, vEnabledFeatureNames), arrayIterator->second);
+			}
+		}
+
+		std::string const header
+		{
+			std::format(
+				"// generated by ShaderBaker from {}, don't edit\n"
+				"#if not defined fro_EMBEDDED_SHADERS_HPP\n"
+				"#define fro_EMBEDDED_SHADERS_HPP\n\n"
+				"#include <cstdint>\n"
+				"#include <span>\n"
+				"#include <string_view>\n\n"
+				"namespace fro\n"
+				"{{\n"
+				"{}"
+				"\t// the features are separated by spaces, in the order the shader declares them\n"
+				"\tstruct EmbeddedShaderFeatures final\n"
+				"\t{{\n"
+				"\t\tstd::string_view shaderFileName;\n"
+				"\t\tstd::string_view featureNames;\n"
+				"\t}};\n\n"
+				"\tEmbeddedShaderFeatures constexpr g_aEmbeddedShaderFeatures[]\n"
+				"\t{{\n"
+				"{}"
+				"\t}};\n\n"
+				"\tstruct EmbeddedShader final\n"
+				"\t{{\n"
+				"\t\tstd::string_view name;\n"
+				"\t\tstd::span<std::uint32_t const> bytecode;\n"
+				"\t}};\n\n"
+				"\tEmbeddedShader constexpr g_aEmbeddedShaders[]\n"
+				"\t{{\n"
+				"{}"
+				"\t}};\n"
+				"}}\n\n"
+				"#endif",
+				shadersDirectory.generic_string(), arrays, featureTable, table)
+		};
+
+		for (fro::ShaderStatistics const& statistics : fro::ShaderCompiler::getStatistics())
+			std::cout << std::format("{}: {} bytes and {} instructions compiled, {} bytes and {} instructions optimized\n", statistics.name,
+				statistics.compiledSize.byteSize, statistics.compiledSize.instructionCount, statistics.optimizedSize.byteSize, statistics.optimizedSize.instructionCount);
+
+		// rewriting an unchanged header would recompile whatever includes it on every build
+		{
+			std::ifstream existingFile{ outputPath, std::ifstream::binary };
+			std::string const existingHeader{ std::istreambuf_iterator<char>{ existingFile }, std::istreambuf_iterator<char>{} };
+			if (existingHeader == header)
+				return;
+		}
+
+		std::filesystem::create_directories(outputPath.parent_path());
+		std::ofstream outputFile{ outputPath, std::ofstream::binary };
+		if (not outputFile.is_open())
+			throw std::runtime_error(std::format("couldn't open {}!", outputPath.string()));
+
+		outputFile << header;
+	}
+}
+
+int main(int argumentCount, char** ppArguments)
+{
+	std::vector<std::string> const vArguments(ppArguments + 1, ppArguments + argumentCount);
+
+	try
+	{
+		if (vArguments.size() == 2)
+			bake(vArguments[0], vArguments[1]);
+
+		else
+		{
+			std::cout <<
+				"usage:\n"
+				"  ShaderBaker <shaders directory> <output.hpp>\n";
+
+			return 1;
+		}
+	}
+	catch (std::exception const& exception)
+	{
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
\ No newline at end of file
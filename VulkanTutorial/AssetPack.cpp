@@ -0,0 +1,141 @@
+#include "AssetPack.h"
+
+#include "FormatSupport.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace
+{
+	// offset + size <= containerSize, without overflowing on corrupt values
+	bool isRangeInside(std::uint64_t const offset, std::uint64_t const size, std::uint64_t const containerSize)
+	{
+		return offset <= containerSize and size <= containerSize - offset;
+	}
+
+	// every level's texels, or every tile of every level, within the entry's payload
+	bool areLevelsInsidePayload(fro::AssetPackEntry const& entry)
+	{
+		for (std::uint32_t level{}; level < entry.levelCount; ++level)
+		{
+			fro::AssetPackLevel const& packLevel{ entry.aLevels[level] };
+
+			if (entry.tileSize == 0)
+			{
+				if (not isRangeInside(packLevel.offset, packLevel.size, entry.payloadSize))
+					return false;
+
+				continue;
+			}
+
+			if (packLevel.offset > entry.payloadSize)
+				return false;
+
+			std::uint64_t const tileCount{ static_cast<std::uint64_t>(fro::getTileCountX(entry, level)) * fro::getTileCountY(entry, level) };
+			if (tileCount > (entry.payloadSize - packLevel.offset) / entry.tileBytes)
+				return false;
+		}
+
+		return true;
+	}
+}
+
+#pragma region Constructors/Destructor
+fro::AssetPack::AssetPack(std::string_view const filePath)
+	: m_File{ filePath }
+{
+	std::span<std::uint8_t const> const bytes{ m_File.getBytes() };
+
+	if (bytes.size() < sizeof(AssetPackHeader))
+		throw std::runtime_error(std::format("{} is not an asset pack!", filePath));
+
+	AssetPackHeader const& header{ *reinterpret_cast<AssetPackHeader const*>(bytes.data()) };
+	if (header.aMagic != g_aAssetPackMagic)
+		throw std::runtime_error(std::format("{} is not an asset pack!", filePath));
+
+	if (header.version != g_AssetPackVersion)
+		throw std::runtime_error(std::format("{} is asset pack version {}, expected {}!", filePath, header.version, g_AssetPackVersion));
+
+	if (header.tocOffset % alignof(AssetPackEntry) != 0 or not isRangeInside(header.tocOffset, static_cast<std::uint64_t>(header.entryCount) * sizeof(AssetPackEntry), bytes.size()))
+		throw std::runtime_error(std::format("{} has a truncated table of contents!", filePath));
+
+	m_Entries = { reinterpret_cast<AssetPackEntry const*>(bytes.data() + header.tocOffset), header.entryCount };
+
+	// only the table of contents is validated up front, payloads stay untouched until they're loaded
+	for (std::size_t index{}; index < m_Entries.size(); ++index)
+	{
+		AssetPackEntry const& entry{ m_Entries[index] };
+
+		if (entry.levelCount == 0 or entry.levelCount > g_AssetPackMaxLevels or not isRangeInside(entry.payloadOffset, entry.payloadSize, bytes.size()) or
+			(entry.tileSize != 0 and entry.tileBytes == 0) or not areLevelsInsidePayload(entry))
+			throw std::runtime_error(std::format("{} has a corrupt entry {}!", filePath, index));
+
+		m_umEntryIndices.emplace(getName(entry), index);
+	}
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+fro::AssetPackEntry const* fro::AssetPack::findEntry(std::string_view const name) const
+{
+	auto const entryIndex{ m_umEntryIndices.find(name) };
+	if (entryIndex == m_umEntryIndices.end())
+		return nullptr;
+
+	return &m_Entries[entryIndex->second];
+}
+
+fro::AssetPackEntry const* fro::AssetPack::findSupportedEntry(std::vector<std::string_view> const& vNames, VkPhysicalDevice const physicalDevice) const
+{
+	for (std::string_view const name : vNames)
+	{
+		AssetPackEntry const* const pEntry{ findEntry(name) };
+		if (pEntry and isSampledFormatSupported(pEntry->format, physicalDevice))
+			return pEntry;
+	}
+
+	return nullptr;
+}
+
+std::span<fro::AssetPackEntry const> fro::AssetPack::getEntries() const
+{
+	return m_Entries;
+}
+
+std::span<std::uint8_t const> fro::AssetPack::getPayload(AssetPackEntry const& entry) const
+{
+	return m_File.getBytes().subspan(static_cast<std::size_t>(entry.payloadOffset), static_cast<std::size_t>(entry.payloadSize));
+}
+
+std::span<std::uint8_t const> fro::AssetPack::getTile(AssetPackEntry const& entry, std::uint32_t const level, std::uint32_t const tileX, std::uint32_t const tileY) const
+{
+	if (entry.tileSize == 0)
+		throw std::runtime_error(std::format("{} is not a virtual texture!", getName(entry)));
+
+	if (level >= entry.levelCount or tileX >= getTileCountX(entry, level) or tileY >= getTileCountY(entry, level))
+		throw std::out_of_range(std::format("{} has no tile ({}, {}) in level {}!", getName(entry), tileX, tileY, level));
+
+	std::uint64_t const tileIndex{ static_cast<std::uint64_t>(tileY) * getTileCountX(entry, level) + tileX };
+	return getPayload(entry).subspan(static_cast<std::size_t>(entry.aLevels[level].offset + tileIndex * entry.tileBytes), entry.tileBytes);
+}
+#pragma endregion PublicMethods
+
+
+
+std::string_view fro::getName(AssetPackEntry const& entry)
+{
+	return { entry.aName.data(), static_cast<std::size_t>(std::ranges::find(entry.aName, '\0') - entry.aName.begin()) };
+}
+
+std::uint32_t fro::getTileCountX(AssetPackEntry const& entry, std::uint32_t const level)
+{
+	return (entry.aLevels[level].width + entry.tileSize - 1) / entry.tileSize;
+}
+
+std::uint32_t fro::getTileCountY(AssetPackEntry const& entry, std::uint32_t const level)
+{
+	return (entry.aLevels[level].height + entry.tileSize - 1) / entry.tileSize;
+}
\ No newline at end of file
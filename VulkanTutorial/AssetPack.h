@@ -0,0 +1,107 @@
+#if not defined fro_ASSET_PACK_H
+#define fro_ASSET_PACK_H
+
+#include "MappedFile.h"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fro
+{
+	// on-disk layout: an AssetPackHeader, the table of contents as AssetPackEntry[entryCount], then every payload
+	// starting on a g_AssetPackPayloadAlignment boundary; all fields are little-endian and read in place
+	std::array<char, 8> constexpr g_aAssetPackMagic{ 'F', 'R', 'O', 'P', 'A', 'C', 'K', '\0' };
+	std::uint32_t constexpr g_AssetPackVersion{ 2 };
+	std::uint64_t constexpr g_AssetPackPayloadAlignment{ 64 * 1024 };
+	std::size_t constexpr g_AssetPackMaxLevels{ 16 };
+
+	struct AssetPackHeader final
+	{
+		std::array<char, 8> aMagic;
+		std::uint32_t version;
+		std::uint32_t entryCount;
+		std::uint64_t tocOffset;
+	};
+	static_assert(sizeof(AssetPackHeader) == 24, "AssetPackHeader must match the on-disk layout!");
+
+	// offsets are relative to the start of the entry's payload
+	struct AssetPackLevel final
+	{
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+	static_assert(sizeof(AssetPackLevel) == 24, "AssetPackLevel must match the on-disk layout!");
+
+	// a payload is laid out exactly as it has to land in a staging buffer: RGBA texels (or compressed blocks)
+	// for every level, so loading it is one copy. Virtual textures (tileSize != 0) are instead cut into
+	// tileSize x tileSize tiles of tileBytes each, stored row-major per level, with edge tiles padded by
+	// repeating the last texel so that every tile can be copied the same way
+	struct AssetPackEntry final
+	{
+		std::array<char, 64> aName;
+		VkFormat format;
+		std::uint32_t levelCount;
+		std::uint32_t tileSize;
+		std::uint32_t tileBytes;
+		std::uint64_t payloadOffset;
+		std::uint64_t payloadSize;
+		std::array<AssetPackLevel, g_AssetPackMaxLevels> aLevels;
+	};
+	static_assert(sizeof(AssetPackEntry) == 480, "AssetPackEntry must match the on-disk layout!");
+
+	class AssetPack final
+	{
+	public:
+		AssetPack(std::string_view const filePath);
+
+		~AssetPack() = default;
+
+		[[nodiscard("found asset pack entry ignored!")]]
+		AssetPackEntry const* findEntry(std::string_view const name) const;
+
+		// picks the first entry, in order of preference, whose format the device can sample
+		[[nodiscard("found asset pack entry ignored!")]]
+		AssetPackEntry const* findSupportedEntry(std::vector<std::string_view> const& vNames, VkPhysicalDevice const physicalDevice) const;
+
+		[[nodiscard("asset pack entries ignored!")]]
+		std::span<AssetPackEntry const> getEntries() const;
+
+		[[nodiscard("asset pack payload ignored!")]]
+		std::span<std::uint8_t const> getPayload(AssetPackEntry const& entry) const;
+
+		// the payload of a virtual texture entry's tile
+		[[nodiscard("asset pack tile ignored!")]]
+		std::span<std::uint8_t const> getTile(AssetPackEntry const& entry, std::uint32_t const level, std::uint32_t const tileX, std::uint32_t const tileY) const;
+
+	private:
+		AssetPack(AssetPack const&) = delete;
+		AssetPack(AssetPack&&) noexcept = delete;
+
+		AssetPack& operator=(AssetPack const&) = delete;
+		AssetPack& operator=(AssetPack&&) noexcept = delete;
+
+		MappedFile const m_File;
+		std::span<AssetPackEntry const> m_Entries;
+		std::unordered_map<std::string_view, std::size_t> m_umEntryIndices{};
+	};
+
+	[[nodiscard("asset pack entry name ignored!")]]
+	std::string_view getName(AssetPackEntry const& entry);
+
+	[[nodiscard("virtual texture tile count ignored!")]]
+	std::uint32_t getTileCountX(AssetPackEntry const& entry, std::uint32_t const level);
+
+	[[nodiscard("virtual texture tile count ignored!")]]
+	std::uint32_t getTileCountY(AssetPackEntry const& entry, std::uint32_t const level);
+}
+
+#endif
\ No newline at end of file
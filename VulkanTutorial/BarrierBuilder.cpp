@@ -0,0 +1,152 @@
+#include "BarrierBuilder.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+#pragma region PublicMethods
+fro::ResourceUsageInfo fro::getResourceUsageInfo(ResourceUsage const usage)
+{
+	switch (usage)
+	{
+	case ResourceUsage::ColorAttachmentWrite:
+		return { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+			VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, true };
+
+	case ResourceUsage::DepthAttachmentWrite:
+		return { VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+			VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+			VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, true };
+
+	case ResourceUsage::DepthAttachmentRead:
+		return { VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+			VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, false };
+
+	case ResourceUsage::FragmentSampledRead:
+		return { VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, false };
+
+	case ResourceUsage::ComputeSampledRead:
+		return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, false };
+
+	case ResourceUsage::ComputeStorageRead:
+		return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+			VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, false };
+
+	case ResourceUsage::ComputeStorageWrite:
+		return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, true };
+
+	case ResourceUsage::FragmentStorageWrite:
+		return { VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, true };
+
+	case ResourceUsage::IndirectRead:
+		return { VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+			VK_IMAGE_LAYOUT_UNDEFINED, 0, false };
+
+	case ResourceUsage::TransferRead:
+		return { VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT,
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT, false };
+
+	case ResourceUsage::TransferWrite:
+		return { VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT, true };
+
+	case ResourceUsage::HostRead:
+		return { VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT,
+			VK_IMAGE_LAYOUT_GENERAL, 0, false };
+
+	// the presentation engine waits on the submission's semaphore, so nothing on the device has to
+	case ResourceUsage::Present:
+		return { VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE,
+			VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 0, false };
+	}
+
+	throw std::runtime_error("unknown resource usage!");
+}
+
+fro::ResourceState fro::getResourceState(ResourceUsage const usage)
+{
+	ResourceUsageInfo const usageInfo{ getResourceUsageInfo(usage) };
+	return { usageInfo.stageMask, usageInfo.accessMask, usageInfo.layout };
+}
+
+fro::BarrierBuilder& fro::BarrierBuilder::addImageBarrier(VkImage const image, VkImageSubresourceRange const& subresourceRange, ResourceState const& srcState, ResourceState const& dstState)
+{
+	m_vImageBarriers.push_back(
+		{
+			.sType{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 },
+			.srcStageMask{ srcState.stageMask },
+			.srcAccessMask{ srcState.accessMask & g_WriteAccessMask },
+			.dstStageMask{ dstState.stageMask },
+			.dstAccessMask{ dstState.accessMask },
+			.oldLayout{ srcState.layout },
+			.newLayout{ dstState.layout },
+			.srcQueueFamilyIndex{ VK_QUEUE_FAMILY_IGNORED },
+			.dstQueueFamilyIndex{ VK_QUEUE_FAMILY_IGNORED },
+			.image{ image },
+			.subresourceRange{ subresourceRange }
+		});
+
+	return *this;
+}
+
+fro::BarrierBuilder& fro::BarrierBuilder::addImageBarrier(VkImage const image, VkImageSubresourceRange const& subresourceRange, ResourceUsage const srcUsage, ResourceUsage const dstUsage)
+{
+	return addImageBarrier(image, subresourceRange, getResourceState(srcUsage), getResourceState(dstUsage));
+}
+
+fro::BarrierBuilder& fro::BarrierBuilder::addBufferBarrier(VkBuffer const buffer, ResourceState const& srcState, ResourceState const& dstState)
+{
+	m_vBufferBarriers.push_back(
+		{
+			.sType{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2 },
+			.srcStageMask{ srcState.stageMask },
+			.srcAccessMask{ srcState.accessMask & g_WriteAccessMask },
+			.dstStageMask{ dstState.stageMask },
+			.dstAccessMask{ dstState.accessMask },
+			.srcQueueFamilyIndex{ VK_QUEUE_FAMILY_IGNORED },
+			.dstQueueFamilyIndex{ VK_QUEUE_FAMILY_IGNORED },
+			.buffer{ buffer },
+			.size{ VK_WHOLE_SIZE }
+		});
+
+	return *this;
+}
+
+fro::BarrierBuilder& fro::BarrierBuilder::addBufferBarrier(VkBuffer const buffer, ResourceUsage const srcUsage, ResourceUsage const dstUsage)
+{
+	return addBufferBarrier(buffer, getResourceState(srcUsage), getResourceState(dstUsage));
+}
+
+void fro::BarrierBuilder::record(VkCommandBuffer const commandBuffer) const
+{
+	if (m_vImageBarriers.empty() and m_vBufferBarriers.empty())
+		return;
+
+	VkDependencyInfo const dependencyInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_DEPENDENCY_INFO },
+		.bufferMemoryBarrierCount{ static_cast<std::uint32_t>(m_vBufferBarriers.size()) },
+		.pBufferMemoryBarriers{ m_vBufferBarriers.data() },
+		.imageMemoryBarrierCount{ static_cast<std::uint32_t>(m_vImageBarriers.size()) },
+		.pImageMemoryBarriers{ m_vImageBarriers.data() }
+	};
+
+	vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+}
+
+void fro::BarrierBuilder::flush(VkCommandBuffer const commandBuffer)
+{
+	record(commandBuffer);
+
+	m_vImageBarriers.clear();
+	m_vBufferBarriers.clear();
+}
+
+std::size_t fro::BarrierBuilder::getBarrierCount() const
+{
+	return m_vImageBarriers.size() + m_vBufferBarriers.size();
+}
+#pragma endregion PublicMethods
\ No newline at end of file
@@ -0,0 +1,104 @@
+#if not defined fro_BARRIER_BUILDER_H
+#define fro_BARRIER_BUILDER_H
+
+#include <Vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace fro
+{
+	// how a resource is touched; each one implies the stages, accesses and, for images, the layout
+	enum class ResourceUsage
+	{
+		ColorAttachmentWrite,
+		DepthAttachmentWrite,
+		DepthAttachmentRead,
+		FragmentSampledRead,
+		ComputeSampledRead,
+		ComputeStorageRead,
+		ComputeStorageWrite,
+		FragmentStorageWrite,
+		IndirectRead,
+		TransferRead,
+		TransferWrite,
+		HostRead,
+		Present
+	};
+
+	struct ResourceState final
+	{
+		VkPipelineStageFlags2 stageMask;
+		VkAccessFlags2 accessMask;
+		VkImageLayout layout;
+	};
+
+	// no stages means nothing pending on the resource; with an undefined layout its contents don't matter either,
+	// like a freshly created image or a per frame buffer after the frame's fence wait
+	ResourceState constexpr g_DiscardedResourceState{ VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED };
+
+	// the accesses a barrier has to make available; reads on the source side of a barrier don't do anything
+	VkAccessFlags2 constexpr g_WriteAccessMask
+	{
+		VK_ACCESS_2_SHADER_WRITE_BIT |
+		VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+		VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_2_TRANSFER_WRITE_BIT |
+		VK_ACCESS_2_HOST_WRITE_BIT |
+		VK_ACCESS_2_MEMORY_WRITE_BIT
+	};
+
+	struct ResourceUsageInfo final
+	{
+		VkPipelineStageFlags2 stageMask;
+		VkAccessFlags2 accessMask;
+		VkImageLayout layout;
+		VkImageUsageFlags imageUsage;
+		bool isWrite;
+	};
+
+	[[nodiscard("resource usage info ignored!")]]
+	ResourceUsageInfo getResourceUsageInfo(ResourceUsage const usage);
+
+	[[nodiscard("resource state ignored!")]]
+	ResourceState getResourceState(ResourceUsage const usage);
+
+	// gathers image and buffer barriers and records them all in one vkCmdPipelineBarrier2(); every barrier carries
+	// its own stages, so unrelated transitions batched together don't wait on each other's work
+	class BarrierBuilder final
+	{
+	public:
+		BarrierBuilder() = default;
+		BarrierBuilder(BarrierBuilder&&) noexcept = default;
+
+		~BarrierBuilder() = default;
+
+		BarrierBuilder& operator=(BarrierBuilder&&) noexcept = default;
+
+		BarrierBuilder& addImageBarrier(VkImage const image, VkImageSubresourceRange const& subresourceRange, ResourceState const& srcState, ResourceState const& dstState);
+		BarrierBuilder& addImageBarrier(VkImage const image, VkImageSubresourceRange const& subresourceRange, ResourceUsage const srcUsage, ResourceUsage const dstUsage);
+
+		BarrierBuilder& addBufferBarrier(VkBuffer const buffer, ResourceState const& srcState, ResourceState const& dstState);
+		BarrierBuilder& addBufferBarrier(VkBuffer const buffer, ResourceUsage const srcUsage, ResourceUsage const dstUsage);
+
+		// does nothing without barriers
+		void record(VkCommandBuffer const commandBuffer) const;
+
+		// records and forgets the barriers, so the builder can gather the next batch
+		void flush(VkCommandBuffer const commandBuffer);
+
+		[[nodiscard("barrier count ignored!")]]
+		std::size_t getBarrierCount() const;
+
+	private:
+		BarrierBuilder(BarrierBuilder const&) = delete;
+
+		BarrierBuilder& operator=(BarrierBuilder const&) = delete;
+
+		std::vector<VkImageMemoryBarrier2> m_vImageBarriers{};
+		std::vector<VkBufferMemoryBarrier2> m_vBufferBarriers{};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "FormatSupport.h"
+
+#include <array>
+#include <stdexcept>
+
+namespace
+{
+	bool hasOptimalTilingFeatures(VkFormat const format, VkPhysicalDevice const physicalDevice, VkFormatFeatureFlags const requiredFeatures)
+	{
+		VkFormatProperties formatProperties;
+		vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &formatProperties);
+
+		return (formatProperties.optimalTilingFeatures & requiredFeatures) == requiredFeatures;
+	}
+}
+
+bool fro::isSampledFormatSupported(VkFormat const format, VkPhysicalDevice const physicalDevice)
+{
+	return hasOptimalTilingFeatures(format, physicalDevice,
+		VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+		VK_FORMAT_FEATURE_TRANSFER_DST_BIT);
+}
+
+bool fro::isLinearBlitSupported(VkFormat const format, VkPhysicalDevice const physicalDevice)
+{
+	return hasOptimalTilingFeatures(format, physicalDevice,
+		VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+		VK_FORMAT_FEATURE_BLIT_DST_BIT |
+		VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+}
+
+VkFormat fro::getDepthFormat(VkPhysicalDevice const physicalDevice)
+{
+	std::array constexpr aCandidateFormats
+	{
+		VK_FORMAT_D32_SFLOAT,
+		VK_FORMAT_X8_D24_UNORM_PACK32,
+		VK_FORMAT_D32_SFLOAT_S8_UINT,
+		VK_FORMAT_D24_UNORM_S8_UINT,
+		VK_FORMAT_D16_UNORM
+	};
+
+	for (VkFormat const format : aCandidateFormats)
+		if (hasOptimalTilingFeatures(format, physicalDevice, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT))
+			return format;
+
+	throw std::runtime_error("no supported depth format!");
+}
+VkSampleCountFlags fro::getAttachmentSampleCounts(VkPhysicalDevice const physicalDevice)
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	return properties.limits.framebufferColorSampleCounts & properties.limits.framebufferDepthSampleCounts;
+}
\ No newline at end of file
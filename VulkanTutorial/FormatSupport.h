@@ -0,0 +1,25 @@
+#if not defined fro_FORMAT_SUPPORT_H
+#define fro_FORMAT_SUPPORT_H
+
+#include <Vulkan/vulkan_core.h>
+
+namespace fro
+{
+	// optimal tiling, sampled and uploadable with a buffer to image copy
+	[[nodiscard("format's sampling support result ignored!")]]
+	bool isSampledFormatSupported(VkFormat const format, VkPhysicalDevice const physicalDevice);
+
+	[[nodiscard("format's linear blit support result ignored!")]]
+	bool isLinearBlitSupported(VkFormat const format, VkPhysicalDevice const physicalDevice);
+
+	// the most precise depth only format usable as an optimal tiling depth attachment, falling back to ones with
+	// stencil; throws when there's none
+	[[nodiscard("depth format ignored!")]]
+	VkFormat getDepthFormat(VkPhysicalDevice const physicalDevice);
+
+	// the sample counts a color and a depth attachment rendered together can both have
+	[[nodiscard("attachment sample counts ignored!")]]
+	VkSampleCountFlags getAttachmentSampleCounts(VkPhysicalDevice const physicalDevice);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "FreeListAllocator.h"
+
+#include <algorithm>
+
+#pragma region Constructors/Destructor
+fro::FreeListAllocator::FreeListAllocator(std::uint32_t const capacity)
+{
+	reset(capacity);
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+std::optional<std::uint32_t> fro::FreeListAllocator::allocate(std::uint32_t const size)
+{
+	if (size == 0)
+		return 0;
+
+	auto const freeBlock
+	{
+		std::find_if(m_mFreeBlocks.begin(), m_mFreeBlocks.end(),
+			[size](auto const& block)
+			{
+				return block.second >= size;
+			})
+	};
+
+	if (freeBlock == m_mFreeBlocks.end())
+		return std::nullopt;
+
+	auto const [offset, blockSize] { *freeBlock };
+	m_mFreeBlocks.erase(freeBlock);
+	if (blockSize > size)
+		m_mFreeBlocks.emplace(offset + size, blockSize - size);
+
+	m_FreeSize -= size;
+	return offset;
+}
+
+void fro::FreeListAllocator::free(std::uint32_t offset, std::uint32_t size)
+{
+	if (size == 0)
+		return;
+
+	m_FreeSize += size;
+
+	auto next{ m_mFreeBlocks.lower_bound(offset) };
+	if (next != m_mFreeBlocks.begin())
+	{
+		auto const previous{ std::prev(next) };
+		if (previous->first + previous->second == offset)
+		{
+			offset = previous->first;
+			size += previous->second;
+			m_mFreeBlocks.erase(previous);
+		}
+	}
+
+	if (next != m_mFreeBlocks.end() and offset + size == next->first)
+	{
+		size += next->second;
+		m_mFreeBlocks.erase(next);
+	}
+
+	m_mFreeBlocks.emplace(offset, size);
+}
+
+void fro::FreeListAllocator::reset(std::uint32_t const capacity)
+{
+	m_Capacity = capacity;
+	m_FreeSize = capacity;
+
+	m_mFreeBlocks.clear();
+	if (capacity > 0)
+		m_mFreeBlocks.emplace(0, capacity);
+}
+
+std::uint32_t fro::FreeListAllocator::getCapacity() const
+{
+	return m_Capacity;
+}
+
+std::uint32_t fro::FreeListAllocator::getFreeSize() const
+{
+	return m_FreeSize;
+}
+
+std::uint32_t fro::FreeListAllocator::getLargestFreeBlock() const
+{
+	std::uint32_t largestFreeBlock{};
+	for (auto const& [offset, size] : m_mFreeBlocks)
+		largestFreeBlock = std::max(largestFreeBlock, size);
+
+	return largestFreeBlock;
+}
+#pragma endregion PublicMethods
\ No newline at end of file
@@ -0,0 +1,51 @@
+#if not defined fro_FREE_LIST_ALLOCATOR_H
+#define fro_FREE_LIST_ALLOCATOR_H
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace fro
+{
+	// hands out ranges of [0, capacity) first fit from a list of free blocks sorted by offset; freed ranges merge
+	// with the free blocks they touch, so fragmentation only comes from live ranges in between
+	class FreeListAllocator final
+	{
+	public:
+		explicit FreeListAllocator(std::uint32_t const capacity);
+
+		~FreeListAllocator() = default;
+
+		// the offset of size free units, or none when no single free block is large enough
+		[[nodiscard("allocated offset ignored!")]]
+		std::optional<std::uint32_t> allocate(std::uint32_t const size);
+
+		void free(std::uint32_t const offset, std::uint32_t const size);
+
+		// forgets every allocation
+		void reset(std::uint32_t const capacity);
+
+		[[nodiscard("capacity ignored!")]]
+		std::uint32_t getCapacity() const;
+
+		[[nodiscard("free size ignored!")]]
+		std::uint32_t getFreeSize() const;
+
+		[[nodiscard("largest free block ignored!")]]
+		std::uint32_t getLargestFreeBlock() const;
+
+	private:
+		FreeListAllocator(FreeListAllocator const&) = delete;
+		FreeListAllocator(FreeListAllocator&&) noexcept = delete;
+
+		FreeListAllocator& operator=(FreeListAllocator const&) = delete;
+		FreeListAllocator& operator=(FreeListAllocator&&) noexcept = delete;
+
+		std::uint32_t m_Capacity{};
+		std::uint32_t m_FreeSize{};
+		// free block offsets to their sizes
+		std::map<std::uint32_t, std::uint32_t> m_mFreeBlocks{};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,229 @@
+#include "GeometryBuffer.h"
+
+#include "HelperFunctions.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+	std::uint32_t getRelocatedCapacity(fro::FreeListAllocator const& allocator, std::uint32_t const size)
+	{
+		// compacting alone makes room when there's enough free space, just not in one piece
+		if (allocator.getFreeSize() >= size)
+			return allocator.getCapacity();
+
+		return std::max(2 * allocator.getCapacity(), allocator.getCapacity() - allocator.getFreeSize() + size);
+	}
+}
+
+#pragma region Constructors/Destructor
+fro::GeometryBuffer::GeometryBuffer(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, VkCommandPool const commandPool, VkQueue const graphicsQueue,
+	std::uint32_t const vertexStride, VkIndexType const indexType, std::uint32_t const vertexCapacity, std::uint32_t const indexCapacity):
+	m_LogicalDevice{ logicalDevice },
+	m_PhysicalDevice{ physicalDevice },
+	m_CommandPool{ commandPool },
+	m_GraphicsQueue{ graphicsQueue },
+	m_VertexStride{ vertexStride },
+	m_IndexType{ indexType },
+	m_IndexSize{ indexType == VK_INDEX_TYPE_UINT16 ? 2u : 4u },
+	m_VertexAllocator{ vertexCapacity },
+	m_IndexAllocator{ indexCapacity }
+{
+	createBuffers(vertexCapacity, indexCapacity);
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+fro::GeometryBuffer::MeshHandle fro::GeometryBuffer::addMesh(std::span<std::byte const> const vertices, PackedIndices const& indices)
+{
+	if (indices.type != m_IndexType)
+		throw std::runtime_error("mesh indices don't match the geometry buffer's index type!");
+
+	if (vertices.size() % m_VertexStride != 0)
+		throw std::runtime_error("mesh vertices don't match the geometry buffer's vertex stride!");
+
+	std::uint32_t const vertexCount{ static_cast<std::uint32_t>(vertices.size() / m_VertexStride) };
+
+	std::optional<std::uint32_t> vertexOffset{ m_VertexAllocator.allocate(vertexCount) };
+	std::optional<std::uint32_t> firstIndex{ m_IndexAllocator.allocate(indices.count) };
+	if (not vertexOffset.has_value() or not firstIndex.has_value())
+	{
+		if (vertexOffset.has_value())
+			m_VertexAllocator.free(vertexOffset.value(), vertexCount);
+
+		if (firstIndex.has_value())
+			m_IndexAllocator.free(firstIndex.value(), indices.count);
+
+		relocate(getRelocatedCapacity(m_VertexAllocator, vertexCount), getRelocatedCapacity(m_IndexAllocator, indices.count));
+
+		vertexOffset = m_VertexAllocator.allocate(vertexCount);
+		firstIndex = m_IndexAllocator.allocate(indices.count);
+	}
+
+	VkDeviceSize const vertexBytes{ vertices.size() };
+	VkDeviceSize const indexBytes{ indices.vBytes.size() };
+	VkDeviceSize const stagingSize{ std::max(vertexBytes + indexBytes, VkDeviceSize{ 1 }) };
+
+	auto const pStagingBuffer
+	{
+		createBuffer(m_LogicalDevice, m_PhysicalDevice,
+			stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+	};
+
+	void* pData;
+	if (vkMapMemory(m_LogicalDevice, pStagingBuffer.second.get(), 0, stagingSize, 0, &pData) != VK_SUCCESS)
+		throw std::runtime_error("vkMapMemory() failed!");
+
+	std::memcpy(pData, vertices.data(), static_cast<std::size_t>(vertexBytes));
+	std::memcpy(static_cast<std::byte*>(pData) + vertexBytes, indices.vBytes.data(), static_cast<std::size_t>(indexBytes));
+	vkUnmapMemory(m_LogicalDevice, pStagingBuffer.second.get());
+
+	VkCommandBuffer const commandBuffer{ beginSingleTimeCommands(m_CommandPool, m_LogicalDevice) };
+
+	if (vertexBytes > 0)
+	{
+		VkBufferCopy const vertexRegion{ 0, static_cast<VkDeviceSize>(vertexOffset.value()) * m_VertexStride, vertexBytes };
+		vkCmdCopyBuffer(commandBuffer, pStagingBuffer.first.get(), m_pVertexBuffer.first.get(), 1, &vertexRegion);
+	}
+
+	if (indexBytes > 0)
+	{
+		VkBufferCopy const indexRegion{ vertexBytes, static_cast<VkDeviceSize>(firstIndex.value()) * m_IndexSize, indexBytes };
+		vkCmdCopyBuffer(commandBuffer, pStagingBuffer.first.get(), m_pIndexBuffer.first.get(), 1, &indexRegion);
+	}
+
+	endSingleTimeCommands(commandBuffer, m_GraphicsQueue, m_CommandPool, m_LogicalDevice);
+
+	m_vAllocations.push_back(GeometryAllocation
+		{
+			.vertexOffset{ static_cast<std::int32_t>(vertexOffset.value()) },
+			.firstIndex{ firstIndex.value() },
+			.vertexCount{ vertexCount },
+			.indexCount{ indices.count }
+		});
+
+	return m_vAllocations.size() - 1;
+}
+
+void fro::GeometryBuffer::removeMesh(MeshHandle const meshHandle)
+{
+	std::optional<GeometryAllocation>& allocation{ m_vAllocations.at(meshHandle) };
+	if (not allocation.has_value())
+		return;
+
+	m_VertexAllocator.free(static_cast<std::uint32_t>(allocation->vertexOffset), allocation->vertexCount);
+	m_IndexAllocator.free(allocation->firstIndex, allocation->indexCount);
+	allocation.reset();
+
+	if (isFragmented())
+		relocate(m_VertexAllocator.getCapacity(), m_IndexAllocator.getCapacity());
+}
+
+fro::GeometryAllocation fro::GeometryBuffer::getAllocation(MeshHandle const meshHandle) const
+{
+	return m_vAllocations.at(meshHandle).value();
+}
+
+VkBuffer fro::GeometryBuffer::getVertexBuffer() const
+{
+	return m_pVertexBuffer.first.get();
+}
+
+VkBuffer fro::GeometryBuffer::getIndexBuffer() const
+{
+	return m_pIndexBuffer.first.get();
+}
+
+VkIndexType fro::GeometryBuffer::getIndexType() const
+{
+	return m_IndexType;
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+void fro::GeometryBuffer::createBuffers(std::uint32_t const vertexCapacity, std::uint32_t const indexCapacity)
+{
+	// transfer source too, for relocate() to copy out of
+	m_pVertexBuffer = createBuffer(m_LogicalDevice, m_PhysicalDevice,
+		std::max(static_cast<VkDeviceSize>(vertexCapacity) * m_VertexStride, VkDeviceSize{ m_VertexStride }),
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	m_pIndexBuffer = createBuffer(m_LogicalDevice, m_PhysicalDevice,
+		std::max(static_cast<VkDeviceSize>(indexCapacity) * m_IndexSize, VkDeviceSize{ m_IndexSize }),
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void fro::GeometryBuffer::relocate(std::uint32_t const vertexCapacity, std::uint32_t const indexCapacity)
+{
+	auto pOldVertexBuffer{ std::move(m_pVertexBuffer) };
+	auto pOldIndexBuffer{ std::move(m_pIndexBuffer) };
+	createBuffers(vertexCapacity, indexCapacity);
+
+	m_VertexAllocator.reset(vertexCapacity);
+	m_IndexAllocator.reset(indexCapacity);
+
+	// a fresh allocator hands out offsets back to back, which packs the live meshes in the order they were added
+	std::vector<VkBufferCopy> vVertexRegions{};
+	std::vector<VkBufferCopy> vIndexRegions{};
+	for (std::optional<GeometryAllocation>& allocation : m_vAllocations)
+	{
+		if (not allocation.has_value())
+			continue;
+
+		std::uint32_t const vertexOffset{ m_VertexAllocator.allocate(allocation->vertexCount).value() };
+		std::uint32_t const firstIndex{ m_IndexAllocator.allocate(allocation->indexCount).value() };
+
+		if (allocation->vertexCount > 0)
+			vVertexRegions.push_back(
+				{
+					static_cast<VkDeviceSize>(allocation->vertexOffset) * m_VertexStride,
+					static_cast<VkDeviceSize>(vertexOffset) * m_VertexStride,
+					static_cast<VkDeviceSize>(allocation->vertexCount) * m_VertexStride
+				});
+
+		if (allocation->indexCount > 0)
+			vIndexRegions.push_back(
+				{
+					static_cast<VkDeviceSize>(allocation->firstIndex) * m_IndexSize,
+					static_cast<VkDeviceSize>(firstIndex) * m_IndexSize,
+					static_cast<VkDeviceSize>(allocation->indexCount) * m_IndexSize
+				});
+
+		allocation->vertexOffset = static_cast<std::int32_t>(vertexOffset);
+		allocation->firstIndex = firstIndex;
+	}
+
+	// also waits for the frames still reading the old buffers before they get destroyed
+	VkCommandBuffer const commandBuffer{ beginSingleTimeCommands(m_CommandPool, m_LogicalDevice) };
+
+	if (not vVertexRegions.empty())
+		vkCmdCopyBuffer(commandBuffer, pOldVertexBuffer.first.get(), m_pVertexBuffer.first.get(), static_cast<std::uint32_t>(vVertexRegions.size()), vVertexRegions.data());
+
+	if (not vIndexRegions.empty())
+		vkCmdCopyBuffer(commandBuffer, pOldIndexBuffer.first.get(), m_pIndexBuffer.first.get(), static_cast<std::uint32_t>(vIndexRegions.size()), vIndexRegions.data());
+
+	endSingleTimeCommands(commandBuffer, m_GraphicsQueue, m_CommandPool, m_LogicalDevice);
+}
+
+bool fro::GeometryBuffer::isFragmented() const
+{
+	auto const isAllocatorFragmented
+	{
+		[](FreeListAllocator const& allocator)
+		{
+			return static_cast<float>(allocator.getLargestFreeBlock()) < static_cast<float>(allocator.getFreeSize()) * g_GeometryDefragmentationThreshold;
+		}
+	};
+
+	return isAllocatorFragmented(m_VertexAllocator) or isAllocatorFragmented(m_IndexAllocator);
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
@@ -0,0 +1,94 @@
+#if not defined fro_GEOMETRY_BUFFER_H
+#define fro_GEOMETRY_BUFFER_H
+
+#include "FreeListAllocator.h"
+#include "HelperStructs.h"
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace fro
+{
+	// relocating live meshes pays off once the largest free block holds less than this fraction of the free space
+	float constexpr g_GeometryDefragmentationThreshold{ 0.5f };
+
+	// where a mesh lives in the geometry buffer; its indices are relative to its first vertex, so drawing it takes
+	// firstIndex and vertexOffset
+	struct GeometryAllocation final
+	{
+		std::int32_t vertexOffset;
+		std::uint32_t firstIndex;
+		std::uint32_t vertexCount;
+		std::uint32_t indexCount;
+	};
+
+	// one device local vertex buffer and one index buffer every mesh is suballocated from, so a frame binds them
+	// once however many meshes it draws. Both are carved up by a FreeListAllocator in vertices and indices;
+	// running out of space compacts the live meshes to the front of new buffers, growing them when compacting
+	// alone wouldn't make room, and so does removing a mesh once the free space has fallen apart. Relocating
+	// waits for the queue to go idle, so it belongs to loading and unloading rather than to a frame
+	class GeometryBuffer final
+	{
+	public:
+		using MeshHandle = std::size_t;
+
+		// every mesh shares the vertex layout of vertexStride bytes and the index type
+		GeometryBuffer(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, VkCommandPool const commandPool, VkQueue const graphicsQueue,
+			std::uint32_t const vertexStride, VkIndexType const indexType, std::uint32_t const vertexCapacity, std::uint32_t const indexCapacity);
+
+		~GeometryBuffer() = default;
+
+		// indices have to be of the buffer's index type
+		[[nodiscard("mesh handle ignored!")]]
+		MeshHandle addMesh(std::span<std::byte const> const vertices, PackedIndices const& indices);
+
+		void removeMesh(MeshHandle const meshHandle);
+
+		// moves when meshes get added or removed
+		[[nodiscard("geometry allocation ignored!")]]
+		GeometryAllocation getAllocation(MeshHandle const meshHandle) const;
+
+		[[nodiscard("vertex buffer ignored!")]]
+		VkBuffer getVertexBuffer() const;
+
+		[[nodiscard("index buffer ignored!")]]
+		VkBuffer getIndexBuffer() const;
+
+		[[nodiscard("index type ignored!")]]
+		VkIndexType getIndexType() const;
+
+	private:
+		GeometryBuffer(GeometryBuffer const&) = delete;
+		GeometryBuffer(GeometryBuffer&&) noexcept = delete;
+
+		GeometryBuffer& operator=(GeometryBuffer const&) = delete;
+		GeometryBuffer& operator=(GeometryBuffer&&) noexcept = delete;
+
+		void createBuffers(std::uint32_t const vertexCapacity, std::uint32_t const indexCapacity);
+		void relocate(std::uint32_t const vertexCapacity, std::uint32_t const indexCapacity);
+		bool isFragmented() const;
+
+		VkDevice const m_LogicalDevice;
+		VkPhysicalDevice const m_PhysicalDevice;
+		VkCommandPool const m_CommandPool;
+		VkQueue const m_GraphicsQueue;
+		std::uint32_t const m_VertexStride;
+		VkIndexType const m_IndexType;
+		std::uint32_t const m_IndexSize;
+
+		FreeListAllocator m_VertexAllocator;
+		FreeListAllocator m_IndexAllocator;
+		std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>> m_pVertexBuffer{};
+		std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>> m_pIndexBuffer{};
+		// none for removed meshes
+		std::vector<std::optional<GeometryAllocation>> m_vAllocations{};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,16 @@
+#if not defined fro_HASHING_HPP
+#define fro_HASHING_HPP
+
+#include <cstddef>
+#include <functional>
+
+namespace fro
+{
+	template<typename TYPE>
+	void hashCombine(std::size_t& seed, TYPE const& value)
+	{
+		seed ^= std::hash<TYPE>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -1,6 +1,12 @@
 #include "HelperFunctions.h"
-
-#include "ShaderCompiler.h"
+#include "BarrierBuilder.h"
+#include "GeometryBuffer.h"
+#include "MeshletCuller.h"
+#include "PipelineLibrary.h"
+#include "PipelineStatisticsQueries.h"
+#include "RenderGraph.h"
+#include "TimestampQueries.h"
+#include "Upscaler.h"
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
@@ -40,9 +46,18 @@ VkInstance fro::createInstance()
 		if (!isInstanceExtensionAvailable(requiredExtensionName))
 			throw std::runtime_error(std::format("extension {} is not available!", requiredExtensionName));
 
+	// 1.3 for vkCmdPipelineBarrier2() and vkCmdBeginRendering(), and the vkGetPhysicalDevice*2() queries optional extensions like
+	// VK_EXT_memory_budget report through
+	VkApplicationInfo const applicationInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_APPLICATION_INFO },
+		.apiVersion{ VK_API_VERSION_1_3 }
+	};
+
 	VkInstanceCreateInfo const instanceCreateInfo
 	{
 		.sType{ VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO },
+		.pApplicationInfo{ &applicationInfo },
 #ifndef NDEBUG
 		.enabledLayerCount{ static_cast<uint32_t>(vRequiredValidationLayerNames.size()) },
 		.ppEnabledLayerNames{ vRequiredValidationLayerNames.data() },
@@ -89,7 +104,7 @@ VkPhysicalDevice fro::pickSuitedPhysicalDevice(VkInstance const instance, VkSurf
 	return *suitablePhysicalDeviceIterator;
 }
 
-VkDevice fro::createLogicalDevice(VkPhysicalDevice const physicalDevice, VkSurfaceKHR const windowSurface, std::vector<std::string_view> const& vPhyicalDeviceExtensionNames)
+VkDevice fro::createLogicalDevice(VkPhysicalDevice const physicalDevice, VkSurfaceKHR const windowSurface, std::vector<std::string_view> const& vPhyicalDeviceExtensionNames, std::vector<std::string_view> const& vOptionalPhysicalDeviceExtensionNames)
 {
 	QueueFamilyIndices const availableQueueFamilyIndices{ getAvailableQueueFamiliesIndices(physicalDevice, windowSurface) };
 
@@ -110,19 +125,64 @@ VkDevice fro::createLogicalDevice(VkPhysicalDevice const physicalDevice, VkSurfa
 		);
 	}
 
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
 	VkPhysicalDeviceFeatures enabledPhysicalDeviceFeatures{};
 	enabledPhysicalDeviceFeatures.samplerAnisotropy = VK_TRUE;
+	enabledPhysicalDeviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+	enabledPhysicalDeviceFeatures.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+	enabledPhysicalDeviceFeatures.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
+	// virtual texturing: tiles bound page by page when possible, and the shader's tile feedback
+	enabledPhysicalDeviceFeatures.sparseBinding = supportedFeatures.sparseBinding;
+	enabledPhysicalDeviceFeatures.sparseResidencyImage2D = supportedFeatures.sparseResidencyImage2D;
+	enabledPhysicalDeviceFeatures.fragmentStoresAndAtomics = supportedFeatures.fragmentStoresAndAtomics;
+	// meshlet culling: all of a mesh's meshlet draws in one indirect call
+	enabledPhysicalDeviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+	// fragment shader invocation counts, to see what the depth pre-pass saves
+	enabledPhysicalDeviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
 
 	std::vector<char const*> vpPhyicalDeviceExtensionNames{};
 	for (std::string_view physicalDeviceExtensionName : vPhyicalDeviceExtensionNames)
 		vpPhyicalDeviceExtensionNames.push_back(physicalDeviceExtensionName.data());
 
+	for (std::string_view optionalPhysicalDeviceExtensionName : vOptionalPhysicalDeviceExtensionNames)
+		if (isPhysicalDeviceExtensionAvailable(optionalPhysicalDeviceExtensionName, physicalDevice))
+			vpPhyicalDeviceExtensionNames.push_back(optionalPhysicalDeviceExtensionName.data());
+
+	// lets PipelineLibrary leave the sample count and blending to be set while recording
+	VkPhysicalDeviceExtendedDynamicState3FeaturesEXT enabledExtendedDynamicState3Features{ getExtendedDynamicState3Features(physicalDevice) };
+	bool const isExtendedDynamicState3Enabled{ isPhysicalDeviceExtensionAvailable(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME, physicalDevice) };
+
+	// lets PipelineLibrary build pipelines out of independently created parts
+	VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT enabledGraphicsPipelineLibraryFeatures
+	{
+		.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT },
+		.pNext{ isExtendedDynamicState3Enabled ? &enabledExtendedDynamicState3Features : nullptr },
+		.graphicsPipelineLibrary{ VK_TRUE }
+	};
+	bool const isGraphicsPipelineLibraryEnabled{ isGraphicsPipelineLibrarySupported(physicalDevice) };
+
+	// barriers are recorded through BarrierBuilder, and passes render without render pass or framebuffer objects
+	VkPhysicalDeviceVulkan13Features enabledVulkan13Features
+	{
+		.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES },
+		.pNext
+		{
+			isGraphicsPipelineLibraryEnabled ? static_cast<void*>(&enabledGraphicsPipelineLibraryFeatures) :
+			isExtendedDynamicState3Enabled ? static_cast<void*>(&enabledExtendedDynamicState3Features) : nullptr
+		},
+		.synchronization2{ VK_TRUE },
+		.dynamicRendering{ VK_TRUE }
+	};
+
 	VkDeviceCreateInfo const logicalDeviceCreateInfo
 	{
 		.sType{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO },
+		.pNext{ &enabledVulkan13Features },
 		.queueCreateInfoCount{ static_cast<std::uint32_t>(vLogicalDeviceQueueFamilyCreateInfos.size()) },
 		.pQueueCreateInfos{ vLogicalDeviceQueueFamilyCreateInfos.data() },
-		.enabledExtensionCount{ static_cast<std::uint32_t>(vPhyicalDeviceExtensionNames.size()) },
+		.enabledExtensionCount{ static_cast<std::uint32_t>(vpPhyicalDeviceExtensionNames.size()) },
 		.ppEnabledExtensionNames{ vpPhyicalDeviceExtensionNames.data() },
 		.pEnabledFeatures{ &enabledPhysicalDeviceFeatures }
 	};
@@ -147,6 +207,8 @@ VkSwapchainKHR fro::createSwapChain(GLFWwindow* const pWindow, VkPhysicalDevice
 	SwapChainSupportDetails const swapChainSupportDetails{ getSwapChainSupportDetails(physicalDevice, windowSurface) };
 
 	VkSurfaceCapabilitiesKHR const& swapChainCapabilties{ swapChainSupportDetails.capabilities };
+	if (not (swapChainCapabilties.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+		throw std::runtime_error("swap chain images can't be copied to!");
 
 	VkExtent2D localSwapChainImageExtent;
 	if (swapChainCapabilties.currentExtent.width != std::numeric_limits<std::uint32_t>::max())
@@ -237,7 +299,8 @@ VkSwapchainKHR fro::createSwapChain(GLFWwindow* const pWindow, VkPhysicalDevice
 		.imageColorSpace{ swapChainSurfaceFormatIterator->colorSpace },
 		.imageExtent{ localSwapChainImageExtent },
 		.imageArrayLayers{ 1 },
-		.imageUsage{ VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT },
+		// the upscaled scene gets copied in
+		.imageUsage{ VK_IMAGE_USAGE_TRANSFER_DST_BIT },
 		.imageSharingMode{ imageSharingMode },
 		.queueFamilyIndexCount{ queueFamilyIndexCount },
 		.pQueueFamilyIndices{ pQueueFamilyIndices },
@@ -258,15 +321,6 @@ VkSwapchainKHR fro::createSwapChain(GLFWwindow* const pWindow, VkPhysicalDevice
 	return swapChain;
 }
 
-std::vector<std::unique_ptr<VkImageView_T, std::function<void(VkImageView_T*)>>> fro::createSwapChainImageViews(std::vector<VkImage> const& vSwapChainImages, VkFormat const swapChainImageFormat, VkDevice const logicalDevice)
-{
-	std::vector<std::unique_ptr<VkImageView_T, std::function<void(VkImageView_T*)>>> vpSwapChainImageViews(vSwapChainImages.size());
-	for (std::uint32_t index{}; index < vSwapChainImages.size(); ++index)
-		vpSwapChainImageViews[index] = createImageView(vSwapChainImages[index], swapChainImageFormat, logicalDevice);
-
-	return vpSwapChainImageViews;
-}
-
 VkShaderModule fro::createShaderModule(std::vector<std::uint32_t> const& vBytecode, VkDevice const logicalDevice)
 {
 	VkShaderModuleCreateInfo shaderModuleCreateInfo
@@ -283,65 +337,15 @@ VkShaderModule fro::createShaderModule(std::vector<std::uint32_t> const& vByteco
 	return shaderModule;
 }
 
-VkRenderPass fro::createRenderPass(VkFormat const swapChainImageFormat, VkDevice const logicalDevice)
-{
-	VkAttachmentDescription const colorAttachmentDescription
-	{
-		.format{ swapChainImageFormat },
-		.samples{ VK_SAMPLE_COUNT_1_BIT },
-		.loadOp{ VK_ATTACHMENT_LOAD_OP_CLEAR },
-		.storeOp{ VK_ATTACHMENT_STORE_OP_STORE },
-		.stencilLoadOp{ VK_ATTACHMENT_LOAD_OP_DONT_CARE },
-		.stencilStoreOp{ VK_ATTACHMENT_STORE_OP_DONT_CARE },
-		.initialLayout{ VK_IMAGE_LAYOUT_UNDEFINED },
-		.finalLayout{ VK_IMAGE_LAYOUT_PRESENT_SRC_KHR }
-	};
-
-	VkAttachmentReference const colorAttachmentReference
-	{
-		.layout{ VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL }
-	};
-
-	VkSubpassDescription const subpassDescription
-	{
-		.pipelineBindPoint{ VK_PIPELINE_BIND_POINT_GRAPHICS },
-		.colorAttachmentCount{ 1 },
-		.pColorAttachments{ &colorAttachmentReference }
-	};
-
-	VkSubpassDependency const subpassDependency
-	{
-		.srcSubpass{ VK_SUBPASS_EXTERNAL },
-		.srcStageMask{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT },
-		.dstStageMask{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT },
-		.dstAccessMask{ VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT }
-	};
-
-	VkRenderPassCreateInfo const renderPassCreateInfo
-	{
-		.sType{ VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO },
-		.attachmentCount{ 1 },
-		.pAttachments{ &colorAttachmentDescription },
-		.subpassCount{ 1 },
-		.pSubpasses{ &subpassDescription },
-		.dependencyCount{ 1 },
-		.pDependencies{ &subpassDependency }
-	};
-
-	VkRenderPass renderPass;
-	if (vkCreateRenderPass(logicalDevice, &renderPassCreateInfo, nullptr, &renderPass) != VK_SUCCESS)
-		throw std::runtime_error("vkCreateRenderPass() failed!");
-
-	return renderPass;
-}
-
-VkPipelineLayout fro::createPipelineLayout(VkDevice const logicalDevice, VkDescriptorSetLayout const descriptorSetLayout)
+VkPipelineLayout fro::createPipelineLayout(VkDevice const logicalDevice, std::vector<VkDescriptorSetLayout> const& vDescriptorSetLayouts, std::vector<VkPushConstantRange> const& vPushConstantRanges)
 {
 	VkPipelineLayoutCreateInfo const pipelineLayoutCreateInfo
 	{
 		.sType{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO },
-		.setLayoutCount{ 1 },
-		.pSetLayouts{ &descriptorSetLayout }
+		.setLayoutCount{ static_cast<std::uint32_t>(vDescriptorSetLayouts.size()) },
+		.pSetLayouts{ vDescriptorSetLayouts.data() },
+		.pushConstantRangeCount{ static_cast<std::uint32_t>(vPushConstantRanges.size()) },
+		.pPushConstantRanges{ vPushConstantRanges.data() }
 	};
 
 	VkPipelineLayout pipelineLayout;
@@ -351,44 +355,57 @@ VkPipelineLayout fro::createPipelineLayout(VkDevice const logicalDevice, VkDescr
 	return pipelineLayout;
 }
 
-VkPipeline fro::createPipeline(VkDevice const logicalDevice, VkExtent2D const swapChainExtent, VkPipelineLayout const pipelineLayout, VkRenderPass const renderPass)
+VkPipeline fro::createPipeline(VkDevice const logicalDevice, VkExtent2D const swapChainExtent, VkPipelineLayout const pipelineLayout, VkFormat const colorAttachmentFormat, DepthState const& depthState, MaterialState const& materialState, VkSampleCountFlagBits const sampleCount, std::vector<VkDynamicState> const& vExtendedDynamicStates, std::vector<std::uint32_t> const& vVertexShaderBytecode, std::vector<std::uint32_t> const& vFragmentShaderBytecode, std::vector<std::uint32_t> const& vFragmentSpecializationConstants)
 {
-	ShaderCompiler compiler{ "Shaders" };
+	bool const isDepthOnly{ vFragmentShaderBytecode.empty() };
 
 	std::unique_ptr<VkShaderModule_T, std::function<void(VkShaderModule_T*)>> const pVertexShaderModule
 	{
-		createShaderModule(compiler("hardCodedTriangle.vert", shaderc_shader_kind::shaderc_vertex_shader), logicalDevice),
+		createShaderModule(vVertexShaderBytecode, logicalDevice),
 		std::bind(vkDestroyShaderModule, logicalDevice, std::placeholders::_1, nullptr)
 	};
 
 	std::unique_ptr<VkShaderModule_T, std::function<void(VkShaderModule_T*)>> const pFragmentShaderModule
 	{
-		createShaderModule(compiler("hardCodedTriangle.frag", shaderc_shader_kind::shaderc_fragment_shader), logicalDevice),
+		isDepthOnly ? VK_NULL_HANDLE : createShaderModule(vFragmentShaderBytecode, logicalDevice),
 		std::bind(vkDestroyShaderModule, logicalDevice, std::placeholders::_1, nullptr)
 	};
 
-	std::vector<VkPipelineShaderStageCreateInfo> const vShaderStageCreateInfos
+	std::vector<VkPipelineShaderStageCreateInfo> vShaderStageCreateInfos
 	{
 		{
 			.sType{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO },
 			.stage{ VK_SHADER_STAGE_VERTEX_BIT },
 			.module{ pVertexShaderModule.get() },
 			.pName{ "main" }
-		},
-
-		{
-			.sType{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO },
-			.stage{ VK_SHADER_STAGE_FRAGMENT_BIT },
-			.module{ pFragmentShaderModule.get() },
-			.pName{ "main" }
 		}
 	};
 
-	std::vector<VkDynamicState> const vDynamicStates
+	std::vector<VkSpecializationMapEntry> const vSpecializationMapEntries{ getSpecializationMapEntries(vFragmentSpecializationConstants) };
+	VkSpecializationInfo const specializationInfo
+	{
+		.mapEntryCount{ static_cast<uint32_t>(vSpecializationMapEntries.size()) },
+		.pMapEntries{ vSpecializationMapEntries.data() },
+		.dataSize{ vFragmentSpecializationConstants.size() * sizeof(std::uint32_t) },
+		.pData{ vFragmentSpecializationConstants.data() }
+	};
+
+	if (not isDepthOnly)
+		vShaderStageCreateInfos.push_back(
+			{
+				.sType{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO },
+				.stage{ VK_SHADER_STAGE_FRAGMENT_BIT },
+				.module{ pFragmentShaderModule.get() },
+				.pName{ "main" },
+				.pSpecializationInfo{ vSpecializationMapEntries.empty() ? nullptr : &specializationInfo }
+			});
+
+	std::vector<VkDynamicState> vDynamicStates
 	{
 		VK_DYNAMIC_STATE_VIEWPORT,
 		VK_DYNAMIC_STATE_SCISSOR
 	};
+	vDynamicStates.insert(vDynamicStates.end(), vExtendedDynamicStates.begin(), vExtendedDynamicStates.end());
 
 	VkPipelineDynamicStateCreateInfo const dynamicStateCreateInfo
 	{
@@ -397,15 +414,16 @@ VkPipeline fro::createPipeline(VkDevice const logicalDevice, VkExtent2D const sw
 		.pDynamicStates{ vDynamicStates.data() }
 	};
 
-	auto bindingDescription = Vertex::getBindingDescription();
-	auto attributeDescriptions = Vertex::getAttributeDescriptions();
+	auto constexpr bindingDescription{ getVertexBindingDescription<QuantizedVertex>() };
+	auto constexpr attributeDescriptions{ getVertexAttributeDescriptions<QuantizedVertex>() };
 
 	VkPipelineVertexInputStateCreateInfo const vertexInputStateCreateInfo
 	{
 		.sType{ VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO },
 		.vertexBindingDescriptionCount{ 1 },
 		.pVertexBindingDescriptions{ &bindingDescription },
-		.vertexAttributeDescriptionCount{ static_cast<uint32_t>(attributeDescriptions.size()) },
+		// the position comes first, and is all a depth only vertex shader takes
+		.vertexAttributeDescriptionCount{ isDepthOnly ? 1u : static_cast<uint32_t>(attributeDescriptions.size()) },
 		.pVertexAttributeDescriptions{ attributeDescriptions.data() }
 	};
 
@@ -441,8 +459,8 @@ VkPipeline fro::createPipeline(VkDevice const logicalDevice, VkExtent2D const sw
 		.depthClampEnable{ VK_FALSE },
 		.rasterizerDiscardEnable{ VK_FALSE },
 		.polygonMode{ VK_POLYGON_MODE_FILL },
-		.cullMode{ VK_CULL_MODE_BACK_BIT },
-		.frontFace{ VK_FRONT_FACE_COUNTER_CLOCKWISE },
+		.cullMode{ materialState.cullMode },
+		.frontFace{ materialState.frontFace },
 		.depthBiasEnable{ VK_FALSE },
 		.lineWidth{ 1.0f },
 	};
@@ -450,13 +468,29 @@ VkPipeline fro::createPipeline(VkDevice const logicalDevice, VkExtent2D const sw
 	VkPipelineMultisampleStateCreateInfo const multisampleStateCreateInfo
 	{
 		.sType{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO },
-		.rasterizationSamples{ VK_SAMPLE_COUNT_1_BIT },
+		.rasterizationSamples{ sampleCount },
 		.sampleShadingEnable{ VK_FALSE }
 	};
 
+	VkPipelineDepthStencilStateCreateInfo const depthStencilStateCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO },
+		.depthTestEnable{ VK_TRUE },
+		.depthWriteEnable{ depthState.isWriteEnabled },
+		.depthCompareOp{ depthState.compareOp },
+		.depthBoundsTestEnable{ VK_FALSE },
+		.stencilTestEnable{ VK_FALSE }
+	};
+
 	VkPipelineColorBlendAttachmentState const colorBlendAttachmentState
 	{
-		.blendEnable{ VK_FALSE },
+		.blendEnable{ materialState.isBlendEnabled },
+		.srcColorBlendFactor{ VK_BLEND_FACTOR_SRC_ALPHA },
+		.dstColorBlendFactor{ VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA },
+		.colorBlendOp{ VK_BLEND_OP_ADD },
+		.srcAlphaBlendFactor{ VK_BLEND_FACTOR_ONE },
+		.dstAlphaBlendFactor{ VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA },
+		.alphaBlendOp{ VK_BLEND_OP_ADD },
 		.colorWriteMask{ VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT }
 	};
 
@@ -464,13 +498,23 @@ VkPipeline fro::createPipeline(VkDevice const logicalDevice, VkExtent2D const sw
 	{
 		.sType{ VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO },
 		.logicOpEnable{ VK_FALSE },
-		.attachmentCount{ 1 },
+		.attachmentCount{ isDepthOnly ? 0u : 1u },
 		.pAttachments{ &colorBlendAttachmentState }
 	};
 
+	// only the attachment formats tie the pipeline to what it renders into
+	VkPipelineRenderingCreateInfo const renderingCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO },
+		.colorAttachmentCount{ isDepthOnly ? 0u : 1u },
+		.pColorAttachmentFormats{ &colorAttachmentFormat },
+		.depthAttachmentFormat{ depthState.format }
+	};
+
 	VkGraphicsPipelineCreateInfo const pipelineCreateInfo
 	{
 		.sType{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO },
+		.pNext{ &renderingCreateInfo },
 		.stageCount{ static_cast<std::uint32_t>(vShaderStageCreateInfos.size()) },
 		.pStages{ vShaderStageCreateInfos.data() },
 		.pVertexInputState{ &vertexInputStateCreateInfo },
@@ -478,10 +522,10 @@ VkPipeline fro::createPipeline(VkDevice const logicalDevice, VkExtent2D const sw
 		.pViewportState{ &viewportStateCreateInfo },
 		.pRasterizationState{ &rasterizationStateCreateInfo },
 		.pMultisampleState{ &multisampleStateCreateInfo },
+		.pDepthStencilState{ &depthStencilStateCreateInfo },
 		.pColorBlendState{ &colorBlendStateCreateInfo },
 		.pDynamicState{ &dynamicStateCreateInfo },
-		.layout{ pipelineLayout },
-		.renderPass{ renderPass }
+		.layout{ pipelineLayout }
 	};
 
 	VkPipeline pipeline;
@@ -491,33 +535,46 @@ VkPipeline fro::createPipeline(VkDevice const logicalDevice, VkExtent2D const sw
 	return pipeline;
 }
 
-std::vector<std::unique_ptr<VkFramebuffer_T, std::function<void(VkFramebuffer_T*)>>> fro::createFramebuffers(std::vector<std::unique_ptr<VkImageView_T, std::function<void(VkImageView_T*)>>> const& vSwapChainImageViews, VkRenderPass const renderPass, VkExtent2D const swapChainExtent, VkDevice const logicalDevice)
+VkPipeline fro::createComputePipeline(VkDevice const logicalDevice, VkPipelineLayout const pipelineLayout, std::vector<std::uint32_t> const& vComputeShaderBytecode)
 {
-	std::vector<std::unique_ptr<VkFramebuffer_T, std::function<void(VkFramebuffer_T*)>>> vpSwapChainFrameBuffers(vSwapChainImageViews.size());
-
-	for (size_t index{}; index < vSwapChainImageViews.size(); ++index)
+	std::unique_ptr<VkShaderModule_T, std::function<void(VkShaderModule_T*)>> const pComputeShaderModule
 	{
-		VkImageView aAttachments[]{ vSwapChainImageViews[index].get() };
+		createShaderModule(vComputeShaderBytecode, logicalDevice),
+		std::bind(vkDestroyShaderModule, logicalDevice, std::placeholders::_1, nullptr)
+	};
 
-		VkFramebufferCreateInfo framebufferCreateInfo
+	VkComputePipelineCreateInfo const pipelineCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO },
+		.stage
 		{
-			.sType{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO },
-			.renderPass{ renderPass },
-			.attachmentCount{ 1 },
-			.pAttachments{ aAttachments },
-			.width{ swapChainExtent.width },
-			.height{ swapChainExtent.height },
-			.layers{ 1 }
-		};
+			.sType{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO },
+			.stage{ VK_SHADER_STAGE_COMPUTE_BIT },
+			.module{ pComputeShaderModule.get() },
+			.pName{ "main" }
+		},
+		.layout{ pipelineLayout }
+	};
 
-		VkFramebuffer frameBuffer;
-		if (vkCreateFramebuffer(logicalDevice, &framebufferCreateInfo, nullptr, &frameBuffer) != VK_SUCCESS)
-			throw std::runtime_error("vkCreateFramebuffer() failed!");
+	VkPipeline pipeline;
+	if (vkCreateComputePipelines(logicalDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipeline) != VK_SUCCESS)
+		throw std::runtime_error("vkCreateComputePipelines() failed!");
 
-		vpSwapChainFrameBuffers[index] = { frameBuffer, std::bind(vkDestroyFramebuffer, logicalDevice, std::placeholders::_1, nullptr) };
-	}
+	return pipeline;
+}
 
-	return vpSwapChainFrameBuffers;
+std::vector<VkSpecializationMapEntry> fro::getSpecializationMapEntries(std::vector<std::uint32_t> const& vConstants)
+{
+	std::vector<VkSpecializationMapEntry> vMapEntries(vConstants.size());
+	for (std::uint32_t constantID{}; constantID < vMapEntries.size(); ++constantID)
+		vMapEntries[constantID] =
+		{
+			.constantID{ constantID },
+			.offset{ constantID * static_cast<std::uint32_t>(sizeof(std::uint32_t)) },
+			.size{ sizeof(std::uint32_t) }
+		};
+
+	return vMapEntries;
 }
 
 VkCommandPool fro::createCommandPool(VkPhysicalDevice const physicalDevice, VkSurfaceKHR const surface, VkDevice const logicalDevice)
@@ -555,7 +612,7 @@ std::vector<VkCommandBuffer> fro::createCommandBuffers(VkCommandPool const comma
 	return vCommandBuffers;
 }
 
-void fro::recordCommandBuffer(VkCommandBuffer const commandBuffer, std::uint32_t const imageIndex, VkRenderPass const renderPass, std::vector<std::unique_ptr<VkFramebuffer_T, std::function<void(VkFramebuffer_T*)>>> const& vpSwapChainFramebuffers, VkExtent2D const swapChainExtent, VkPipeline const pipeline, VkBuffer const vertexBuffer, VkBuffer const indexBuffer, std::vector<std::uint16_t> const& vIndices, VkPipelineLayout const pipelineLayout, std::vector<VkDescriptorSet> const& vDescriptorSets, std::uint32_t const currentFrame)
+void fro::recordCommandBuffer(VkCommandBuffer const commandBuffer, RenderGraph& renderGraph, std::uint32_t const imageIndex, std::vector<VkImage> const& vSwapChainImages, VkExtent2D const swapChainExtent, VkFormat const sceneColorFormat, VkExtent2D const renderExtent, VkFormat const depthFormat, VkSampleCountFlagBits const sampleCount, GraphicsPipeline const* const pDepthPrePassPipeline, GraphicsPipeline const* const pPipeline, VkBuffer const vertexBuffer, VkBuffer const indexBuffer, VkIndexType const indexType, GeometryAllocation const& meshAllocation, MeshLod const& lod, std::size_t const lodIndex, MeshletCuller* const pMeshletCuller, VkPipelineLayout const pipelineLayout, std::vector<VkDescriptorSet> const& vDescriptorSets, VkBuffer const feedbackBuffer, Upscaler const& upscaler, float const sharpness, PipelineStatisticsQueries& pipelineStatisticsQueries, TimestampQueries& timestampQueries, std::uint32_t const currentFrame)
 {
 	VkCommandBufferBeginInfo const commandBufferBeginInfo
 	{
@@ -565,51 +622,244 @@ void fro::recordCommandBuffer(VkCommandBuffer const commandBuffer, std::uint32_t
 	if (vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo) != VK_SUCCESS)
 		throw std::runtime_error("vkBeginCommandBuffer() failed!");
 
-	std::vector<VkFramebuffer> vSwapChainFrambuffers(vpSwapChainFramebuffers.size());
-	for (size_t index{}; index < vpSwapChainFramebuffers.size(); ++index)
-		vSwapChainFrambuffers[index] = vpSwapChainFramebuffers[index].get();
+	renderGraph.reset();
 
-	VkClearValue const clearColor{ .color{ 0.0f, 0.0f, 0.0f, 1.0f } };
-	VkRenderPassBeginInfo const renderPassBeginInfo
+	// the acquire semaphore gets waited on at the transfer stage, where the upscaled scene gets copied in
+	RenderGraphResource const swapChainImage
 	{
-		.sType{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO },
-		.renderPass{ renderPass },
-		.framebuffer{ vSwapChainFrambuffers[imageIndex] },
-		.renderArea
-		{
-			.extent{ swapChainExtent }
-		},
-		.clearValueCount{ 1 },
-		.pClearValues{ &clearColor }
+		renderGraph.importImage(vSwapChainImages[imageIndex], VK_IMAGE_ASPECT_COLOR_BIT,
+			{ VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED }, ResourceUsage::Present)
 	};
-	vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-	VkViewport const viewport
-	{
-		.width{ static_cast<float>(swapChainExtent.width) },
-		.height{ static_cast<float>(swapChainExtent.height) },
-		.minDepth{ 0.0f },
-		.maxDepth{ 1.0f }
-	};
-	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	// the scene's images live within the frame, so they follow the swap chain's extent and the sample count
+	// without being recreated alongside them. They're always swap chain sized, and the scene only renders into
+	// their top left renderExtent, so a changing render scale never has them reallocated
+	RenderGraphResource const sceneColorImage{ renderGraph.createImage({ sceneColorFormat, swapChainExtent, VK_SAMPLE_COUNT_1_BIT }) };
+	RenderGraphResource const depthImage{ renderGraph.createImage({ depthFormat, swapChainExtent, sampleCount }) };
 
-	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-	VkBuffer aVertexBuffers[]{ vertexBuffer };
-	VkDeviceSize offsets[]{ 0 };
-	vkCmdBindVertexBuffers(commandBuffer, 0, 1, aVertexBuffers, offsets);
+	// never leaves the forward pass, which resolves it into the scene color image as it ends; the render graph puts
+	// attachment only transients like this in lazily allocated memory, so on tile based GPUs the samples stay on chip
+	bool const isMultisampled{ sampleCount != VK_SAMPLE_COUNT_1_BIT };
+	std::optional<RenderGraphResource> multisampledColorImage{};
+	if (isMultisampled)
+		multisampledColorImage = renderGraph.createImage({ sceneColorFormat, swapChainExtent, sampleCount });
 
-	vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+	RenderGraphResource const upscaledColorImage{ renderGraph.createImage({ g_UpscaledColorFormat, swapChainExtent, VK_SAMPLE_COUNT_1_BIT }) };
+	RenderGraphResource const sharpenedColorImage{ renderGraph.createImage({ g_UpscaledColorFormat, swapChainExtent, VK_SAMPLE_COUNT_1_BIT }) };
 
-	VkRect2D const scissor
+	std::optional<RenderGraphResource> drawCommands{};
+	if (pMeshletCuller)
 	{
-		.extent{ swapChainExtent }
+		drawCommands = renderGraph.importBuffer(pMeshletCuller->getDrawCommandBuffer(currentFrame), g_DiscardedResourceState, std::nullopt);
+		RenderGraphResource const statistics{ renderGraph.importBuffer(pMeshletCuller->getStatisticsBuffer(currentFrame), g_DiscardedResourceState, ResourceUsage::HostRead) };
+
+		renderGraph.addPass("meshlet culling")
+			.write(drawCommands.value(), ResourceUsage::ComputeStorageWrite)
+			.write(statistics, ResourceUsage::TransferWrite)
+			.write(statistics, ResourceUsage::ComputeStorageWrite)
+			.execute(
+				[=, &meshAllocation](VkCommandBuffer const passCommandBuffer)
+				{
+					pMeshletCuller->recordCulling(passCommandBuffer, currentFrame, lodIndex, meshAllocation);
+				});
+	}
+
+	auto const recordMeshDraws
+	{
+		[=, &meshAllocation, &lod, &vDescriptorSets](VkCommandBuffer const passCommandBuffer, GraphicsPipeline const& passPipeline)
+		{
+			VkViewport const viewport
+			{
+				.width{ static_cast<float>(renderExtent.width) },
+				.height{ static_cast<float>(renderExtent.height) },
+				.minDepth{ 0.0f },
+				.maxDepth{ 1.0f }
+			};
+			vkCmdSetViewport(passCommandBuffer, 0, 1, &viewport);
+
+			recordPipelineBind(passCommandBuffer, passPipeline);
+			VkBuffer aVertexBuffers[]{ vertexBuffer };
+			VkDeviceSize offsets[]{ 0 };
+			vkCmdBindVertexBuffers(passCommandBuffer, 0, 1, aVertexBuffers, offsets);
+
+			vkCmdBindIndexBuffer(passCommandBuffer, indexBuffer, 0, indexType);
+
+			VkRect2D const scissor
+			{
+				.extent{ renderExtent }
+			};
+			vkCmdSetScissor(passCommandBuffer, 0, 1, &scissor);
+
+			vkCmdBindDescriptorSets(passCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &vDescriptorSets[currentFrame], 0, nullptr);
+			if (pMeshletCuller)
+				pMeshletCuller->recordDraws(passCommandBuffer, currentFrame);
+			else
+				vkCmdDrawIndexed(passCommandBuffer, lod.indexCount, 1, meshAllocation.firstIndex + lod.firstIndex, meshAllocation.vertexOffset, 0);
+		}
 	};
-	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &vDescriptorSets[currentFrame], 0, nullptr);
-	vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(vIndices.size()), 1, 0, 0, 0);
+	// lays down the nearest depth without shading, so the forward pass's EQUAL test shades every pixel once. Storing
+	// depth across the two passes makes even a lazily allocated depth image need memory of its own
+	bool const isDepthPrePassEnabled{ pDepthPrePassPipeline != nullptr };
+	if (isDepthPrePassEnabled)
+	{
+		RenderGraph::PassBuilder depthPrePass{ renderGraph.addPass("depth pre-pass") };
+		depthPrePass.write(depthImage, ResourceUsage::DepthAttachmentWrite);
+
+		if (drawCommands.has_value())
+			depthPrePass.read(drawCommands.value(), ResourceUsage::IndirectRead);
+
+		depthPrePass.execute(
+			[=, &renderGraph](VkCommandBuffer const passCommandBuffer)
+			{
+				VkRenderingAttachmentInfo const depthAttachmentInfo
+				{
+					.sType{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO },
+					.imageView{ renderGraph.getImageView(depthImage) },
+					.imageLayout{ VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL },
+					.loadOp{ VK_ATTACHMENT_LOAD_OP_CLEAR },
+					.storeOp{ VK_ATTACHMENT_STORE_OP_STORE },
+					.clearValue{ .depthStencil{ 1.0f, 0 } }
+				};
+
+				VkRenderingInfo const renderingInfo
+				{
+					.sType{ VK_STRUCTURE_TYPE_RENDERING_INFO },
+					.renderArea
+					{
+						.extent{ renderExtent }
+					},
+					.layerCount{ 1 },
+					.pDepthAttachment{ &depthAttachmentInfo }
+				};
+				vkCmdBeginRendering(passCommandBuffer, &renderingInfo);
+				recordMeshDraws(passCommandBuffer, *pDepthPrePassPipeline);
+				vkCmdEndRendering(passCommandBuffer);
+			});
+	}
+
+	// resolves write the scene color image as a color attachment too
+	RenderGraph::PassBuilder forwardPass{ renderGraph.addPass("forward") };
+	forwardPass.write(sceneColorImage, ResourceUsage::ColorAttachmentWrite);
+
+	if (isMultisampled)
+		forwardPass.write(multisampledColorImage.value(), ResourceUsage::ColorAttachmentWrite);
+
+	if (isDepthPrePassEnabled)
+		forwardPass.read(depthImage, ResourceUsage::DepthAttachmentRead);
+	else
+		forwardPass.write(depthImage, ResourceUsage::DepthAttachmentWrite);
+
+	if (drawCommands.has_value())
+		forwardPass.read(drawCommands.value(), ResourceUsage::IndirectRead);
 
-	vkCmdEndRenderPass(commandBuffer);
+	// fragment shaders write feedback the host reads back once the frame's fence has signaled
+	if (feedbackBuffer != VK_NULL_HANDLE)
+		forwardPass.write(renderGraph.importBuffer(feedbackBuffer, g_DiscardedResourceState, ResourceUsage::HostRead), ResourceUsage::FragmentStorageWrite);
+
+	forwardPass.execute(
+		[=, &renderGraph](VkCommandBuffer const passCommandBuffer)
+		{
+			// multisampled, only the resolved samples get stored
+			VkRenderingAttachmentInfo colorAttachmentInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO },
+				.imageView{ renderGraph.getImageView(sceneColorImage) },
+				.imageLayout{ VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL },
+				.loadOp{ VK_ATTACHMENT_LOAD_OP_CLEAR },
+				.storeOp{ VK_ATTACHMENT_STORE_OP_STORE },
+				.clearValue{ .color{ 0.0f, 0.0f, 0.0f, 1.0f } }
+			};
+
+			if (isMultisampled)
+			{
+				colorAttachmentInfo.imageView = renderGraph.getImageView(multisampledColorImage.value());
+				colorAttachmentInfo.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+				colorAttachmentInfo.resolveImageView = renderGraph.getImageView(sceneColorImage);
+				colorAttachmentInfo.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+				colorAttachmentInfo.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			}
+
+			// nothing reads depth after this pass
+			VkRenderingAttachmentInfo const depthAttachmentInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO },
+				.imageView{ renderGraph.getImageView(depthImage) },
+				.imageLayout{ isDepthPrePassEnabled ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL },
+				.loadOp{ isDepthPrePassEnabled ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR },
+				.storeOp{ isDepthPrePassEnabled ? VK_ATTACHMENT_STORE_OP_NONE : VK_ATTACHMENT_STORE_OP_DONT_CARE },
+				.clearValue{ .depthStencil{ 1.0f, 0 } }
+			};
+
+			VkRenderingInfo const renderingInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_RENDERING_INFO },
+				.renderArea
+				{
+					.extent{ renderExtent }
+				},
+				.layerCount{ 1 },
+				.colorAttachmentCount{ 1 },
+				.pColorAttachments{ &colorAttachmentInfo },
+				.pDepthAttachment{ &depthAttachmentInfo }
+			};
+			vkCmdBeginRendering(passCommandBuffer, &renderingInfo);
+			if (pPipeline)
+				recordMeshDraws(passCommandBuffer, *pPipeline);
+			vkCmdEndRendering(passCommandBuffer);
+		});
+
+	renderGraph.addPass("upscale")
+		.read(sceneColorImage, ResourceUsage::ComputeSampledRead)
+		.write(upscaledColorImage, ResourceUsage::ComputeStorageWrite)
+		.execute(
+			[=, &upscaler, &renderGraph](VkCommandBuffer const passCommandBuffer)
+			{
+				upscaler.recordUpscale(passCommandBuffer, currentFrame, renderGraph.getImageView(sceneColorImage), renderExtent,
+					renderGraph.getImageView(upscaledColorImage), swapChainExtent);
+			});
+
+	renderGraph.addPass("sharpen")
+		.read(upscaledColorImage, ResourceUsage::ComputeSampledRead)
+		.write(sharpenedColorImage, ResourceUsage::ComputeStorageWrite)
+		.execute(
+			[=, &upscaler, &renderGraph](VkCommandBuffer const passCommandBuffer)
+			{
+				upscaler.recordSharpen(passCommandBuffer, currentFrame, renderGraph.getImageView(upscaledColorImage), renderGraph.getImageView(sharpenedColorImage),
+					swapChainExtent, sharpness);
+			});
+
+	// swap chain images can't be counted on to support storage, but a blit converts to whatever format they have
+	renderGraph.addPass("copy to swap chain")
+		.read(sharpenedColorImage, ResourceUsage::TransferRead)
+		.write(swapChainImage, ResourceUsage::TransferWrite)
+		.execute(
+			[=, &renderGraph](VkCommandBuffer const passCommandBuffer)
+			{
+				VkOffset3D const extentOffset{ static_cast<std::int32_t>(swapChainExtent.width), static_cast<std::int32_t>(swapChainExtent.height), 1 };
+				VkImageBlit const blitRegion
+				{
+					.srcSubresource{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+					.srcOffsets{ {}, extentOffset },
+					.dstSubresource{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+					.dstOffsets{ {}, extentOffset }
+				};
+
+				vkCmdBlitImage(passCommandBuffer,
+					renderGraph.getImage(sharpenedColorImage), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					vSwapChainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					1, &blitRegion, VK_FILTER_NEAREST);
+			});
+
+	renderGraph.compile(currentFrame);
+
+	// counts both passes' fragment shader invocations, which the pre-pass has none of; the timestamps take in
+	// everything the frame does on the GPU, which is what the render scale gets adjusted by
+	pipelineStatisticsQueries.recordBegin(commandBuffer, currentFrame);
+	timestampQueries.recordBegin(commandBuffer, currentFrame);
+	renderGraph.execute(commandBuffer);
+	timestampQueries.recordEnd(commandBuffer, currentFrame);
+	pipelineStatisticsQueries.recordEnd(commandBuffer, currentFrame);
 
 	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
 		throw std::runtime_error("vkEndCommandBuffer() failed!");
@@ -709,64 +959,62 @@ void fro::copyBuffer(VkBuffer const sourceBuffer, VkBuffer const destinationBuff
 	endSingleTimeCommands(commandBuffer, graphicsQueue, commandPool, logicalDevice);
 }
 
-VkDescriptorSetLayout fro::createDescriptorSetLayout(VkDevice const logicalDevice)
+VkDescriptorSetLayout fro::createDescriptorSetLayout(VkDevice const logicalDevice, std::vector<VkDescriptorSetLayoutBinding> const& vBindings)
 {
-	VkDescriptorSetLayoutBinding const uboLayoutBinding
+	VkDescriptorSetLayoutCreateInfo const descriptorSetLayoutCreateInfo
 	{
-		.descriptorType{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER },
-		.descriptorCount{ 1 },
-		.stageFlags{ VK_SHADER_STAGE_VERTEX_BIT }
+		.sType{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO },
+		.bindingCount{ static_cast<std::uint32_t>(vBindings.size()) },
+		.pBindings{ vBindings.data() }
 	};
 
-	VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-	samplerLayoutBinding.binding = 1;
-	samplerLayoutBinding.descriptorCount = 1;
-	samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	samplerLayoutBinding.pImmutableSamplers = nullptr;
-	samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-	std::array<VkDescriptorSetLayoutBinding, 2> bindings = { uboLayoutBinding, samplerLayoutBinding };
-	VkDescriptorSetLayoutCreateInfo layoutInfo{};
-	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-	layoutInfo.pBindings = bindings.data();
-
 	VkDescriptorSetLayout descriptorSetLayout;
-	if (vkCreateDescriptorSetLayout(logicalDevice, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+	if (vkCreateDescriptorSetLayout(logicalDevice, &descriptorSetLayoutCreateInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
 		throw std::runtime_error("vkCreateDescriptorSetLayout() failed!");
 
 	return descriptorSetLayout;
 }
 
-VkDescriptorPool fro::createDescriptorPool(std::uint32_t const framesInFlight, VkDevice const logicalDevice)
+VkDescriptorPool fro::createDescriptorPool(std::vector<VkDescriptorSetLayoutBinding> const& vBindings, std::uint32_t const framesInFlight, VkDevice const logicalDevice)
 {
-	VkDescriptorPoolSize const poolSize
+	std::vector<VkDescriptorPoolSize> vPoolSizes{};
+	for (VkDescriptorSetLayoutBinding const& binding : vBindings)
 	{
-		.type{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER },
-		.descriptorCount{ framesInFlight }
-	};
+		auto const poolSizeIterator
+		{
+			std::find_if
+			(
+				vPoolSizes.begin(), vPoolSizes.end(),
+				[&binding](VkDescriptorPoolSize const& poolSize)
+				{
+					return poolSize.type == binding.descriptorType;
+				}
+			)
+		};
 
-	std::array<VkDescriptorPoolSize, 2> poolSizes{};
-	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	poolSizes[0].descriptorCount = framesInFlight;
-	poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	poolSizes[1].descriptorCount = framesInFlight;
+		if (poolSizeIterator == vPoolSizes.end())
+			vPoolSizes.push_back({ .type{ binding.descriptorType }, .descriptorCount{ binding.descriptorCount * framesInFlight } });
+		else
+			poolSizeIterator->descriptorCount += binding.descriptorCount * framesInFlight;
+	}
 
-	VkDescriptorPoolCreateInfo poolInfo{};
-	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-	poolInfo.pPoolSizes = poolSizes.data();
-	poolInfo.maxSets = framesInFlight;
+	VkDescriptorPoolCreateInfo const descriptorPoolCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO },
+		.maxSets{ framesInFlight },
+		.poolSizeCount{ static_cast<std::uint32_t>(vPoolSizes.size()) },
+		.pPoolSizes{ vPoolSizes.data() }
+	};
 
 	VkDescriptorPool descriptorPool;
-	if (vkCreateDescriptorPool(logicalDevice, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
+	if (vkCreateDescriptorPool(logicalDevice, &descriptorPoolCreateInfo, nullptr, &descriptorPool) != VK_SUCCESS)
 		throw std::runtime_error("vkCreateDescriptorPool() failed!");
 
 	return descriptorPool;
 }
 
 std::pair<std::unique_ptr<VkImage_T, std::function<void(VkImage_T*)>>, std::unique_ptr<VkDeviceMemory_T, std::function<void(VkDeviceMemory_T*)>>>
-fro::createImage(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, std::uint32_t const width, std::uint32_t const height, VkFormat const format, VkImageTiling const tiling, VkImageUsageFlags const usage, VkMemoryPropertyFlags const properties)
+fro::createImage(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, std::uint32_t const width, std::uint32_t const height, std::uint32_t const mipLevels, VkFormat const format, VkImageTiling const tiling, VkImageUsageFlags const usage, VkMemoryPropertyFlags const properties)
 {
 	VkImageCreateInfo const imageInfo
 	{
@@ -779,7 +1027,7 @@ fro::createImage(VkDevice const logicalDevice, VkPhysicalDevice const physicalDe
 			.height{ height },
 			.depth{ 1 }
 		},
-		.mipLevels{ 1 },
+		.mipLevels{ mipLevels },
 		.arrayLayers{ 1 },
 		.samples{ VK_SAMPLE_COUNT_1_BIT },
 		.tiling{ tiling },
@@ -838,7 +1086,7 @@ VkCommandBuffer fro::beginSingleTimeCommands(VkCommandPool const commandPool, Vk
 }
 
 std::unique_ptr<VkImageView_T, std::function<void(VkImageView_T*)>>
-fro::createImageView(VkImage image, VkFormat format, VkDevice logicalDevice)
+fro::createImageView(VkImage image, VkFormat format, VkDevice logicalDevice, std::uint32_t const mipLevels)
 {
 	VkImageViewCreateInfo viewInfo{};
 	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -847,7 +1095,7 @@ fro::createImageView(VkImage image, VkFormat format, VkDevice logicalDevice)
 	viewInfo.format = format;
 	viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 	viewInfo.subresourceRange.baseMipLevel = 0;
-	viewInfo.subresourceRange.levelCount = 1;
+	viewInfo.subresourceRange.levelCount = mipLevels;
 	viewInfo.subresourceRange.baseArrayLayer = 0;
 	viewInfo.subresourceRange.layerCount = 1;
 
@@ -875,12 +1123,67 @@ void fro::endSingleTimeCommands(VkCommandBuffer const commandBuffer, VkQueue con
 	vkFreeCommandBuffers(logicalDevice, commandPool, 1, &commandBuffer);
 }
 
-std::unique_ptr< VkSampler_T, std::function<void(VkSampler_T*)>>
-fro::createTextureSampler(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice)
+void fro::recordMipmapGeneration(VkCommandBuffer const commandBuffer, VkImage const image, std::uint32_t const width, std::uint32_t const height, std::uint32_t const mipLevels)
 {
-	VkPhysicalDeviceProperties properties;
-	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	auto const getLevelRange
+	{
+		[](std::uint32_t const level)
+		{
+			return VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1 };
+		}
+	};
+
+	BarrierBuilder barrierBuilder{};
+
+	std::int32_t levelWidth{ static_cast<std::int32_t>(width) };
+	std::int32_t levelHeight{ static_cast<std::int32_t>(height) };
+	for (std::uint32_t level{ 1 }; level < mipLevels; ++level)
+	{
+		// the previous level has just been written (by the upload or the last blit) and becomes the blit source,
+		// in the same batch as the level before it goes off to the shaders
+		barrierBuilder
+			.addImageBarrier(image, getLevelRange(level - 1), ResourceUsage::TransferWrite, ResourceUsage::TransferRead)
+			.flush(commandBuffer);
+
+		std::int32_t const nextLevelWidth{ std::max(levelWidth / 2, 1) };
+		std::int32_t const nextLevelHeight{ std::max(levelHeight / 2, 1) };
+
+		VkImageBlit const blit
+		{
+			.srcSubresource
+			{
+				.aspectMask{ VK_IMAGE_ASPECT_COLOR_BIT },
+				.mipLevel{ level - 1 },
+				.layerCount{ 1 }
+			},
+			.srcOffsets{ { 0, 0, 0 }, { levelWidth, levelHeight, 1 } },
+			.dstSubresource
+			{
+				.aspectMask{ VK_IMAGE_ASPECT_COLOR_BIT },
+				.mipLevel{ level },
+				.layerCount{ 1 }
+			},
+			.dstOffsets{ { 0, 0, 0 }, { nextLevelWidth, nextLevelHeight, 1 } }
+		};
+		vkCmdBlitImage(commandBuffer,
+			image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			1, &blit, VK_FILTER_LINEAR);
+
+		barrierBuilder.addImageBarrier(image, getLevelRange(level - 1), ResourceUsage::TransferRead, ResourceUsage::FragmentSampledRead);
+
+		levelWidth = nextLevelWidth;
+		levelHeight = nextLevelHeight;
+	}
+
+	// the smallest level is never blitted from, so it goes straight from transfer destination to shader read
+	barrierBuilder
+		.addImageBarrier(image, getLevelRange(mipLevels - 1), ResourceUsage::TransferWrite, ResourceUsage::FragmentSampledRead)
+		.flush(commandBuffer);
+}
 
+VkSamplerCreateInfo fro::getTextureSamplerCreateInfo()
+{
 	VkSamplerCreateInfo samplerInfo{};
 	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
 	samplerInfo.magFilter = VK_FILTER_LINEAR;
@@ -889,18 +1192,22 @@ fro::createTextureSampler(VkDevice const logicalDevice, VkPhysicalDevice const p
 	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
 	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
 	samplerInfo.anisotropyEnable = VK_TRUE;
-	samplerInfo.maxAnisotropy = properties.limits.maxSamplerAnisotropy;
+	samplerInfo.maxAnisotropy = 1.0f;
 	samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
 	samplerInfo.unnormalizedCoordinates = VK_FALSE;
 	samplerInfo.compareEnable = VK_FALSE;
 	samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
 	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	samplerInfo.mipLodBias = 0.0f;
+	samplerInfo.minLod = 0.0f;
+	samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
-	VkSampler textureSampler;
-	if (vkCreateSampler(logicalDevice, &samplerInfo, nullptr, &textureSampler) != VK_SUCCESS)
-		throw std::runtime_error("failed to create texture sampler!");
+	return samplerInfo;
+}
 
-	return { textureSampler, std::bind(vkDestroySampler, logicalDevice, std::placeholders::_1, nullptr) };
+std::vector<fro::QuantizedVertex> fro::quantizeVertices(std::vector<Vertex> const& vVertices)
+{
+	return std::vector<QuantizedVertex>(vVertices.begin(), vVertices.end());
 }
 
 std::vector<VkExtensionProperties> fro::getAvailableInstanceExtensions()
@@ -1083,8 +1390,19 @@ bool fro::isPhysicalDeviceSuitable(VkPhysicalDevice const physicalDevice, VkSurf
 {
 	SwapChainSupportDetails const& swapChainSupportDetails{ getSwapChainSupportDetails(physicalDevice, windowSurface) };
 
-	VkPhysicalDeviceFeatures supportedFeatures;
-	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	if (properties.apiVersion < VK_API_VERSION_1_3)
+		return false;
+
+	VkPhysicalDeviceVulkan13Features supportedVulkan13Features{ .sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES } };
+	VkPhysicalDeviceFeatures2 supportedFeatures
+	{
+		.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 },
+		.pNext{ &supportedVulkan13Features }
+	};
+	vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures);
 
 	return
 		getAvailableQueueFamiliesIndices(physicalDevice, windowSurface).isComplete() and
@@ -1098,6 +1416,8 @@ bool fro::isPhysicalDeviceSuitable(VkPhysicalDevice const physicalDevice, VkSurf
 		) and
 		not swapChainSupportDetails.vFormats.empty() and
 		not swapChainSupportDetails.vPresentModes.empty() and
-		supportedFeatures.samplerAnisotropy;
+		supportedFeatures.features.samplerAnisotropy and
+		supportedVulkan13Features.synchronization2 and
+		supportedVulkan13Features.dynamicRendering;
 }
 #pragma endregion HelperFunctions
\ No newline at end of file
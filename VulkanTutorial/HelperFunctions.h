@@ -9,6 +9,14 @@ struct GLFWwindow;
 
 namespace fro
 {
+	class MeshletCuller;
+	class PipelineStatisticsQueries;
+	struct GeometryAllocation;
+	struct GraphicsPipeline;
+	class RenderGraph;
+	class TimestampQueries;
+	class Upscaler;
+
 	[[nodiscard("handle to created window ignored!")]]
 	GLFWwindow* createWindow(int const width, int const height, std::string_view const title);
 
@@ -22,7 +30,7 @@ namespace fro
 	VkPhysicalDevice pickSuitedPhysicalDevice(VkInstance const instance, VkSurfaceKHR const windowSurface, std::vector<std::string_view> const& vPhyicalDeviceExtensionNames);
 
 	[[nodiscard("handle to logical device ignored!")]]
-	VkDevice createLogicalDevice(VkPhysicalDevice const physicalDevice, VkSurfaceKHR const windowSurface, std::vector<std::string_view> const& vPhyicalDeviceExtensionNames);
+	VkDevice createLogicalDevice(VkPhysicalDevice const physicalDevice, VkSurfaceKHR const windowSurface, std::vector<std::string_view> const& vPhyicalDeviceExtensionNames, std::vector<std::string_view> const& vOptionalPhysicalDeviceExtensionNames);
 
 	[[nodiscard("handle to queue ignored!")]]
 	VkQueue getHandleToQueue(VkDevice const logicalDevice, std::uint32_t const queueFamilyIndex, std::uint32_t const queueIndex);
@@ -30,23 +38,26 @@ namespace fro
 	[[nodiscard("handle to swap chain ignored!")]]
 	VkSwapchainKHR createSwapChain(GLFWwindow* const pWindow, VkPhysicalDevice const physicalDevice, VkSurfaceKHR const windowSurface, VkDevice const logicalDevice, VkFormat& swapChainImageFormat, VkExtent2D& swapChainImageExtent);
 
-	[[nodiscard("created swap chain image views ignored!")]]
-	std::vector<std::unique_ptr<VkImageView_T, std::function<void(VkImageView_T*)>>> createSwapChainImageViews(std::vector<VkImage> const& vSwapChainImages, VkFormat const swapChainImageFormat, VkDevice const logicalDevice);
-
 	[[nodiscard("handle to shader module ignored!")]]
 	VkShaderModule createShaderModule(std::vector<std::uint32_t> const& vBytecode, VkDevice const logicalDevice);
 
-	[[nodiscard("handle to render pass ignored!")]]
-	VkRenderPass createRenderPass(VkFormat const swapChainImageFormat, VkDevice const logicalDevice);
-
 	[[nodiscard("handle to pipeline layout ignored!")]]
-	VkPipelineLayout createPipelineLayout(VkDevice const logicalDevice, VkDescriptorSetLayout const descriptorSetLayout);
+	VkPipelineLayout createPipelineLayout(VkDevice const logicalDevice, std::vector<VkDescriptorSetLayout> const& vDescriptorSetLayouts, std::vector<VkPushConstantRange> const& vPushConstantRanges);
 
+	// renders with dynamic rendering into a single color attachment of colorAttachmentFormat and a depth attachment,
+	// both with sampleCount samples; without fragment shader bytecode it's a depth only pipeline that takes nothing
+	// but the vertices' positions. Whatever vExtendedDynamicStates names is left to be set while recording, on top of
+	// the viewport and scissor. vFragmentSpecializationConstants holds the fragment shader's specialization constants'
+	// values by constant_id
 	[[nodiscard("handle to pipeline ignored!")]]
-	VkPipeline createPipeline(VkDevice const logicalDevice, VkExtent2D const swapChainExtent, VkPipelineLayout const pipelineLayout, VkRenderPass const renderPass);
+	VkPipeline createPipeline(VkDevice const logicalDevice, VkExtent2D const swapChainExtent, VkPipelineLayout const pipelineLayout, VkFormat const colorAttachmentFormat, DepthState const& depthState, MaterialState const& materialState, VkSampleCountFlagBits const sampleCount, std::vector<VkDynamicState> const& vExtendedDynamicStates, std::vector<std::uint32_t> const& vVertexShaderBytecode, std::vector<std::uint32_t> const& vFragmentShaderBytecode, std::vector<std::uint32_t> const& vFragmentSpecializationConstants);
 
-	[[nodiscard("created framebuffers ignored!")]]
-	std::vector<std::unique_ptr<VkFramebuffer_T, std::function<void(VkFramebuffer_T*)>>> createFramebuffers(std::vector<std::unique_ptr<VkImageView_T, std::function<void(VkImageView_T*)>>> const& vSwapChainImageViews, VkRenderPass const renderPass, VkExtent2D const swapChainExtent, VkDevice const logicalDevice);
+	[[nodiscard("handle to compute pipeline ignored!")]]
+	VkPipeline createComputePipeline(VkDevice const logicalDevice, VkPipelineLayout const pipelineLayout, std::vector<std::uint32_t> const& vComputeShaderBytecode);
+
+	// one 32 bit entry per constant, with constant_id i at offset i * 4, for vConstants' data to back
+	[[nodiscard("specialization map entries ignored!")]]
+	std::vector<VkSpecializationMapEntry> getSpecializationMapEntries(std::vector<std::uint32_t> const& vConstants);
 
 	[[nodiscard("handle to command pool ignored!")]]
 	VkCommandPool createCommandPool(VkPhysicalDevice const physicalDevice, VkSurfaceKHR const surface, VkDevice const logicalDevice);
@@ -54,7 +65,13 @@ namespace fro
 	[[nodiscard("created command buffers ignored!")]]
 	std::vector<VkCommandBuffer> createCommandBuffers(VkCommandPool const commandPool, VkDevice const logicalDevice, std::uint32_t const framesInFlight);
 
-	void recordCommandBuffer(VkCommandBuffer const commandBuffer, std::uint32_t const imageIndex, VkRenderPass const renderPass, std::vector<std::unique_ptr<VkFramebuffer_T, std::function<void(VkFramebuffer_T*)>>> const& vpSwapChainFramebuffers, VkExtent2D const swapChainExtent, VkPipeline const pipeline, VkBuffer const vertexBuffer, VkBuffer const indexBuffer, std::vector<std::uint16_t> const& vIndices, VkPipelineLayout const pipelineLayout, std::vector<VkDescriptorSet> const& vDescriptorSets, std::uint32_t const currentFrame);
+	// builds the frame's passes into renderGraph and records them. The scene renders into the top left renderExtent
+	// of a swap chain sized sceneColorFormat image, which gets upscaled and sharpened to the swap chain's extent and
+	// copied into its image. Without a depth pre-pass pipeline the forward pass tests and writes depth itself; with
+	// one, the pipeline has to test for EQUAL depth without writing it. Without a pipeline, the forward pass only clears.
+	// With more than one sample, the forward pass renders into multisampled transients it resolves into the scene
+	// color image
+	void recordCommandBuffer(VkCommandBuffer const commandBuffer, RenderGraph& renderGraph, std::uint32_t const imageIndex, std::vector<VkImage> const& vSwapChainImages, VkExtent2D const swapChainExtent, VkFormat const sceneColorFormat, VkExtent2D const renderExtent, VkFormat const depthFormat, VkSampleCountFlagBits const sampleCount, GraphicsPipeline const* const pDepthPrePassPipeline, GraphicsPipeline const* const pPipeline, VkBuffer const vertexBuffer, VkBuffer const indexBuffer, VkIndexType const indexType, GeometryAllocation const& meshAllocation, MeshLod const& lod, std::size_t const lodIndex, MeshletCuller* const pMeshletCuller, VkPipelineLayout const pipelineLayout, std::vector<VkDescriptorSet> const& vDescriptorSets, VkBuffer const feedbackBuffer, Upscaler const& upscaler, float const sharpness, PipelineStatisticsQueries& pipelineStatisticsQueries, TimestampQueries& timestampQueries, std::uint32_t const currentFrame);
 
 	[[nodiscard("created semaphores ignored!")]]
 	std::vector<std::unique_ptr<VkSemaphore_T, std::function<void(VkSemaphore_T*)>>> createSemaphores(VkDevice const logicalDevice, std::uint32_t const framesInFlight);
@@ -69,27 +86,32 @@ namespace fro
 	void copyBuffer(VkBuffer const sourceBuffer, VkBuffer const destinationBuffer, VkDeviceSize const size, VkCommandPool const commandPool, VkDevice const logicalDevice, VkQueue const graphicsQueue);
 
 	[[nodiscard("created descriptor set layout ignored!")]]
-	VkDescriptorSetLayout createDescriptorSetLayout(VkDevice const logicalDevice);
+	VkDescriptorSetLayout createDescriptorSetLayout(VkDevice const logicalDevice, std::vector<VkDescriptorSetLayoutBinding> const& vBindings);
 
 	[[nodiscard("created descriptor pool layout ignored!")]]
-	VkDescriptorPool createDescriptorPool(std::uint32_t const framesInFlight, VkDevice const logicalDevice);
+	VkDescriptorPool createDescriptorPool(std::vector<VkDescriptorSetLayoutBinding> const& vBindings, std::uint32_t const framesInFlight, VkDevice const logicalDevice);
 
 	[[nodiscard("created texture image ignored!")]]
 	std::pair<std::unique_ptr<VkImage_T, std::function<void(VkImage_T*)>>, std::unique_ptr<VkDeviceMemory_T, std::function<void(VkDeviceMemory_T*)>>>
-	createImage(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, std::uint32_t const width, std::uint32_t const height, VkFormat const format, VkImageTiling const tiling, VkImageUsageFlags const usage, VkMemoryPropertyFlags const properties);
+	createImage(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, std::uint32_t const width, std::uint32_t const height, std::uint32_t const mipLevels, VkFormat const format, VkImageTiling const tiling, VkImageUsageFlags const usage, VkMemoryPropertyFlags const properties);
 
 	[[nodiscard("command buffer ignored!")]]
 	VkCommandBuffer beginSingleTimeCommands(VkCommandPool const commandPool, VkDevice const logicalDevice);
 
 	[[nodiscard("image view ignored!")]]
 	std::unique_ptr<VkImageView_T, std::function<void(VkImageView_T*)>>
-	createImageView(VkImage image, VkFormat format, VkDevice logicalDevice);
+	createImageView(VkImage image, VkFormat format, VkDevice logicalDevice, std::uint32_t const mipLevels);
 
 	void endSingleTimeCommands(VkCommandBuffer const commandBuffer, VkQueue const graphicsQueue, VkCommandPool const commandPool, VkDevice const logicalDevice);
 
-	[[nodiscard("texture sampler ignored!")]]
-	std::unique_ptr< VkSampler_T, std::function<void(VkSampler_T*)>>
-	createTextureSampler(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice);
+	void recordMipmapGeneration(VkCommandBuffer const commandBuffer, VkImage const image, std::uint32_t const width, std::uint32_t const height, std::uint32_t const mipLevels);
+
+	// anisotropy is enabled but left to the SamplerCache quality setting
+	[[nodiscard("texture sampler description ignored!")]]
+	VkSamplerCreateInfo getTextureSamplerCreateInfo();
+
+	[[nodiscard("quantized vertices ignored!")]]
+	std::vector<QuantizedVertex> quantizeVertices(std::vector<Vertex> const& vVertices);
 
 	[[nodiscard("returned available instance extensions ignored!")]]
 	std::vector<VkExtensionProperties> getAvailableInstanceExtensions();
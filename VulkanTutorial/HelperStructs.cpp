@@ -7,41 +7,9 @@ bool fro::QueueFamilyIndices::isComplete() const
 		present.has_value();
 }
 
-VkVertexInputBindingDescription fro::Vertex::getBindingDescription()
+fro::QuantizedVertex::QuantizedVertex(Vertex const& vertex):
+	position{ glm::vec4{ vertex.position, 1.0f } },
+	color{ glm::vec4{ vertex.color, 1.0f } },
+	texCoord{ vertex.texCoord }
 {
-	return VkVertexInputBindingDescription
-	{
-		.stride{ sizeof(Vertex) },
-		.inputRate{ VK_VERTEX_INPUT_RATE_VERTEX }
-	};
-}
-
-std::array<VkVertexInputAttributeDescription, 3> fro::Vertex::getAttributeDescriptions()
-{
-	return std::array<VkVertexInputAttributeDescription, 3>
-	{
-		VkVertexInputAttributeDescription
-		{
-			.location{ 0 },
-			.binding{ 0 },
-			.format{ VK_FORMAT_R32G32_SFLOAT },
-			.offset{ offsetof(Vertex, position) }
-		},
-
-		VkVertexInputAttributeDescription
-		{
-			.location{ 1 },
-			.binding{ 0 },
-			.format{ VK_FORMAT_R32G32B32_SFLOAT },
-			.offset{ offsetof(Vertex, color) }
-		},
-
-		VkVertexInputAttributeDescription
-		{
-			.location{ 2 },
-			.binding{ 0 },
-			.format{ VK_FORMAT_R32G32_SFLOAT },
-			.offset{ offsetof(Vertex, texCoord) }
-		}
-	};
-}
+}
\ No newline at end of file
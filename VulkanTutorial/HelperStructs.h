@@ -1,10 +1,13 @@
 #pragma once
 
+#include "VertexLayout.hpp"
+
 #include <Vulkan/vulkan_core.h>
 #include <glm/glm.hpp>
 #include <optional>
 #include <vector>
 #include <array>
+#include <cstddef>
 
 namespace fro
 {
@@ -25,14 +28,91 @@ namespace fro
 
 	struct Vertex final
 	{
-		static VkVertexInputBindingDescription getBindingDescription();
-		static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
-
-		glm::vec2 position;
+		glm::vec3 position;
 		glm::vec3 color;
 		glm::vec2 texCoord;
 	};
 
+	template<>
+	struct VertexLayout<Vertex> final
+	{
+		static std::array constexpr aAttributes
+		{
+			describeVertexAttribute<decltype(Vertex::position)>(offsetof(Vertex, position)),
+			describeVertexAttribute<decltype(Vertex::color)>(offsetof(Vertex, color)),
+			describeVertexAttribute<decltype(Vertex::texCoord)>(offsetof(Vertex, texCoord))
+		};
+	};
+
+	// what Vertex gets uploaded as; half float positions keep about three significant digits, which suits
+	// model space coordinates, colors get 8 bits and texture coordinates in [0, 1] 16 bits per channel.
+	// Every format here has mandatory vertex buffer support, which three component 16 bit ones lack, so
+	// positions carry a w of 1
+	struct QuantizedVertex final
+	{
+		QuantizedVertex() = default;
+		explicit QuantizedVertex(Vertex const& vertex);
+
+		HalfVector<4> position;
+		NormalizedVector<4, std::uint8_t> color;
+		NormalizedVector<2, std::uint16_t> texCoord;
+	};
+
+	static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex has unexpected padding!");
+
+	template<>
+	struct VertexLayout<QuantizedVertex> final
+	{
+		static std::array constexpr aAttributes
+		{
+			describeVertexAttribute<decltype(QuantizedVertex::position)>(offsetof(QuantizedVertex, position)),
+			describeVertexAttribute<decltype(QuantizedVertex::color)>(offsetof(QuantizedVertex, color)),
+			describeVertexAttribute<decltype(QuantizedVertex::texCoord)>(offsetof(QuantizedVertex, texCoord))
+		};
+	};
+
+	// a range of a mesh's indices drawing it at some level of detail, and how far, in model space units, that
+	// level's surface strays from the full detail one
+	struct MeshLod final
+	{
+		std::uint32_t firstIndex;
+		std::uint32_t indexCount;
+		float error;
+	};
+
+	// an indexed triangle list; levels of detail all index the same vertices and are stored back to back in
+	// vIndices, the full detail one first
+	struct Mesh final
+	{
+		std::vector<Vertex> vVertices{};
+		std::vector<std::uint32_t> vIndices{};
+		std::vector<MeshLod> vLods{};
+	};
+
+	// indices as they get uploaded, 16 bit whenever every vertex is reachable with them
+	struct PackedIndices final
+	{
+		VkIndexType type;
+		std::uint32_t count;
+		std::vector<std::byte> vBytes;
+	};
+
+	// how a graphics pipeline tests and writes its depth attachment
+	struct DepthState final
+	{
+		VkFormat format;
+		VkCompareOp compareOp;
+		VkBool32 isWriteEnabled;
+	};
+
+	// the fixed function state materials differ in besides their depth state; blending is straight alpha blending
+	struct MaterialState final
+	{
+		VkCullModeFlags cullMode;
+		VkFrontFace frontFace;
+		VkBool32 isBlendEnabled;
+	};
+
 	struct UniformBufferObject final
 	{
 		glm::mat4 modelMatrix;
@@ -0,0 +1,132 @@
+#include "Ktx2Texture.h"
+
+#include "FormatSupport.h"
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+	std::array<std::uint8_t, 12> constexpr g_aKtx2Identifier{ 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+	std::uint32_t constexpr g_NoSupercompression{ 0 };
+
+	// copy regions must start on a texel block boundary, 16 bytes covers every block-compressed format
+	std::size_t constexpr g_LevelAlignment{ 16 };
+
+	struct Ktx2Header final
+	{
+		std::array<std::uint8_t, 12> aIdentifier;
+		std::uint32_t vkFormat;
+		std::uint32_t typeSize;
+		std::uint32_t pixelWidth;
+		std::uint32_t pixelHeight;
+		std::uint32_t pixelDepth;
+		std::uint32_t layerCount;
+		std::uint32_t faceCount;
+		std::uint32_t levelCount;
+		std::uint32_t supercompressionScheme;
+		std::uint32_t dfdByteOffset;
+		std::uint32_t dfdByteLength;
+		std::uint32_t kvdByteOffset;
+		std::uint32_t kvdByteLength;
+		std::uint64_t sgdByteOffset;
+		std::uint64_t sgdByteLength;
+	};
+	static_assert(sizeof(Ktx2Header) == 80, "Ktx2Header must match the on-disk KTX2 header layout!");
+
+	struct Ktx2LevelIndex final
+	{
+		std::uint64_t byteOffset;
+		std::uint64_t byteLength;
+		std::uint64_t uncompressedByteLength;
+	};
+
+	Ktx2Header readKtx2Header(std::ifstream& file, std::string_view const filePath)
+	{
+		Ktx2Header header;
+		if (not file.read(reinterpret_cast<char*>(&header), sizeof(header)) or header.aIdentifier != g_aKtx2Identifier)
+			throw std::runtime_error(std::format("{} is not a KTX2 file!", filePath));
+
+		return header;
+	}
+
+	bool isDirectlyUploadable(Ktx2Header const& header)
+	{
+		// BasisLZ/UASTC payloads declare VK_FORMAT_UNDEFINED and have to be transcoded first,
+		// Zstandard/ZLIB supercompressed ones have to be inflated first
+		return
+			header.vkFormat != VK_FORMAT_UNDEFINED and
+			header.supercompressionScheme == g_NoSupercompression;
+	}
+}
+
+fro::Ktx2Texture fro::readKtx2Texture(std::string_view const filePath)
+{
+	std::ifstream file{ std::string(filePath), std::ifstream::binary };
+	if (not file.is_open())
+		throw std::runtime_error(std::format("couldn't open {}!", filePath));
+
+	Ktx2Header const header{ readKtx2Header(file, filePath) };
+
+	if (not isDirectlyUploadable(header))
+		throw std::runtime_error(std::format("{} needs transcoding or inflating before upload!", filePath));
+
+	if (header.pixelHeight == 0 or header.pixelDepth > 1 or header.layerCount > 1 or header.faceCount != 1)
+		throw std::runtime_error(std::format("{} is not a single 2D texture!", filePath));
+
+	std::vector<Ktx2LevelIndex> vLevelIndices(std::max(header.levelCount, 1u));
+	if (not file.read(reinterpret_cast<char*>(vLevelIndices.data()), static_cast<std::streamsize>(vLevelIndices.size() * sizeof(Ktx2LevelIndex))))
+		throw std::runtime_error(std::format("{} has a truncated level index!", filePath));
+
+	Ktx2Texture texture{ .format{ static_cast<VkFormat>(header.vkFormat) } };
+
+	std::size_t totalSize{};
+	for (std::uint32_t level{}; level < vLevelIndices.size(); ++level)
+	{
+		std::size_t const offset{ (totalSize + g_LevelAlignment - 1) / g_LevelAlignment * g_LevelAlignment };
+		std::size_t const size{ static_cast<std::size_t>(vLevelIndices[level].byteLength) };
+
+		texture.vLevels.push_back({ std::max(header.pixelWidth >> level, 1u), std::max(header.pixelHeight >> level, 1u), offset, size });
+		texture.vLevelFileOffsets.push_back(vLevelIndices[level].byteOffset);
+		totalSize = offset + size;
+	}
+
+	return texture;
+}
+
+void fro::readKtx2Levels(std::string_view const filePath, Ktx2Texture const& texture, std::uint8_t* const pDestination)
+{
+	std::ifstream file{ std::string(filePath), std::ifstream::binary };
+	if (not file.is_open())
+		throw std::runtime_error(std::format("couldn't open {}!", filePath));
+
+	for (std::size_t level{}; level < texture.vLevels.size(); ++level)
+	{
+		MipLevel const& mipLevel{ texture.vLevels[level] };
+
+		file.seekg(static_cast<std::streamoff>(texture.vLevelFileOffsets[level]));
+		if (not file.read(reinterpret_cast<char*>(pDestination + mipLevel.offset), static_cast<std::streamsize>(mipLevel.size)))
+			throw std::runtime_error(std::format("{} has a truncated level {}!", filePath, level));
+	}
+}
+
+std::optional<std::string_view> fro::findSupportedKtx2Texture(std::vector<std::string_view> const& vFilePaths, VkPhysicalDevice const physicalDevice)
+{
+	for (std::string_view const filePath : vFilePaths)
+	{
+		if (not std::filesystem::exists(filePath))
+			continue;
+
+		std::ifstream file{ std::string(filePath), std::ifstream::binary };
+		Ktx2Header const header{ readKtx2Header(file, filePath) };
+
+		if (isDirectlyUploadable(header) and isSampledFormatSupported(static_cast<VkFormat>(header.vkFormat), physicalDevice))
+			return filePath;
+	}
+
+	return std::nullopt;
+}
\ No newline at end of file
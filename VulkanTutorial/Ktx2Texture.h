@@ -0,0 +1,35 @@
+#if not defined fro_KTX2_TEXTURE_H
+#define fro_KTX2_TEXTURE_H
+
+#include "MipChain.h"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace fro
+{
+	// a KTX2 container's layout: its GPU format, where every level lands once packed back to back
+	// and where it lives in the file; levels are copied as-is, so block-compressed data never touches a CPU decoder
+	struct Ktx2Texture final
+	{
+		VkFormat format;
+		std::vector<MipLevel> vLevels;
+		std::vector<std::uint64_t> vLevelFileOffsets;
+	};
+
+	[[nodiscard("read KTX2 texture layout ignored!")]]
+	Ktx2Texture readKtx2Texture(std::string_view const filePath);
+
+	// pDestination must hold vLevels.back().offset + vLevels.back().size bytes
+	void readKtx2Levels(std::string_view const filePath, Ktx2Texture const& texture, std::uint8_t* const pDestination);
+
+	// picks the first existing file whose format the device can sample; payloads that would
+	// need Basis Universal transcoding (BasisLZ/UASTC) are skipped since no transcoder is linked in
+	[[nodiscard("found KTX2 texture ignored!")]]
+	std::optional<std::string_view> findSupportedKtx2Texture(std::vector<std::string_view> const& vFilePaths, VkPhysicalDevice const physicalDevice);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "LayoutCache.h"
+
+#include "HelperFunctions.h"
+#include "Hashing.hpp"
+
+#include <algorithm>
+
+#pragma region Constructors/Destructor
+fro::LayoutCache::LayoutCache(VkDevice const logicalDevice)
+	: m_LogicalDevice{ logicalDevice }
+{
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+VkDescriptorSetLayout fro::LayoutCache::getDescriptorSetLayout(std::vector<VkDescriptorSetLayoutBinding> vBindings)
+{
+	std::sort
+	(
+		vBindings.begin(), vBindings.end(),
+		[](VkDescriptorSetLayoutBinding const& firstBinding, VkDescriptorSetLayoutBinding const& secondBinding)
+		{
+			return firstBinding.binding < secondBinding.binding;
+		}
+	);
+
+	DescriptorSetLayoutKey key{ std::move(vBindings) };
+
+	auto descriptorSetLayoutIterator{ m_umDescriptorSetLayouts.find(key) };
+	if (descriptorSetLayoutIterator == m_umDescriptorSetLayouts.end())
+	{
+		UniquePointer<VkDescriptorSetLayout_T> pDescriptorSetLayout
+		{
+			createDescriptorSetLayout(m_LogicalDevice, key.vBindings),
+			std::bind(vkDestroyDescriptorSetLayout, m_LogicalDevice, std::placeholders::_1, nullptr)
+		};
+
+		descriptorSetLayoutIterator = m_umDescriptorSetLayouts.emplace(std::move(key), std::move(pDescriptorSetLayout)).first;
+	}
+
+	return descriptorSetLayoutIterator->second.get();
+}
+
+std::vector<VkDescriptorSetLayout> fro::LayoutCache::getDescriptorSetLayouts(ShaderReflection const& shaderReflection)
+{
+	std::vector<VkDescriptorSetLayout> vDescriptorSetLayouts{};
+	for (std::vector<VkDescriptorSetLayoutBinding> const& vBindings : shaderReflection.vvDescriptorSetLayoutBindings)
+		vDescriptorSetLayouts.push_back(getDescriptorSetLayout(vBindings));
+
+	return vDescriptorSetLayouts;
+}
+
+VkPipelineLayout fro::LayoutCache::getPipelineLayout(std::vector<VkDescriptorSetLayout> const& vDescriptorSetLayouts, std::vector<VkPushConstantRange> vPushConstantRanges)
+{
+	std::sort
+	(
+		vPushConstantRanges.begin(), vPushConstantRanges.end(),
+		[](VkPushConstantRange const& firstRange, VkPushConstantRange const& secondRange)
+		{
+			return firstRange.offset < secondRange.offset or (firstRange.offset == secondRange.offset and firstRange.stageFlags < secondRange.stageFlags);
+		}
+	);
+
+	PipelineLayoutKey key{ vDescriptorSetLayouts, std::move(vPushConstantRanges) };
+
+	auto pipelineLayoutIterator{ m_umPipelineLayouts.find(key) };
+	if (pipelineLayoutIterator == m_umPipelineLayouts.end())
+	{
+		UniquePointer<VkPipelineLayout_T> pPipelineLayout
+		{
+			createPipelineLayout(m_LogicalDevice, key.vDescriptorSetLayouts, key.vPushConstantRanges),
+			std::bind(vkDestroyPipelineLayout, m_LogicalDevice, std::placeholders::_1, nullptr)
+		};
+
+		pipelineLayoutIterator = m_umPipelineLayouts.emplace(std::move(key), std::move(pPipelineLayout)).first;
+	}
+
+	return pipelineLayoutIterator->second.get();
+}
+
+VkPipelineLayout fro::LayoutCache::getPipelineLayout(ShaderReflection const& shaderReflection)
+{
+	return getPipelineLayout(getDescriptorSetLayouts(shaderReflection), shaderReflection.vPushConstantRanges);
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+bool fro::LayoutCache::DescriptorSetLayoutKey::operator==(DescriptorSetLayoutKey const& other) const
+{
+	return std::equal
+	(
+		vBindings.begin(), vBindings.end(),
+		other.vBindings.begin(), other.vBindings.end(),
+		[](VkDescriptorSetLayoutBinding const& binding, VkDescriptorSetLayoutBinding const& otherBinding)
+		{
+			return
+				binding.binding == otherBinding.binding and
+				binding.descriptorType == otherBinding.descriptorType and
+				binding.descriptorCount == otherBinding.descriptorCount and
+				binding.stageFlags == otherBinding.stageFlags and
+				binding.pImmutableSamplers == otherBinding.pImmutableSamplers;
+		}
+	);
+}
+
+bool fro::LayoutCache::PipelineLayoutKey::operator==(PipelineLayoutKey const& other) const
+{
+	return
+		vDescriptorSetLayouts == other.vDescriptorSetLayouts and
+		std::equal
+		(
+			vPushConstantRanges.begin(), vPushConstantRanges.end(),
+			other.vPushConstantRanges.begin(), other.vPushConstantRanges.end(),
+			[](VkPushConstantRange const& range, VkPushConstantRange const& otherRange)
+			{
+				return
+					range.stageFlags == otherRange.stageFlags and
+					range.offset == otherRange.offset and
+					range.size == otherRange.size;
+			}
+		);
+}
+
+std::size_t fro::LayoutCache::KeyHasher::operator()(DescriptorSetLayoutKey const& key) const
+{
+	std::size_t seed{ key.vBindings.size() };
+	for (VkDescriptorSetLayoutBinding const& binding : key.vBindings)
+	{
+		hashCombine(seed, binding.binding);
+		hashCombine(seed, binding.descriptorType);
+		hashCombine(seed, binding.descriptorCount);
+		hashCombine(seed, binding.stageFlags);
+		hashCombine(seed, binding.pImmutableSamplers);
+	}
+
+	return seed;
+}
+
+std::size_t fro::LayoutCache::KeyHasher::operator()(PipelineLayoutKey const& key) const
+{
+	std::size_t seed{ key.vDescriptorSetLayouts.size() };
+	for (VkDescriptorSetLayout const descriptorSetLayout : key.vDescriptorSetLayouts)
+		hashCombine(seed, descriptorSetLayout);
+
+	for (VkPushConstantRange const& pushConstantRange : key.vPushConstantRanges)
+	{
+		hashCombine(seed, pushConstantRange.stageFlags);
+		hashCombine(seed, pushConstantRange.offset);
+		hashCombine(seed, pushConstantRange.size);
+	}
+
+	return seed;
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
@@ -0,0 +1,70 @@
+#if not defined fro_LAYOUT_CACHE_H
+#define fro_LAYOUT_CACHE_H
+
+#include "ShaderReflection.h"
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace fro
+{
+	// owns every descriptor set layout and pipeline layout created through it, and hands out the
+	// same handle for identical binding and push constant descriptions
+	class LayoutCache final
+	{
+	public:
+		LayoutCache(VkDevice const logicalDevice);
+
+		~LayoutCache() = default;
+
+		[[nodiscard("cached descriptor set layout ignored!")]]
+		VkDescriptorSetLayout getDescriptorSetLayout(std::vector<VkDescriptorSetLayoutBinding> vBindings);
+
+		[[nodiscard("cached descriptor set layouts ignored!")]]
+		std::vector<VkDescriptorSetLayout> getDescriptorSetLayouts(ShaderReflection const& shaderReflection);
+
+		[[nodiscard("cached pipeline layout ignored!")]]
+		VkPipelineLayout getPipelineLayout(std::vector<VkDescriptorSetLayout> const& vDescriptorSetLayouts, std::vector<VkPushConstantRange> vPushConstantRanges);
+
+		[[nodiscard("cached pipeline layout ignored!")]]
+		VkPipelineLayout getPipelineLayout(ShaderReflection const& shaderReflection);
+
+	private:
+		struct DescriptorSetLayoutKey final
+		{
+			std::vector<VkDescriptorSetLayoutBinding> vBindings;
+
+			bool operator==(DescriptorSetLayoutKey const& other) const;
+		};
+
+		struct PipelineLayoutKey final
+		{
+			std::vector<VkDescriptorSetLayout> vDescriptorSetLayouts;
+			std::vector<VkPushConstantRange> vPushConstantRanges;
+
+			bool operator==(PipelineLayoutKey const& other) const;
+		};
+
+		struct KeyHasher final
+		{
+			std::size_t operator()(DescriptorSetLayoutKey const& key) const;
+			std::size_t operator()(PipelineLayoutKey const& key) const;
+		};
+
+		LayoutCache(LayoutCache const&) = delete;
+		LayoutCache(LayoutCache&&) noexcept = delete;
+
+		LayoutCache& operator=(LayoutCache const&) = delete;
+		LayoutCache& operator=(LayoutCache&&) noexcept = delete;
+
+		VkDevice const m_LogicalDevice;
+
+		std::unordered_map<DescriptorSetLayoutKey, UniquePointer<VkDescriptorSetLayout_T>, KeyHasher> m_umDescriptorSetLayouts{};
+		std::unordered_map<PipelineLayoutKey, UniquePointer<VkPipelineLayout_T>, KeyHasher> m_umPipelineLayouts{};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "MappedFile.h"
+
+#include <format>
+#include <stdexcept>
+#include <string>
+
+#if defined _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#pragma region Constructors/Destructor
+#if defined _WIN32
+fro::MappedFile::MappedFile(std::string_view const filePath)
+	: m_FileHandle{ CreateFileA(std::string(filePath).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) }
+	, m_MappingHandle{}
+	, m_pData{}
+	, m_Size{}
+{
+	if (m_FileHandle == INVALID_HANDLE_VALUE)
+		throw std::runtime_error(std::format("CreateFileA() failed for {}!", filePath));
+
+	LARGE_INTEGER fileSize;
+	if (not GetFileSizeEx(m_FileHandle, &fileSize))
+	{
+		CloseHandle(m_FileHandle);
+		throw std::runtime_error(std::format("GetFileSizeEx() failed for {}!", filePath));
+	}
+
+	m_Size = static_cast<std::size_t>(fileSize.QuadPart);
+	if (m_Size == 0)
+		return;
+
+	m_MappingHandle = CreateFileMappingA(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (not m_MappingHandle)
+	{
+		CloseHandle(m_FileHandle);
+		throw std::runtime_error(std::format("CreateFileMappingA() failed for {}!", filePath));
+	}
+
+	m_pData = static_cast<std::uint8_t const*>(MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (not m_pData)
+	{
+		CloseHandle(m_MappingHandle);
+		CloseHandle(m_FileHandle);
+		throw std::runtime_error(std::format("MapViewOfFile() failed for {}!", filePath));
+	}
+}
+
+fro::MappedFile::~MappedFile()
+{
+	if (m_pData)
+		UnmapViewOfFile(m_pData);
+
+	if (m_MappingHandle)
+		CloseHandle(m_MappingHandle);
+
+	CloseHandle(m_FileHandle);
+}
+#else
+fro::MappedFile::MappedFile(std::string_view const filePath)
+	: m_FileDescriptor{ open(std::string(filePath).c_str(), O_RDONLY) }
+	, m_pData{}
+	, m_Size{}
+{
+	if (m_FileDescriptor == -1)
+		throw std::runtime_error(std::format("open() failed for {}!", filePath));
+
+	struct stat fileStatus;
+	if (fstat(m_FileDescriptor, &fileStatus) == -1)
+	{
+		close(m_FileDescriptor);
+		throw std::runtime_error(std::format("fstat() failed for {}!", filePath));
+	}
+
+	m_Size = static_cast<std::size_t>(fileStatus.st_size);
+	if (m_Size == 0)
+		return;
+
+	void* const pData{ mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_FileDescriptor, 0) };
+	if (pData == MAP_FAILED)
+	{
+		close(m_FileDescriptor);
+		throw std::runtime_error(std::format("mmap() failed for {}!", filePath));
+	}
+
+	m_pData = static_cast<std::uint8_t const*>(pData);
+}
+
+fro::MappedFile::~MappedFile()
+{
+	if (m_pData)
+		munmap(const_cast<std::uint8_t*>(m_pData), m_Size);
+
+	close(m_FileDescriptor);
+}
+#endif
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+std::span<std::uint8_t const> fro::MappedFile::getBytes() const
+{
+	return { m_pData, m_Size };
+}
+#pragma endregion PublicMethods
\ No newline at end of file
@@ -0,0 +1,40 @@
+#if not defined fro_MAPPED_FILE_H
+#define fro_MAPPED_FILE_H
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace fro
+{
+	// a read-only view of a whole file through the OS page cache; pages are faulted in on first touch,
+	// so nothing is read until the bytes are actually copied somewhere
+	class MappedFile final
+	{
+	public:
+		MappedFile(std::string_view const filePath);
+
+		~MappedFile();
+
+		[[nodiscard("mapped bytes ignored!")]]
+		std::span<std::uint8_t const> getBytes() const;
+
+	private:
+		MappedFile(MappedFile const&) = delete;
+		MappedFile(MappedFile&&) noexcept = delete;
+
+		MappedFile& operator=(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile&&) noexcept = delete;
+
+#if defined _WIN32
+		void* m_FileHandle;
+		void* m_MappingHandle;
+#else
+		int m_FileDescriptor;
+#endif
+		std::uint8_t const* m_pData;
+		std::size_t m_Size;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,408 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+namespace fro
+{
+	namespace
+	{
+		static_assert(sizeof(Vertex) == 8 * sizeof(float), "Vertex has padding, which can't be hashed bitwise!");
+
+		struct VertexHasher final
+		{
+			std::size_t operator()(Vertex const& vertex) const
+			{
+				return std::hash<std::string_view>{}({ reinterpret_cast<char const*>(&vertex), sizeof(vertex) });
+			}
+		};
+
+		struct VertexEqual final
+		{
+			bool operator()(Vertex const& first, Vertex const& second) const
+			{
+				return std::memcmp(&first, &second, sizeof(Vertex)) == 0;
+			}
+		};
+
+		// FIFO post-transform cache, where a vertex is cached when fewer than cacheSize misses happened since its own
+		class VertexCacheSimulation final
+		{
+		public:
+			VertexCacheSimulation(std::size_t const vertexCount, std::uint32_t const cacheSize):
+				m_CacheSize{ cacheSize },
+				m_vTimestamps(vertexCount),
+				m_Timestamp{ cacheSize + 1 }
+			{
+			}
+
+			std::uint32_t processTriangle(std::uint32_t const* const pTriangle)
+			{
+				std::uint32_t misses{};
+				for (std::uint32_t corner{}; corner < 3; ++corner)
+					if (not isCached(pTriangle[corner]))
+					{
+						m_vTimestamps[pTriangle[corner]] = m_Timestamp++;
+						++misses;
+					}
+
+				return misses;
+			}
+
+			bool isCached(std::uint32_t const vertex) const
+			{
+				return m_Timestamp - m_vTimestamps[vertex] <= m_CacheSize;
+			}
+
+			void flush()
+			{
+				m_Timestamp += m_CacheSize + 1;
+			}
+
+		private:
+			std::uint32_t const m_CacheSize;
+			std::vector<std::uint64_t> m_vTimestamps;
+			std::uint64_t m_Timestamp;
+		};
+
+		// vertex to triangle adjacency, with the triangles around vertex v at [vOffsets[v], vOffsets[v + 1])
+		struct TriangleAdjacency final
+		{
+			std::vector<std::uint32_t> vOffsets;
+			std::vector<std::uint32_t> vTriangles;
+		};
+
+		TriangleAdjacency buildTriangleAdjacency(std::vector<std::uint32_t> const& vIndices, std::size_t const vertexCount)
+		{
+			TriangleAdjacency adjacency{ std::vector<std::uint32_t>(vertexCount + 1), std::vector<std::uint32_t>(vIndices.size()) };
+			for (std::uint32_t const index : vIndices)
+				++adjacency.vOffsets[index + 1];
+
+			std::partial_sum(adjacency.vOffsets.begin(), adjacency.vOffsets.end(), adjacency.vOffsets.begin());
+
+			std::vector<std::uint32_t> vCursors(adjacency.vOffsets.begin(), adjacency.vOffsets.end() - 1);
+			for (std::size_t index{}; index < vIndices.size(); ++index)
+				adjacency.vTriangles[vCursors[vIndices[index]]++] = static_cast<std::uint32_t>(index / 3);
+
+			return adjacency;
+		}
+
+		// starts of runs of triangles that only share vertices with each other as far as the cache is concerned;
+		// a hard boundary is where a triangle misses on all its vertices, a soft one is where cutting a hard cluster
+		// costs no more than threshold times its cache miss ratio
+		std::vector<std::size_t> findClusterStarts(std::vector<std::uint32_t> const& vIndices, std::size_t const vertexCount, float const threshold)
+		{
+			std::size_t const triangleCount{ vIndices.size() / 3 };
+
+			std::vector<std::size_t> vHardStarts{};
+			VertexCacheSimulation cache{ vertexCount, g_VertexCacheSize };
+			for (std::size_t triangle{}; triangle < triangleCount; ++triangle)
+				if (cache.processTriangle(&vIndices[triangle * 3]) == 3)
+					vHardStarts.push_back(triangle);
+
+			vHardStarts.push_back(triangleCount);
+
+			std::vector<std::size_t> vClusterStarts{};
+			for (std::size_t hardCluster{}; hardCluster + 1 < vHardStarts.size(); ++hardCluster)
+			{
+				std::size_t const start{ vHardStarts[hardCluster] };
+				std::size_t const end{ vHardStarts[hardCluster + 1] };
+
+				cache.flush();
+				std::size_t clusterMisses{};
+				for (std::size_t triangle{ start }; triangle < end; ++triangle)
+					clusterMisses += cache.processTriangle(&vIndices[triangle * 3]);
+
+				float const clusterAcmr{ static_cast<float>(clusterMisses) / static_cast<float>(end - start) };
+
+				cache.flush();
+				vClusterStarts.push_back(start);
+				std::size_t softStart{ start };
+				std::size_t softMisses{};
+				for (std::size_t triangle{ start }; triangle + 1 < end; ++triangle)
+				{
+					softMisses += cache.processTriangle(&vIndices[triangle * 3]);
+					if (static_cast<float>(softMisses) / static_cast<float>(triangle + 1 - softStart) <= clusterAcmr * threshold)
+					{
+						cache.flush();
+						softStart = triangle + 1;
+						softMisses = 0;
+						vClusterStarts.push_back(softStart);
+					}
+				}
+			}
+
+			return vClusterStarts;
+		}
+	}
+}
+
+void fro::deduplicateVertices(Mesh& mesh)
+{
+	std::unordered_map<Vertex, std::uint32_t, VertexHasher, VertexEqual> umVertexIndices{};
+	umVertexIndices.reserve(mesh.vVertices.size());
+
+	std::vector<Vertex> vUniqueVertices{};
+	for (std::uint32_t& index : mesh.vIndices)
+	{
+		auto const [iterator, isInserted]{ umVertexIndices.try_emplace(mesh.vVertices[index], static_cast<std::uint32_t>(vUniqueVertices.size())) };
+		if (isInserted)
+			vUniqueVertices.push_back(mesh.vVertices[index]);
+
+		index = iterator->second;
+	}
+
+	mesh.vVertices = std::move(vUniqueVertices);
+}
+
+void fro::optimizeVertexCache(std::vector<std::uint32_t>& vIndices, std::size_t const vertexCount)
+{
+	TriangleAdjacency const adjacency{ buildTriangleAdjacency(vIndices, vertexCount) };
+
+	// triangles around each vertex that still have to be emitted
+	std::vector<std::uint32_t> vLiveTriangleCounts(vertexCount);
+	for (std::size_t vertex{}; vertex < vertexCount; ++vertex)
+		vLiveTriangleCounts[vertex] = adjacency.vOffsets[vertex + 1] - adjacency.vOffsets[vertex];
+
+	std::vector<bool> vIsTriangleEmitted(vIndices.size() / 3);
+	std::vector<std::uint64_t> vCacheTimestamps(vertexCount);
+	std::uint64_t timestamp{ g_VertexCacheSize + 1 };
+
+	std::vector<std::uint32_t> vDeadEndStack{};
+	std::vector<std::uint32_t> vCandidates{};
+	std::vector<std::uint32_t> vOptimizedIndices{};
+	vOptimizedIndices.reserve(vIndices.size());
+
+	std::size_t cursor{};
+	auto const findUnfinishedVertex
+	{
+		[&]() -> std::optional<std::uint32_t>
+		{
+			while (not vDeadEndStack.empty())
+			{
+				std::uint32_t const vertex{ vDeadEndStack.back() };
+				vDeadEndStack.pop_back();
+				if (vLiveTriangleCounts[vertex] > 0)
+					return vertex;
+			}
+
+			for (; cursor < vertexCount; ++cursor)
+				if (vLiveTriangleCounts[cursor] > 0)
+					return static_cast<std::uint32_t>(cursor);
+
+			return std::nullopt;
+		}
+	};
+
+	for (std::optional<std::uint32_t> fanningVertex{ findUnfinishedVertex() }; fanningVertex.has_value();)
+	{
+		vCandidates.clear();
+		for (std::uint32_t adjacent{ adjacency.vOffsets[*fanningVertex] }; adjacent < adjacency.vOffsets[*fanningVertex + 1]; ++adjacent)
+		{
+			std::uint32_t const triangle{ adjacency.vTriangles[adjacent] };
+			if (vIsTriangleEmitted[triangle])
+				continue;
+
+			for (std::uint32_t corner{}; corner < 3; ++corner)
+			{
+				std::uint32_t const vertex{ vIndices[triangle * 3 + corner] };
+				vOptimizedIndices.push_back(vertex);
+				vDeadEndStack.push_back(vertex);
+				vCandidates.push_back(vertex);
+				--vLiveTriangleCounts[vertex];
+
+				if (timestamp - vCacheTimestamps[vertex] > g_VertexCacheSize)
+					vCacheTimestamps[vertex] = timestamp++;
+			}
+
+			vIsTriangleEmitted[triangle] = true;
+		}
+
+		// the candidate that has been in the cache longest while its remaining triangles would still fit in
+		// before it falls out, or any other candidate
+		std::optional<std::uint32_t> nextVertex{};
+		std::int64_t bestPriority{ -1 };
+		for (std::uint32_t const vertex : vCandidates)
+		{
+			if (vLiveTriangleCounts[vertex] == 0)
+				continue;
+
+			std::int64_t priority{};
+			if (timestamp - vCacheTimestamps[vertex] + 2 * vLiveTriangleCounts[vertex] <= g_VertexCacheSize)
+				priority = static_cast<std::int64_t>(timestamp - vCacheTimestamps[vertex]);
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				nextVertex = vertex;
+			}
+		}
+
+		fanningVertex = nextVertex.has_value() ? nextVertex : findUnfinishedVertex();
+	}
+
+	vIndices = std::move(vOptimizedIndices);
+}
+
+void fro::optimizeOverdraw(std::vector<std::uint32_t>& vIndices, std::vector<Vertex> const& vVertices, float const threshold)
+{
+	std::size_t const triangleCount{ vIndices.size() / 3 };
+	if (triangleCount == 0)
+		return;
+
+	struct Cluster final
+	{
+		std::size_t start;
+		std::size_t end;
+		float sortKey;
+	};
+
+	std::vector<std::size_t> vClusterStarts{ findClusterStarts(vIndices, vVertices.size(), threshold) };
+	vClusterStarts.push_back(triangleCount);
+
+	// area weighted, like the cluster centroids and normals below
+	glm::dvec3 meshCentroid{};
+	double meshArea{};
+	std::vector<Cluster> vClusters{};
+	std::vector<glm::dvec3> vClusterCentroids{};
+	std::vector<glm::dvec3> vClusterNormals{};
+	for (std::size_t cluster{}; cluster + 1 < vClusterStarts.size(); ++cluster)
+	{
+		glm::dvec3 centroid{};
+		glm::dvec3 normal{};
+		double area{};
+		for (std::size_t triangle{ vClusterStarts[cluster] }; triangle < vClusterStarts[cluster + 1]; ++triangle)
+		{
+			glm::dvec3 const a{ vVertices[vIndices[triangle * 3]].position };
+			glm::dvec3 const b{ vVertices[vIndices[triangle * 3 + 1]].position };
+			glm::dvec3 const c{ vVertices[vIndices[triangle * 3 + 2]].position };
+
+			glm::dvec3 const triangleNormal{ glm::cross(b - a, c - a) };
+			double const triangleArea{ glm::length(triangleNormal) };
+
+			centroid += (a + b + c) / 3.0 * triangleArea;
+			normal += triangleNormal;
+			area += triangleArea;
+		}
+
+		meshCentroid += centroid;
+		meshArea += area;
+
+		vClusters.push_back({ vClusterStarts[cluster], vClusterStarts[cluster + 1], 0.0f });
+		vClusterCentroids.push_back(area > 0.0 ? centroid / area : centroid);
+		vClusterNormals.push_back(glm::length(normal) > 0.0 ? glm::normalize(normal) : normal);
+	}
+
+	if (meshArea > 0.0)
+		meshCentroid /= meshArea;
+
+	for (std::size_t cluster{}; cluster < vClusters.size(); ++cluster)
+		vClusters[cluster].sortKey = static_cast<float>(glm::dot(vClusterCentroids[cluster] - meshCentroid, vClusterNormals[cluster]));
+
+	std::stable_sort(vClusters.begin(), vClusters.end(),
+		[](Cluster const& first, Cluster const& second)
+		{
+			return first.sortKey > second.sortKey;
+		});
+
+	std::vector<std::uint32_t> vSortedIndices{};
+	vSortedIndices.reserve(vIndices.size());
+	for (Cluster const& cluster : vClusters)
+		vSortedIndices.insert(vSortedIndices.end(), vIndices.begin() + cluster.start * 3, vIndices.begin() + cluster.end * 3);
+
+	vIndices = std::move(vSortedIndices);
+}
+
+void fro::optimizeVertexFetch(Mesh& mesh)
+{
+	std::uint32_t constexpr unassigned{ std::numeric_limits<std::uint32_t>::max() };
+
+	std::vector<std::uint32_t> vRemap(mesh.vVertices.size(), unassigned);
+	std::vector<Vertex> vOrderedVertices{};
+	vOrderedVertices.reserve(mesh.vVertices.size());
+
+	for (std::uint32_t& index : mesh.vIndices)
+	{
+		if (vRemap[index] == unassigned)
+		{
+			vRemap[index] = static_cast<std::uint32_t>(vOrderedVertices.size());
+			vOrderedVertices.push_back(mesh.vVertices[index]);
+		}
+
+		index = vRemap[index];
+	}
+
+	mesh.vVertices = std::move(vOrderedVertices);
+}
+
+fro::VertexCacheStatistics fro::analyzeVertexCache(std::vector<std::uint32_t> const& vIndices, std::size_t const vertexCount, std::uint32_t const cacheSize)
+{
+	std::size_t const triangleCount{ vIndices.size() / 3 };
+	if (triangleCount == 0)
+		return {};
+
+	VertexCacheSimulation cache{ vertexCount, cacheSize };
+	std::size_t misses{};
+	for (std::size_t triangle{}; triangle < triangleCount; ++triangle)
+		misses += cache.processTriangle(&vIndices[triangle * 3]);
+
+	std::vector<bool> vIsReferenced(vertexCount);
+	for (std::uint32_t const index : vIndices)
+		vIsReferenced[index] = true;
+
+	return VertexCacheStatistics
+	{
+		.acmr{ static_cast<float>(misses) / static_cast<float>(triangleCount) },
+		.atvr{ static_cast<float>(misses) / static_cast<float>(std::count(vIsReferenced.begin(), vIsReferenced.end(), true)) }
+	};
+}
+
+fro::MeshOptimizationReport fro::optimizeMesh(Mesh& mesh)
+{
+	auto const startTime{ std::chrono::steady_clock::now() };
+
+	MeshOptimizationReport report{ .inputVertexCount{ mesh.vVertices.size() } };
+
+	deduplicateVertices(mesh);
+	report.before = analyzeVertexCache(mesh.vIndices, mesh.vVertices.size());
+
+	optimizeVertexCache(mesh.vIndices, mesh.vVertices.size());
+	optimizeOverdraw(mesh.vIndices, mesh.vVertices);
+	optimizeVertexFetch(mesh);
+
+	report.vertexCount = mesh.vVertices.size();
+	report.triangleCount = mesh.vIndices.size() / 3;
+	report.after = analyzeVertexCache(mesh.vIndices, mesh.vVertices.size());
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	return report;
+}
+
+fro::PackedIndices fro::packIndices(std::vector<std::uint32_t> const& vIndices, std::size_t const vertexCount)
+{
+	bool const isShort{ vertexCount <= std::numeric_limits<std::uint16_t>::max() + std::size_t{ 1 } };
+
+	PackedIndices packedIndices
+	{
+		.type{ isShort ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32 },
+		.count{ static_cast<std::uint32_t>(vIndices.size()) },
+		.vBytes{ std::vector<std::byte>(vIndices.size() * (isShort ? sizeof(std::uint16_t) : sizeof(std::uint32_t))) }
+	};
+
+	if (isShort)
+		for (std::size_t index{}; index < vIndices.size(); ++index)
+		{
+			std::uint16_t const shortIndex{ static_cast<std::uint16_t>(vIndices[index]) };
+			std::memcpy(packedIndices.vBytes.data() + index * sizeof(shortIndex), &shortIndex, sizeof(shortIndex));
+		}
+	else
+		std::memcpy(packedIndices.vBytes.data(), vIndices.data(), packedIndices.vBytes.size());
+
+	return packedIndices;
+}
\ No newline at end of file
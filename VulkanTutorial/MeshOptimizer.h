@@ -0,0 +1,59 @@
+#if not defined fro_MESH_OPTIMIZER_H
+#define fro_MESH_OPTIMIZER_H
+
+#include "HelperStructs.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace fro
+{
+	// simulated FIFO post-transform cache size; small enough that orders made for it hold up on larger caches
+	std::uint32_t constexpr g_VertexCacheSize{ 16 };
+	// how much worse than its cache optimal order a part of the mesh may get for the sake of less overdraw
+	float constexpr g_OverdrawThreshold{ 1.05f };
+
+	struct VertexCacheStatistics final
+	{
+		// average cache miss ratio, vertex shader invocations per triangle; 0.5 at best for large regular meshes
+		float acmr;
+		// average transformed vertex ratio, vertex shader invocations per referenced vertex; 1 at best
+		float atvr;
+	};
+
+	struct MeshOptimizationReport final
+	{
+		std::size_t inputVertexCount;
+		std::size_t vertexCount;
+		std::size_t triangleCount;
+		VertexCacheStatistics before;
+		VertexCacheStatistics after;
+		double seconds;
+	};
+
+	// merges bitwise identical vertices, keeping the first occurrence of each
+	void deduplicateVertices(Mesh& mesh);
+
+	// Tipsify (Sander et al. 2007): fans around the vertex that stays cached longest, and only jumps elsewhere in
+	// the mesh when every cached vertex is used up
+	void optimizeVertexCache(std::vector<std::uint32_t>& vIndices, std::size_t const vertexCount);
+
+	// keeps the triangle order within clusters of a cache optimized index buffer but sorts those clusters to
+	// draw the ones facing away from the mesh center first, so they occlude more of the rest from any view
+	void optimizeOverdraw(std::vector<std::uint32_t>& vIndices, std::vector<Vertex> const& vVertices, float const threshold = g_OverdrawThreshold);
+
+	// orders vertices by first use, so vertex fetches walk memory linearly, and drops unreferenced ones
+	void optimizeVertexFetch(Mesh& mesh);
+
+	[[nodiscard("vertex cache statistics ignored!")]]
+	VertexCacheStatistics analyzeVertexCache(std::vector<std::uint32_t> const& vIndices, std::size_t const vertexCount, std::uint32_t const cacheSize = g_VertexCacheSize);
+
+	// every step above in order
+	[[nodiscard("mesh optimization report ignored!")]]
+	MeshOptimizationReport optimizeMesh(Mesh& mesh);
+
+	[[nodiscard("packed indices ignored!")]]
+	PackedIndices packIndices(std::vector<std::uint32_t> const& vIndices, std::size_t const vertexCount);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include "MeshSimplifier.h"
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace fro
+{
+	namespace
+	{
+		// levels that keep more than this fraction of the previous one's triangles aren't worth their memory
+		float constexpr g_MinLodReduction{ 0.9f };
+
+		// sum of squared distances to a set of area weighted planes, as the symmetric 4x4 matrix of the plane
+		// equations' outer products
+		struct Quadric final
+		{
+			double a2, ab, ac, ad;
+			double b2, bc, bd;
+			double c2, cd;
+			double d2;
+			double weight;
+
+			static Quadric fromPlane(glm::dvec3 const& normal, double const distance, double const weight)
+			{
+				return Quadric
+				{
+					weight * normal.x * normal.x, weight * normal.x * normal.y, weight * normal.x * normal.z, weight * normal.x * distance,
+					weight * normal.y * normal.y, weight * normal.y * normal.z, weight * normal.y * distance,
+					weight * normal.z * normal.z, weight * normal.z * distance,
+					weight * distance * distance,
+					weight
+				};
+			}
+
+			Quadric& operator+=(Quadric const& other)
+			{
+				a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+				b2 += other.b2; bc += other.bc; bd += other.bd;
+				c2 += other.c2; cd += other.cd;
+				d2 += other.d2;
+				weight += other.weight;
+
+				return *this;
+			}
+
+			// mean squared distance of the point to the planes
+			double evaluate(glm::dvec3 const& point) const
+			{
+				double const error
+				{
+					a2 * point.x * point.x + 2.0 * ab * point.x * point.y + 2.0 * ac * point.x * point.z + 2.0 * ad * point.x +
+					b2 * point.y * point.y + 2.0 * bc * point.y * point.z + 2.0 * bd * point.y +
+					c2 * point.z * point.z + 2.0 * cd * point.z +
+					d2
+				};
+
+				return weight > 0.0 ? std::max(error, 0.0) / weight : 0.0;
+			}
+		};
+
+		struct Collapse final
+		{
+			std::uint32_t from;
+			std::uint32_t to;
+			double error;
+		};
+
+		std::uint64_t getEdgeKey(std::uint32_t const first, std::uint32_t const second)
+		{
+			return static_cast<std::uint64_t>(std::min(first, second)) << 32 | std::max(first, second);
+		}
+
+		// border and non-manifold edges, and vertices that share their position with another vertex, have to
+		// keep their place for the simplified surface to stay closed and unstretched
+		std::vector<bool> findLockedVertices(std::vector<Vertex> const& vVertices, std::vector<std::uint32_t> const& vIndices)
+		{
+			std::vector<bool> vIsLocked(vVertices.size());
+
+			std::unordered_map<std::uint64_t, std::uint32_t> umEdgeTriangleCounts{};
+			umEdgeTriangleCounts.reserve(vIndices.size());
+			for (std::size_t index{}; index < vIndices.size(); index += 3)
+				for (std::size_t corner{}; corner < 3; ++corner)
+					++umEdgeTriangleCounts[getEdgeKey(vIndices[index + corner], vIndices[index + (corner + 1) % 3])];
+
+			for (auto const& [edgeKey, triangleCount] : umEdgeTriangleCounts)
+				if (triangleCount != 2)
+				{
+					vIsLocked[static_cast<std::uint32_t>(edgeKey >> 32)] = true;
+					vIsLocked[static_cast<std::uint32_t>(edgeKey)] = true;
+				}
+
+			std::unordered_map<std::uint64_t, std::uint32_t> umPositionVertices{};
+			umPositionVertices.reserve(vVertices.size());
+			for (std::uint32_t vertex{}; vertex < vVertices.size(); ++vertex)
+			{
+				glm::vec3 const& position{ vVertices[vertex].position };
+				std::size_t positionHash{ std::hash<float>{}(position.x) };
+				positionHash = positionHash * 31 + std::hash<float>{}(position.y);
+				positionHash = positionHash * 31 + std::hash<float>{}(position.z);
+
+				auto const [iterator, isInserted]{ umPositionVertices.try_emplace(positionHash, vertex) };
+				if (not isInserted and vVertices[iterator->second].position == position)
+				{
+					vIsLocked[vertex] = true;
+					vIsLocked[iterator->second] = true;
+				}
+			}
+
+			return vIsLocked;
+		}
+
+		// whether moving from onto to turns any triangle around from that doesn't also contain to
+		bool flipsTriangles(Collapse const& collapse, std::vector<Vertex> const& vVertices, std::vector<std::uint32_t> const& vIndices,
+			std::vector<std::uint32_t> const& vAdjacencyOffsets, std::vector<std::uint32_t> const& vAdjacency)
+		{
+			for (std::uint32_t adjacent{ vAdjacencyOffsets[collapse.from] }; adjacent < vAdjacencyOffsets[collapse.from + 1]; ++adjacent)
+			{
+				std::uint32_t const* const pTriangle{ &vIndices[vAdjacency[adjacent] * 3] };
+				if (std::find(pTriangle, pTriangle + 3, collapse.to) != pTriangle + 3)
+					continue;
+
+				std::array<glm::vec3, 3> aBefore{};
+				std::array<glm::vec3, 3> aAfter{};
+				for (std::size_t corner{}; corner < 3; ++corner)
+				{
+					aBefore[corner] = vVertices[pTriangle[corner]].position;
+					aAfter[corner] = pTriangle[corner] == collapse.from ? vVertices[collapse.to].position : aBefore[corner];
+				}
+
+				glm::vec3 const normalBefore{ glm::cross(aBefore[1] - aBefore[0], aBefore[2] - aBefore[0]) };
+				glm::vec3 const normalAfter{ glm::cross(aAfter[1] - aAfter[0], aAfter[2] - aAfter[0]) };
+				if (glm::dot(normalBefore, normalAfter) <= 0.0f)
+					return true;
+			}
+
+			return false;
+		}
+	}
+}
+
+fro::SimplifiedIndices fro::simplifyMesh(std::vector<Vertex> const& vVertices, std::vector<std::uint32_t> const& vIndices, std::size_t const targetIndexCount)
+{
+	std::vector<bool> const vIsLocked{ findLockedVertices(vVertices, vIndices) };
+
+	std::vector<Quadric> vQuadrics(vVertices.size());
+	for (std::size_t index{}; index < vIndices.size(); index += 3)
+	{
+		glm::dvec3 const a{ vVertices[vIndices[index]].position };
+		glm::dvec3 const b{ vVertices[vIndices[index + 1]].position };
+		glm::dvec3 const c{ vVertices[vIndices[index + 2]].position };
+
+		glm::dvec3 const normal{ glm::cross(b - a, c - a) };
+		double const area{ glm::length(normal) / 2.0 };
+		if (area == 0.0)
+			continue;
+
+		Quadric const quadric{ Quadric::fromPlane(normal / (2.0 * area), -glm::dot(normal / (2.0 * area), a), area) };
+		for (std::size_t corner{}; corner < 3; ++corner)
+			vQuadrics[vIndices[index + corner]] += quadric;
+	}
+
+	SimplifiedIndices simplifiedIndices{ vIndices, 0.0f };
+	std::vector<std::uint32_t>& vSimplifiedIndices{ simplifiedIndices.vIndices };
+	double maxError{};
+
+	std::vector<Collapse> vCollapses{};
+	std::vector<std::uint32_t> vAdjacencyOffsets(vVertices.size() + 1);
+	std::vector<std::uint32_t> vAdjacency{};
+	std::vector<bool> vIsTouched(vVertices.size());
+	std::vector<std::uint32_t> vRemap(vVertices.size());
+
+	// each pass applies the cheapest collapses that don't touch each other's neighbourhoods
+	while (vSimplifiedIndices.size() > targetIndexCount)
+	{
+		vCollapses.clear();
+		for (std::size_t index{}; index < vSimplifiedIndices.size(); index += 3)
+			for (std::size_t corner{}; corner < 3; ++corner)
+			{
+				std::uint32_t const first{ vSimplifiedIndices[index + corner] };
+				std::uint32_t const second{ vSimplifiedIndices[index + (corner + 1) % 3] };
+
+				// interior edges show up once in each direction, so this visits each of them once
+				if (first > second or (vIsLocked[first] and vIsLocked[second]))
+					continue;
+
+				Quadric quadric{ vQuadrics[first] };
+				quadric += vQuadrics[second];
+
+				double const firstOntoSecond{ vIsLocked[first] ? INFINITY : quadric.evaluate(vVertices[second].position) };
+				double const secondOntoFirst{ vIsLocked[second] ? INFINITY : quadric.evaluate(vVertices[first].position) };
+
+				vCollapses.push_back(firstOntoSecond <= secondOntoFirst ?
+					Collapse{ first, second, firstOntoSecond } :
+					Collapse{ second, first, secondOntoFirst });
+			}
+
+		std::sort(vCollapses.begin(), vCollapses.end(),
+			[](Collapse const& first, Collapse const& second)
+			{
+				return first.error < second.error;
+			});
+
+		std::fill(vAdjacencyOffsets.begin(), vAdjacencyOffsets.end(), 0);
+		for (std::uint32_t const index : vSimplifiedIndices)
+			++vAdjacencyOffsets[index + 1];
+
+		for (std::size_t vertex{}; vertex < vVertices.size(); ++vertex)
+			vAdjacencyOffsets[vertex + 1] += vAdjacencyOffsets[vertex];
+
+		vAdjacency.resize(vSimplifiedIndices.size());
+		std::vector<std::uint32_t> vCursors(vAdjacencyOffsets.begin(), vAdjacencyOffsets.end() - 1);
+		for (std::size_t index{}; index < vSimplifiedIndices.size(); ++index)
+			vAdjacency[vCursors[vSimplifiedIndices[index]]++] = static_cast<std::uint32_t>(index / 3);
+
+		std::fill(vIsTouched.begin(), vIsTouched.end(), false);
+		for (std::uint32_t vertex{}; vertex < vRemap.size(); ++vertex)
+			vRemap[vertex] = vertex;
+
+		std::size_t removedIndexCount{};
+		std::size_t collapseCount{};
+		for (Collapse const& collapse : vCollapses)
+		{
+			if (vSimplifiedIndices.size() - removedIndexCount <= targetIndexCount)
+				break;
+
+			if (vIsTouched[collapse.from] or vIsTouched[collapse.to] or
+				flipsTriangles(collapse, vVertices, vSimplifiedIndices, vAdjacencyOffsets, vAdjacency))
+				continue;
+
+			vRemap[collapse.from] = collapse.to;
+			vQuadrics[collapse.to] += vQuadrics[collapse.from];
+			maxError = std::max(maxError, collapse.error);
+			++collapseCount;
+
+			for (std::uint32_t adjacent{ vAdjacencyOffsets[collapse.from] }; adjacent < vAdjacencyOffsets[collapse.from + 1]; ++adjacent)
+			{
+				std::uint32_t const* const pTriangle{ &vSimplifiedIndices[vAdjacency[adjacent] * 3] };
+				for (std::size_t corner{}; corner < 3; ++corner)
+					vIsTouched[pTriangle[corner]] = true;
+
+				if (std::find(pTriangle, pTriangle + 3, collapse.to) != pTriangle + 3)
+					removedIndexCount += 3;
+			}
+		}
+
+		if (collapseCount == 0)
+			break;
+
+		std::size_t keptIndexCount{};
+		for (std::size_t index{}; index < vSimplifiedIndices.size(); index += 3)
+		{
+			std::uint32_t const a{ vRemap[vSimplifiedIndices[index]] };
+			std::uint32_t const b{ vRemap[vSimplifiedIndices[index + 1]] };
+			std::uint32_t const c{ vRemap[vSimplifiedIndices[index + 2]] };
+			if (a == b or b == c or c == a)
+				continue;
+
+			vSimplifiedIndices[keptIndexCount++] = a;
+			vSimplifiedIndices[keptIndexCount++] = b;
+			vSimplifiedIndices[keptIndexCount++] = c;
+		}
+
+		vSimplifiedIndices.resize(keptIndexCount);
+	}
+
+	simplifiedIndices.error = static_cast<float>(std::sqrt(maxError));
+	return simplifiedIndices;
+}
+
+void fro::generateLods(Mesh& mesh)
+{
+	mesh.vLods = { { 0, static_cast<std::uint32_t>(mesh.vIndices.size()), 0.0f } };
+
+	std::vector<std::uint32_t> vPreviousIndices{ mesh.vIndices };
+	float error{};
+	while (mesh.vLods.size() < g_MaxLodCount)
+	{
+		std::size_t const targetIndexCount{ static_cast<std::size_t>(static_cast<float>(vPreviousIndices.size() / 3) * g_LodTriangleRatio) * 3 };
+		if (targetIndexCount / 3 < g_MinLodTriangleCount)
+			break;
+
+		SimplifiedIndices simplifiedIndices{ simplifyMesh(mesh.vVertices, vPreviousIndices, targetIndexCount) };
+		if (static_cast<float>(simplifiedIndices.vIndices.size()) > static_cast<float>(vPreviousIndices.size()) * g_MinLodReduction)
+			break;
+
+		optimizeVertexCache(simplifiedIndices.vIndices, mesh.vVertices.size());
+
+		// every level is simplified from the previous one, so their errors add up
+		error += simplifiedIndices.error;
+		mesh.vLods.push_back({ static_cast<std::uint32_t>(mesh.vIndices.size()), static_cast<std::uint32_t>(simplifiedIndices.vIndices.size()), error });
+		mesh.vIndices.insert(mesh.vIndices.end(), simplifiedIndices.vIndices.begin(), simplifiedIndices.vIndices.end());
+
+		vPreviousIndices = std::move(simplifiedIndices.vIndices);
+	}
+}
+
+std::size_t fro::selectLod(std::vector<MeshLod> const& vLods, float const pixelsPerUnit, float const maxErrorPixels)
+{
+	std::size_t lod{};
+	while (lod + 1 < vLods.size() and vLods[lod + 1].error * pixelsPerUnit <= maxErrorPixels)
+		++lod;
+
+	return lod;
+}
\ No newline at end of file
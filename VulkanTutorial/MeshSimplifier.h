@@ -0,0 +1,39 @@
+#if not defined fro_MESH_SIMPLIFIER_H
+#define fro_MESH_SIMPLIFIER_H
+
+#include "HelperStructs.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace fro
+{
+	// each level of detail aims for this fraction of the previous one's triangles
+	float constexpr g_LodTriangleRatio{ 0.5f };
+	std::size_t constexpr g_MaxLodCount{ 8 };
+	std::size_t constexpr g_MinLodTriangleCount{ 64 };
+
+	struct SimplifiedIndices final
+	{
+		std::vector<std::uint32_t> vIndices;
+		// root mean square distance of the moved vertices to their original surface, in model space units
+		float error;
+	};
+
+	// Garland-Heckbert quadric error simplification restricted to half-edge collapses, so the result indexes
+	// the same vertices. Vertices on borders and seams (sharing their position with another vertex) stay put,
+	// and collapses that would flip a triangle are skipped, so the target is not always reached
+	[[nodiscard("simplified indices ignored!")]]
+	SimplifiedIndices simplifyMesh(std::vector<Vertex> const& vVertices, std::vector<std::uint32_t> const& vIndices, std::size_t const targetIndexCount);
+
+	// replaces the mesh's levels of detail with its full index buffer followed by successively simplified,
+	// cache optimized versions of it, until simplification stops paying off
+	void generateLods(Mesh& mesh);
+
+	// the coarsest level whose error stays within maxErrorPixels, given how many pixels a model space unit
+	// covers at the mesh's distance
+	[[nodiscard("selected level of detail ignored!")]]
+	std::size_t selectLod(std::vector<MeshLod> const& vLods, float const pixelsPerUnit, float const maxErrorPixels);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace fro
+{
+	namespace
+	{
+		// clusters whose normals spread further than this from their average never get cone culled
+		float constexpr g_MinimumConeNormalDot{ 0.1f };
+
+		void computeBounds(Mesh const& mesh, Meshlet& meshlet)
+		{
+			glm::vec3 minimum{ std::numeric_limits<float>::max() };
+			glm::vec3 maximum{ std::numeric_limits<float>::lowest() };
+			for (std::uint32_t index{ meshlet.firstIndex }; index < meshlet.firstIndex + meshlet.indexCount; ++index)
+			{
+				minimum = glm::min(minimum, mesh.vVertices[mesh.vIndices[index]].position);
+				maximum = glm::max(maximum, mesh.vVertices[mesh.vIndices[index]].position);
+			}
+
+			meshlet.center = (minimum + maximum) / 2.0f;
+			meshlet.radius = 0.0f;
+			for (std::uint32_t index{ meshlet.firstIndex }; index < meshlet.firstIndex + meshlet.indexCount; ++index)
+				meshlet.radius = std::max(meshlet.radius, glm::length(mesh.vVertices[mesh.vIndices[index]].position - meshlet.center));
+
+			std::vector<glm::vec3> vNormals{};
+			std::vector<glm::vec3> vCorners{};
+			glm::vec3 normalSum{};
+			for (std::uint32_t index{ meshlet.firstIndex }; index < meshlet.firstIndex + meshlet.indexCount; index += 3)
+			{
+				glm::vec3 const a{ mesh.vVertices[mesh.vIndices[index]].position };
+				glm::vec3 const b{ mesh.vVertices[mesh.vIndices[index + 1]].position };
+				glm::vec3 const c{ mesh.vVertices[mesh.vIndices[index + 2]].position };
+
+				glm::vec3 const normal{ glm::cross(b - a, c - a) };
+				float const length{ glm::length(normal) };
+				if (length == 0.0f)
+					continue;
+
+				vNormals.push_back(normal / length);
+				vCorners.push_back(a);
+				normalSum += normal / length;
+			}
+
+			meshlet.coneApex = meshlet.center;
+			meshlet.coneAxis = {};
+			meshlet.coneCutoff = 1.0f;
+
+			float const normalSumLength{ glm::length(normalSum) };
+			if (normalSumLength == 0.0f)
+				return;
+
+			glm::vec3 const axis{ normalSum / normalSumLength };
+
+			float minimumDot{ 1.0f };
+			for (glm::vec3 const& normal : vNormals)
+				minimumDot = std::min(minimumDot, glm::dot(normal, axis));
+
+			if (minimumDot <= g_MinimumConeNormalDot)
+				return;
+
+			// the apex sits far enough back along the axis that every triangle's plane faces away from anything
+			// the cone test accepts
+			float maximumDistance{};
+			for (std::size_t triangle{}; triangle < vNormals.size(); ++triangle)
+				maximumDistance = std::max(maximumDistance, glm::dot(meshlet.center - vCorners[triangle], vNormals[triangle]) / glm::dot(axis, vNormals[triangle]));
+
+			meshlet.coneApex = meshlet.center - axis * maximumDistance;
+			meshlet.coneAxis = axis;
+			meshlet.coneCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+		}
+	}
+}
+
+std::vector<fro::Meshlet> fro::buildMeshlets(Mesh const& mesh, MeshLod const& lod)
+{
+	std::uint32_t constexpr unseen{ std::numeric_limits<std::uint32_t>::max() };
+
+	// the meshlet each vertex was last counted in
+	std::vector<std::uint32_t> vVertexMeshlets(mesh.vVertices.size(), unseen);
+	std::vector<Meshlet> vMeshlets{};
+
+	Meshlet meshlet{ .firstIndex{ lod.firstIndex } };
+	for (std::uint32_t index{ lod.firstIndex }; index + 2 < lod.firstIndex + lod.indexCount; index += 3)
+	{
+		std::uint32_t const* const pTriangle{ &mesh.vIndices[index] };
+		auto const isNewVertex
+		{
+			[&](std::uint32_t const corner)
+			{
+				return
+					vVertexMeshlets[pTriangle[corner]] != vMeshlets.size() and
+					std::find(pTriangle, pTriangle + corner, pTriangle[corner]) == pTriangle + corner;
+			}
+		};
+
+		std::uint32_t const newVertexCount{ static_cast<std::uint32_t>(isNewVertex(0)) + isNewVertex(1) + isNewVertex(2) };
+		if (meshlet.indexCount / 3 == g_MaxMeshletTriangles or meshlet.vertexCount + newVertexCount > g_MaxMeshletVertices)
+		{
+			computeBounds(mesh, meshlet);
+			vMeshlets.push_back(meshlet);
+			meshlet = { .firstIndex{ index } };
+		}
+
+		for (std::uint32_t corner{}; corner < 3; ++corner)
+			if (vVertexMeshlets[pTriangle[corner]] != vMeshlets.size())
+			{
+				vVertexMeshlets[pTriangle[corner]] = static_cast<std::uint32_t>(vMeshlets.size());
+				++meshlet.vertexCount;
+			}
+
+		meshlet.indexCount += 3;
+	}
+
+	if (meshlet.indexCount > 0)
+	{
+		computeBounds(mesh, meshlet);
+		vMeshlets.push_back(meshlet);
+	}
+
+	return vMeshlets;
+}
\ No newline at end of file
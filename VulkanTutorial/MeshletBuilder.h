@@ -0,0 +1,43 @@
+#if not defined fro_MESHLET_BUILDER_H
+#define fro_MESHLET_BUILDER_H
+
+#include "HelperStructs.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace fro
+{
+	// what mesh shading hardware handles best, and 124 triangles leave room for a 4 byte count in 128
+	std::uint32_t constexpr g_MaxMeshletVertices{ 64 };
+	std::uint32_t constexpr g_MaxMeshletTriangles{ 124 };
+
+	// std430 layout of a meshletCull.comp meshlet; a run of the mesh's index buffer with its bounds
+	struct Meshlet final
+	{
+		glm::vec3 center;
+		float radius;
+		// every triangle faces away from a viewer for whom the direction from the apex, dotted with the axis,
+		// reaches the cutoff; a zero axis with a cutoff of 1 for clusters too curved to ever be culled this way
+		glm::vec3 coneApex;
+		float coneCutoff;
+		glm::vec3 coneAxis;
+		std::uint32_t firstIndex;
+		std::uint32_t indexCount;
+		std::uint32_t vertexCount;
+		std::array<std::uint32_t, 2> aPadding;
+	};
+
+	static_assert(sizeof(Meshlet) == 64, "Meshlet doesn't match its std430 layout!");
+
+	// cuts the level of detail's run of the index buffer into consecutive runs of at most g_MaxMeshletVertices
+	// distinct vertices and g_MaxMeshletTriangles triangles; spatially coherent as long as the indices went
+	// through optimizeVertexCache()
+	[[nodiscard("built meshlets ignored!")]]
+	std::vector<Meshlet> buildMeshlets(Mesh const& mesh, MeshLod const& lod);
+}
+
+#endif
\ No newline at end of file
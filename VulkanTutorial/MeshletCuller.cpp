@@ -0,0 +1,265 @@
+#include "MeshletCuller.h"
+
+#include "BarrierBuilder.h"
+#include "HelperFunctions.h"
+#include "ShaderVariants.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+	std::uint32_t constexpr g_CullWorkgroupSize{ 64 };
+
+	std::uint32_t getMaxDrawIndirectCount(VkPhysicalDevice const physicalDevice)
+	{
+		VkPhysicalDeviceFeatures features;
+		vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+
+		if (not features.multiDrawIndirect)
+			return 1;
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+		return properties.limits.maxDrawIndirectCount;
+	}
+
+	struct PushConstants final
+	{
+		std::uint32_t firstMeshlet;
+		std::uint32_t meshletCount;
+		std::uint32_t firstIndex;
+		std::int32_t vertexOffset;
+	};
+}
+
+#pragma region Constructors/Destructor
+fro::MeshletCuller::MeshletCuller(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, VkCommandPool const commandPool, VkQueue const graphicsQueue,
+	LayoutCache& layoutCache, std::vector<std::vector<Meshlet>> const& vvLodMeshlets, std::vector<VkBuffer> const& vUniformBuffers):
+	m_LogicalDevice{ logicalDevice },
+	m_PhysicalDevice{ physicalDevice },
+	m_vLodRanges{ getLodRanges(vvLodMeshlets) },
+	m_MaxMeshletCount
+	{
+		std::max_element(m_vLodRanges.begin(), m_vLodRanges.end(),
+			[](LodRange const& first, LodRange const& second)
+			{
+				return first.meshletCount < second.meshletCount;
+			})->meshletCount
+	},
+	m_MaxDrawIndirectCount{ getMaxDrawIndirectCount(physicalDevice) },
+	m_vShaderBytecode{ ShaderVariants{ "Shaders", "meshletCull.comp", shaderc_shader_kind::shaderc_compute_shader }.getBytecode({}) },
+	m_ShaderReflection{ reflectShader(m_vShaderBytecode, VK_SHADER_STAGE_COMPUTE_BIT) },
+	m_vDescriptorSetLayouts{ layoutCache.getDescriptorSetLayouts(m_ShaderReflection) },
+	m_PipelineLayout{ layoutCache.getPipelineLayout(m_vDescriptorSetLayouts, m_ShaderReflection.vPushConstantRanges) },
+	m_pPipeline{ createComputePipeline(logicalDevice, m_PipelineLayout, m_vShaderBytecode), std::bind(vkDestroyPipeline, logicalDevice, std::placeholders::_1, nullptr) },
+	m_pDescriptorPool
+	{
+		createDescriptorPool(m_ShaderReflection.vvDescriptorSetLayoutBindings.at(0), static_cast<std::uint32_t>(vUniformBuffers.size()), logicalDevice),
+		std::bind(vkDestroyDescriptorPool, logicalDevice, std::placeholders::_1, nullptr)
+	}
+{
+	createMeshletBuffer(vvLodMeshlets, commandPool, graphicsQueue);
+	createFrameBuffers(static_cast<std::uint32_t>(vUniformBuffers.size()));
+	createDescriptorSets(vUniformBuffers);
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+void fro::MeshletCuller::update(std::uint32_t const frameIndex)
+{
+	std::uint32_t const* const pStatistics{ m_vStatisticsBuffers[frameIndex].pMappedData };
+	m_Lod = m_vFrameLods[frameIndex];
+	m_VisibleMeshlets = pStatistics[0];
+	m_VisibleTriangles = pStatistics[1];
+}
+
+void fro::MeshletCuller::recordCulling(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex, std::size_t const lod, GeometryAllocation const& meshAllocation)
+{
+	m_vFrameLods[frameIndex] = lod;
+	LodRange const& lodRange{ m_vLodRanges[lod] };
+	PushConstants const pushConstants{ lodRange.firstMeshlet, lodRange.meshletCount, meshAllocation.firstIndex, meshAllocation.vertexOffset };
+
+	vkCmdFillBuffer(commandBuffer, m_vStatisticsBuffers[frameIndex].pBuffer.first.get(), 0, VK_WHOLE_SIZE, 0);
+
+	BarrierBuilder barrierBuilder{};
+	barrierBuilder
+		.addBufferBarrier(m_vStatisticsBuffers[frameIndex].pBuffer.first.get(), ResourceUsage::TransferWrite, ResourceUsage::ComputeStorageWrite)
+		.flush(commandBuffer);
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pPipeline.get());
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &m_vDescriptorSets[frameIndex], 0, nullptr);
+	vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+	vkCmdDispatch(commandBuffer, (lodRange.meshletCount + g_CullWorkgroupSize - 1) / g_CullWorkgroupSize, 1, 1);
+}
+
+void fro::MeshletCuller::recordDraws(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex) const
+{
+	std::uint32_t const meshletCount{ m_vLodRanges[m_vFrameLods[frameIndex]].meshletCount };
+	for (std::uint32_t firstMeshlet{}; firstMeshlet < meshletCount; firstMeshlet += m_MaxDrawIndirectCount)
+		vkCmdDrawIndexedIndirect(commandBuffer, m_vpDrawCommandBuffers[frameIndex].first.get(), firstMeshlet * sizeof(VkDrawIndexedIndirectCommand),
+			std::min(m_MaxDrawIndirectCount, meshletCount - firstMeshlet), sizeof(VkDrawIndexedIndirectCommand));
+}
+
+VkBuffer fro::MeshletCuller::getDrawCommandBuffer(std::uint32_t const frameIndex) const
+{
+	return m_vpDrawCommandBuffers[frameIndex].first.get();
+}
+
+VkBuffer fro::MeshletCuller::getStatisticsBuffer(std::uint32_t const frameIndex) const
+{
+	return m_vStatisticsBuffers[frameIndex].pBuffer.first.get();
+}
+
+fro::MeshletCullerStatistics fro::MeshletCuller::getStatistics() const
+{
+	return MeshletCullerStatistics
+	{
+		.lod{ m_Lod },
+		.meshletCount{ m_vLodRanges[m_Lod].meshletCount },
+		.triangleCount{ m_vLodRanges[m_Lod].triangleCount },
+		.visibleMeshlets{ m_VisibleMeshlets },
+		.visibleTriangles{ m_VisibleTriangles }
+	};
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+std::vector<fro::MeshletCuller::LodRange> fro::MeshletCuller::getLodRanges(std::vector<std::vector<Meshlet>> const& vvLodMeshlets)
+{
+	std::vector<LodRange> vLodRanges{};
+
+	std::uint32_t firstMeshlet{};
+	for (std::vector<Meshlet> const& vMeshlets : vvLodMeshlets)
+	{
+		vLodRanges.push_back(
+			{
+				.firstMeshlet{ firstMeshlet },
+				.meshletCount{ static_cast<std::uint32_t>(vMeshlets.size()) },
+				.triangleCount
+				{
+					std::accumulate(vMeshlets.begin(), vMeshlets.end(), std::size_t{},
+						[](std::size_t const triangleCount, Meshlet const& meshlet)
+						{
+							return triangleCount + meshlet.indexCount / 3;
+						})
+				}
+			});
+
+		firstMeshlet += static_cast<std::uint32_t>(vMeshlets.size());
+	}
+
+	return vLodRanges;
+}
+
+void fro::MeshletCuller::createMeshletBuffer(std::vector<std::vector<Meshlet>> const& vvLodMeshlets, VkCommandPool const commandPool, VkQueue const graphicsQueue)
+{
+	std::vector<Meshlet> vMeshlets{};
+	for (std::vector<Meshlet> const& vLodMeshlets : vvLodMeshlets)
+		vMeshlets.insert(vMeshlets.end(), vLodMeshlets.begin(), vLodMeshlets.end());
+
+	VkDeviceSize const bufferSize{ std::max(sizeof(Meshlet) * vMeshlets.size(), sizeof(Meshlet)) };
+
+	auto pStagingBuffer
+	{
+		createBuffer(m_LogicalDevice, m_PhysicalDevice,
+			bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+	};
+
+	void* pData;
+	if (vkMapMemory(m_LogicalDevice, pStagingBuffer.second.get(), 0, bufferSize, 0, &pData) != VK_SUCCESS)
+		throw std::runtime_error("vkMapMemory() failed!");
+
+	std::memcpy(pData, vMeshlets.data(), sizeof(Meshlet) * vMeshlets.size());
+	vkUnmapMemory(m_LogicalDevice, pStagingBuffer.second.get());
+
+	m_pMeshletBuffer = createBuffer(m_LogicalDevice, m_PhysicalDevice,
+		bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	copyBuffer(pStagingBuffer.first.get(), m_pMeshletBuffer.first.get(), bufferSize, commandPool, m_LogicalDevice, graphicsQueue);
+}
+
+void fro::MeshletCuller::createFrameBuffers(std::uint32_t const framesInFlight)
+{
+	VkDeviceSize const drawCommandsSize{ std::max(sizeof(VkDrawIndexedIndirectCommand) * m_MaxMeshletCount, sizeof(VkDrawIndexedIndirectCommand)) };
+	VkDeviceSize constexpr statisticsSize{ 2 * sizeof(std::uint32_t) };
+
+	m_vFrameLods.resize(framesInFlight);
+	for (std::uint32_t index{}; index < framesInFlight; ++index)
+	{
+		m_vpDrawCommandBuffers.push_back(createBuffer(m_LogicalDevice, m_PhysicalDevice,
+			drawCommandsSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+
+		StatisticsBuffer statisticsBuffer
+		{
+			.pBuffer
+			{
+				createBuffer(m_LogicalDevice, m_PhysicalDevice,
+					statisticsSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+					VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+			}
+		};
+
+		void* pData;
+		if (vkMapMemory(m_LogicalDevice, statisticsBuffer.pBuffer.second.get(), 0, statisticsSize, 0, &pData) != VK_SUCCESS)
+			throw std::runtime_error("vkMapMemory() failed!");
+
+		statisticsBuffer.pMappedData = static_cast<std::uint32_t*>(pData);
+		std::memset(pData, 0, static_cast<std::size_t>(statisticsSize));
+
+		m_vStatisticsBuffers.push_back(std::move(statisticsBuffer));
+	}
+}
+
+void fro::MeshletCuller::createDescriptorSets(std::vector<VkBuffer> const& vUniformBuffers)
+{
+	std::vector<VkDescriptorSetLayout> const vLayouts(vUniformBuffers.size(), m_vDescriptorSetLayouts.at(0));
+	VkDescriptorSetAllocateInfo const allocationInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO },
+		.descriptorPool{ m_pDescriptorPool.get() },
+		.descriptorSetCount{ static_cast<std::uint32_t>(vLayouts.size()) },
+		.pSetLayouts{ vLayouts.data() }
+	};
+
+	m_vDescriptorSets.resize(vLayouts.size());
+	if (vkAllocateDescriptorSets(m_LogicalDevice, &allocationInfo, m_vDescriptorSets.data()) != VK_SUCCESS)
+		throw std::runtime_error("vkAllocateDescriptorSets() failed!");
+
+	for (std::size_t index{}; index < m_vDescriptorSets.size(); ++index)
+	{
+		std::array<VkDescriptorBufferInfo, 4> const aBufferInfos
+		{
+			VkDescriptorBufferInfo{ vUniformBuffers[index], 0, sizeof(UniformBufferObject) },
+			VkDescriptorBufferInfo{ m_pMeshletBuffer.first.get(), 0, VK_WHOLE_SIZE },
+			VkDescriptorBufferInfo{ m_vpDrawCommandBuffers[index].first.get(), 0, VK_WHOLE_SIZE },
+			VkDescriptorBufferInfo{ m_vStatisticsBuffers[index].pBuffer.first.get(), 0, VK_WHOLE_SIZE }
+		};
+
+		std::array<VkWriteDescriptorSet, 4> aDescriptorWrites{};
+		for (std::uint32_t binding{}; binding < aDescriptorWrites.size(); ++binding)
+			aDescriptorWrites[binding] =
+			{
+				.sType{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET },
+				.dstSet{ m_vDescriptorSets[index] },
+				.dstBinding{ binding },
+				.descriptorCount{ 1 },
+				.descriptorType{ binding == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER },
+				.pBufferInfo{ &aBufferInfos[binding] }
+			};
+
+		vkUpdateDescriptorSets(m_LogicalDevice, static_cast<std::uint32_t>(aDescriptorWrites.size()), aDescriptorWrites.data(), 0, nullptr);
+	}
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
@@ -0,0 +1,113 @@
+#if not defined fro_MESHLET_CULLER_H
+#define fro_MESHLET_CULLER_H
+
+#include "GeometryBuffer.h"
+#include "LayoutCache.h"
+#include "MeshletBuilder.h"
+#include "ShaderReflection.h"
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace fro
+{
+	struct MeshletCullerStatistics final
+	{
+		std::size_t lod;
+		std::size_t meshletCount;
+		std::size_t triangleCount;
+		std::size_t visibleMeshlets;
+		std::size_t visibleTriangles;
+	};
+
+	// a compute pre-pass that tests every meshlet of a level of detail's bounding sphere against the view frustum
+	// and its normal cone against the camera, and writes one indexed indirect draw per meshlet with no instances
+	// for the culled ones; invisible clusters then never reach the vertex shader
+	class MeshletCuller final
+	{
+	public:
+		// vvLodMeshlets holds each of the mesh's levels of detail's meshlets, vUniformBuffers the per frame
+		// UniformBufferObject buffers the vertex shader reads, one per frame in flight
+		MeshletCuller(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, VkCommandPool const commandPool, VkQueue const graphicsQueue,
+			LayoutCache& layoutCache, std::vector<std::vector<Meshlet>> const& vvLodMeshlets, std::vector<VkBuffer> const& vUniformBuffers);
+
+		~MeshletCuller() = default;
+
+		// reads back what frameIndex's last cull let through; call after the frame's fence wait
+		void update(std::uint32_t const frameIndex);
+
+		// outside a render pass, before recordDraws() for the same level of detail; meshAllocation is where the
+		// mesh the meshlets were built from sits in the geometry buffer. Writes the draw command buffer, which the
+		// draws read as indirect commands, and the statistics buffer, which update() reads on the host
+		void recordCulling(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex, std::size_t const lod, GeometryAllocation const& meshAllocation);
+
+		// inside a render pass, with the geometry buffer's vertex and index buffers bound
+		void recordDraws(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex) const;
+
+		[[nodiscard("draw command buffer ignored!")]]
+		VkBuffer getDrawCommandBuffer(std::uint32_t const frameIndex) const;
+
+		[[nodiscard("statistics buffer ignored!")]]
+		VkBuffer getStatisticsBuffer(std::uint32_t const frameIndex) const;
+
+		[[nodiscard("meshlet culler statistics ignored!")]]
+		MeshletCullerStatistics getStatistics() const;
+
+	private:
+		struct StatisticsBuffer final
+		{
+			std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>> pBuffer;
+			std::uint32_t* pMappedData;
+		};
+
+		MeshletCuller(MeshletCuller const&) = delete;
+		MeshletCuller(MeshletCuller&&) noexcept = delete;
+
+		MeshletCuller& operator=(MeshletCuller const&) = delete;
+		MeshletCuller& operator=(MeshletCuller&&) noexcept = delete;
+
+		struct LodRange final
+		{
+			std::uint32_t firstMeshlet;
+			std::uint32_t meshletCount;
+			std::size_t triangleCount;
+		};
+
+		[[nodiscard("level of detail ranges ignored!")]]
+		static std::vector<LodRange> getLodRanges(std::vector<std::vector<Meshlet>> const& vvLodMeshlets);
+
+		void createMeshletBuffer(std::vector<std::vector<Meshlet>> const& vvLodMeshlets, VkCommandPool const commandPool, VkQueue const graphicsQueue);
+		void createFrameBuffers(std::uint32_t const framesInFlight);
+		void createDescriptorSets(std::vector<VkBuffer> const& vUniformBuffers);
+
+		VkDevice const m_LogicalDevice;
+		VkPhysicalDevice const m_PhysicalDevice;
+		// where each level of detail's meshlets start in the meshlet buffer
+		std::vector<LodRange> const m_vLodRanges;
+		std::uint32_t const m_MaxMeshletCount;
+		// 1 unless multiDrawIndirect is supported, and with it enabled
+		std::uint32_t const m_MaxDrawIndirectCount;
+		std::vector<std::uint32_t> const m_vShaderBytecode;
+		ShaderReflection const m_ShaderReflection;
+		std::vector<VkDescriptorSetLayout> const m_vDescriptorSetLayouts;
+		VkPipelineLayout const m_PipelineLayout;
+		UniquePointer<VkPipeline_T> const m_pPipeline;
+		UniquePointer<VkDescriptorPool_T> const m_pDescriptorPool;
+
+		std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>> m_pMeshletBuffer{};
+		std::vector<std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>>> m_vpDrawCommandBuffers{};
+		std::vector<StatisticsBuffer> m_vStatisticsBuffers{};
+		std::vector<VkDescriptorSet> m_vDescriptorSets{};
+		// the level of detail each frame's commands were last culled for
+		std::vector<std::size_t> m_vFrameLods{};
+
+		std::size_t m_Lod{};
+		std::size_t m_VisibleMeshlets{};
+		std::size_t m_VisibleTriangles{};
+	};
+}
+
+#endif
\ No newline at end of file
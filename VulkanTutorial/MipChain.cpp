@@ -0,0 +1,162 @@
+#include "MipChain.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#if defined _M_X64 or defined __SSE2__
+#include <emmintrin.h>
+#define fro_MIP_CHAIN_SSE2
+#endif
+
+namespace
+{
+	std::size_t constexpr g_BytesPerPixel{ 4 };
+	// alpha is stored linearly in sRGB formats too
+	std::size_t constexpr g_ColorChannelCount{ 3 };
+
+	// 8-bit sRGB decoded to 16-bit linear, and 16-bit linear encoded back to 8-bit sRGB; 16 bits keep the darkest
+	// sRGB steps apart, which 8 or 12 linear bits wouldn't
+	struct SrgbTables final
+	{
+		std::array<std::uint16_t, 256> aToLinear;
+		std::array<std::uint8_t, 65536> aToSrgb;
+	};
+
+	SrgbTables const& getSrgbTables()
+	{
+		static SrgbTables const srgbTables
+		{
+			[]
+			{
+				SrgbTables tables{};
+
+				for (std::size_t value{}; value < tables.aToLinear.size(); ++value)
+				{
+					double const srgb{ static_cast<double>(value) / 255.0 };
+					double const linear{ srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4) };
+					tables.aToLinear[value] = static_cast<std::uint16_t>(std::lround(linear * 65535.0));
+				}
+
+				for (std::size_t value{}; value < tables.aToSrgb.size(); ++value)
+				{
+					double const linear{ static_cast<double>(value) / 65535.0 };
+					double const srgb{ linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055 };
+					tables.aToSrgb[value] = static_cast<std::uint8_t>(std::lround(srgb * 255.0));
+				}
+
+				return tables;
+			}()
+		};
+
+		return srgbTables;
+	}
+}
+
+void fro::downsampleMipLevel(std::uint8_t const* const pSource, std::uint32_t const sourceWidth, std::uint32_t const sourceHeight,
+	std::uint8_t* const pDestination, std::uint32_t const destinationWidth, std::uint32_t const destinationHeight, bool const isSrgb)
+{
+	SrgbTables const* const pSrgbTables{ isSrgb ? &getSrgbTables() : nullptr };
+
+	for (std::uint32_t y{}; y < destinationHeight; ++y)
+	{
+		std::uint8_t const* const pFirstRow{ pSource + std::min(2 * y, sourceHeight - 1) * sourceWidth * g_BytesPerPixel };
+		std::uint8_t const* const pSecondRow{ pSource + std::min(2 * y + 1, sourceHeight - 1) * sourceWidth * g_BytesPerPixel };
+		std::uint8_t* const pDestinationRow{ pDestination + y * destinationWidth * g_BytesPerPixel };
+
+		std::uint32_t x{};
+
+#if defined fro_MIP_CHAIN_SSE2
+		// sRGB texels have to go through the tables one at a time, which SSE2 has no gather for
+		// two destination pixels per iteration: 4 source pixels from each row are widened to 16 bits,
+		// summed vertically, then the horizontal neighbours are summed by swapping 64-bit halves
+		__m128i const zero{ _mm_setzero_si128() };
+		__m128i const rounding{ _mm_set1_epi16(2) };
+		for (; not isSrgb and x + 2 <= destinationWidth; x += 2)
+		{
+			__m128i const firstRow{ _mm_loadu_si128(reinterpret_cast<__m128i const*>(pFirstRow + 2 * x * g_BytesPerPixel)) };
+			__m128i const secondRow{ _mm_loadu_si128(reinterpret_cast<__m128i const*>(pSecondRow + 2 * x * g_BytesPerPixel)) };
+
+			__m128i const lowSum{ _mm_add_epi16(_mm_unpacklo_epi8(firstRow, zero), _mm_unpacklo_epi8(secondRow, zero)) };
+			__m128i const highSum{ _mm_add_epi16(_mm_unpackhi_epi8(firstRow, zero), _mm_unpackhi_epi8(secondRow, zero)) };
+
+			__m128i const boxSum{ _mm_add_epi16(_mm_unpacklo_epi64(lowSum, highSum), _mm_unpackhi_epi64(lowSum, highSum)) };
+			__m128i const average{ _mm_srli_epi16(_mm_add_epi16(boxSum, rounding), 2) };
+
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(pDestinationRow + x * g_BytesPerPixel), _mm_packus_epi16(average, zero));
+		}
+#endif
+
+		for (; x < destinationWidth; ++x)
+		{
+			std::size_t const firstColumn{ std::min(2 * x, sourceWidth - 1) * g_BytesPerPixel };
+			std::size_t const secondColumn{ std::min(2 * x + 1, sourceWidth - 1) * g_BytesPerPixel };
+
+			for (std::size_t channel{}; channel < g_BytesPerPixel; ++channel)
+			{
+				if (pSrgbTables and channel < g_ColorChannelCount)
+				{
+					std::array<std::uint16_t, 256> const& aToLinear{ pSrgbTables->aToLinear };
+					std::uint32_t const linearSum
+					{
+						static_cast<std::uint32_t>(aToLinear[pFirstRow[firstColumn + channel]]) + aToLinear[pFirstRow[secondColumn + channel]] +
+						aToLinear[pSecondRow[firstColumn + channel]] + aToLinear[pSecondRow[secondColumn + channel]]
+					};
+
+					pDestinationRow[x * g_BytesPerPixel + channel] = pSrgbTables->aToSrgb[(linearSum + 2) / 4];
+					continue;
+				}
+
+				std::uint32_t const boxSum
+				{
+					static_cast<std::uint32_t>(pFirstRow[firstColumn + channel]) + pFirstRow[secondColumn + channel] +
+					pSecondRow[firstColumn + channel] + pSecondRow[secondColumn + channel]
+				};
+
+				pDestinationRow[x * g_BytesPerPixel + channel] = static_cast<std::uint8_t>((boxSum + 2) / 4);
+			}
+		}
+	}
+}
+
+std::uint32_t fro::getMipLevelCount(std::uint32_t const width, std::uint32_t const height)
+{
+	return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+}
+
+fro::MipChain fro::generateMipChain(std::uint8_t const* const pPixels, std::uint32_t const width, std::uint32_t const height, bool const isSrgb)
+{
+	MipChain mipChain{};
+
+	std::size_t totalSize{};
+	std::uint32_t levelWidth{ width };
+	std::uint32_t levelHeight{ height };
+	for (std::uint32_t level{}; level < getMipLevelCount(width, height); ++level)
+	{
+		std::size_t const levelSize{ static_cast<std::size_t>(levelWidth) * levelHeight * g_BytesPerPixel };
+		mipChain.vLevels.push_back({ levelWidth, levelHeight, totalSize, levelSize });
+
+		totalSize += levelSize;
+		levelWidth = std::max(levelWidth / 2, 1u);
+		levelHeight = std::max(levelHeight / 2, 1u);
+	}
+
+	mipChain.vPixels.resize(totalSize);
+	std::memcpy(mipChain.vPixels.data(), pPixels, mipChain.vLevels.front().size);
+
+	for (std::size_t level{ 1 }; level < mipChain.vLevels.size(); ++level)
+	{
+		MipLevel const& sourceLevel{ mipChain.vLevels[level - 1] };
+		MipLevel const& destinationLevel{ mipChain.vLevels[level] };
+
+		downsampleMipLevel
+		(
+			mipChain.vPixels.data() + sourceLevel.offset, sourceLevel.width, sourceLevel.height,
+			mipChain.vPixels.data() + destinationLevel.offset, destinationLevel.width, destinationLevel.height, isSrgb
+		);
+	}
+
+	return mipChain;
+}
\ No newline at end of file
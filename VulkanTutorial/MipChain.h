@@ -0,0 +1,38 @@
+#if not defined fro_MIP_CHAIN_H
+#define fro_MIP_CHAIN_H
+
+#include <cstdint>
+#include <vector>
+
+namespace fro
+{
+	struct MipLevel final
+	{
+		std::uint32_t width;
+		std::uint32_t height;
+		std::size_t offset;
+		std::size_t size;
+	};
+
+	// every level of an image packed back to back, level 0 first
+	struct MipChain final
+	{
+		std::vector<std::uint8_t> vPixels{};
+		std::vector<MipLevel> vLevels{};
+	};
+
+	[[nodiscard("mip level count ignored!")]]
+	std::uint32_t getMipLevelCount(std::uint32_t const width, std::uint32_t const height);
+
+	// filters one level of RGBA8 texels from the one above it with a 2x2 box; a horizontal strip of a level works too,
+	// as long as it starts on an even row. sRGB color channels are averaged in linear space, since averaging the
+	// encoded values darkens every level
+	void downsampleMipLevel(std::uint8_t const* const pSource, std::uint32_t const sourceWidth, std::uint32_t const sourceHeight,
+		std::uint8_t* const pDestination, std::uint32_t const destinationWidth, std::uint32_t const destinationHeight, bool const isSrgb);
+
+	// CPU fallback for formats the device can't linearly blit; filters with a 2x2 box
+	[[nodiscard("generated mip chain ignored!")]]
+	MipChain generateMipChain(std::uint8_t const* const pPixels, std::uint32_t const width, std::uint32_t const height, bool const isSrgb);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "ObjLoader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace fro
+{
+	namespace
+	{
+		std::string_view nextToken(std::string_view& line)
+		{
+			std::size_t const start{ line.find_first_not_of(" \t\r") };
+			if (start == std::string_view::npos)
+			{
+				line = {};
+				return {};
+			}
+
+			line.remove_prefix(start);
+			std::size_t const end{ std::min(line.find_first_of(" \t\r"), line.size()) };
+			std::string_view const token{ line.substr(0, end) };
+			line.remove_prefix(end);
+
+			return token;
+		}
+
+		float parseFloat(std::string_view const token, std::string_view const filePath, std::size_t const lineNumber)
+		{
+			float value{};
+			auto const [pEnd, errorCode]{ std::from_chars(token.data(), token.data() + token.size(), value) };
+			if (token.empty() or errorCode != std::errc{} or pEnd != token.data() + token.size())
+				throw std::runtime_error(std::format("{} has a malformed number on line {}!", filePath, lineNumber));
+
+			return value;
+		}
+
+		// OBJ indices are 1 based, and negative ones count back from the last element defined so far
+		std::size_t resolveIndex(std::string_view const token, std::size_t const elementCount, std::string_view const filePath, std::size_t const lineNumber)
+		{
+			std::int64_t index{};
+			auto const [pEnd, errorCode]{ std::from_chars(token.data(), token.data() + token.size(), index) };
+			if (token.empty() or errorCode != std::errc{} or pEnd != token.data() + token.size())
+				throw std::runtime_error(std::format("{} has a malformed index on line {}!", filePath, lineNumber));
+
+			std::int64_t const resolvedIndex{ index < 0 ? static_cast<std::int64_t>(elementCount) + index : index - 1 };
+			if (resolvedIndex < 0 or resolvedIndex >= static_cast<std::int64_t>(elementCount))
+				throw std::runtime_error(std::format("{} references an undefined element on line {}!", filePath, lineNumber));
+
+			return static_cast<std::size_t>(resolvedIndex);
+		}
+	}
+}
+
+fro::Mesh fro::loadObj(std::string_view const filePath)
+{
+	std::ifstream file{ std::string(filePath), std::ifstream::binary | std::ifstream::ate };
+	if (not file.is_open())
+		throw std::runtime_error(std::format("couldn't open {}!", filePath));
+
+	std::string contents(static_cast<std::size_t>(file.tellg()), '\0');
+	file.seekg(0);
+	if (not file.read(contents.data(), static_cast<std::streamsize>(contents.size())))
+		throw std::runtime_error(std::format("couldn't read {}!", filePath));
+
+	std::vector<glm::vec3> vPositions{};
+	std::vector<glm::vec2> vTexCoords{};
+	std::vector<Vertex> vPolygon{};
+	Mesh mesh{};
+
+	std::string_view remaining{ contents };
+	for (std::size_t lineNumber{ 1 }; not remaining.empty(); ++lineNumber)
+	{
+		std::size_t const lineEnd{ std::min(remaining.find('\n'), remaining.size()) };
+		std::string_view line{ remaining.substr(0, lineEnd) };
+		remaining.remove_prefix(std::min(lineEnd + 1, remaining.size()));
+
+		std::string_view const keyword{ nextToken(line) };
+		if (keyword == "v")
+		{
+			glm::vec3 position;
+			for (glm::length_t component{}; component < position.length(); ++component)
+				position[component] = parseFloat(nextToken(line), filePath, lineNumber);
+
+			vPositions.push_back(position);
+		}
+		else if (keyword == "vt")
+		{
+			float const u{ parseFloat(nextToken(line), filePath, lineNumber) };
+			float const v{ parseFloat(nextToken(line), filePath, lineNumber) };
+
+			vTexCoords.push_back({ u, 1.0f - v });
+		}
+		else if (keyword == "f")
+		{
+			vPolygon.clear();
+			for (std::string_view corner{ nextToken(line) }; not corner.empty(); corner = nextToken(line))
+			{
+				// v, v/vt, v//vn or v/vt/vn
+				std::size_t const firstSlash{ corner.find('/') };
+
+				Vertex vertex
+				{
+					.position{ vPositions[resolveIndex(corner.substr(0, firstSlash), vPositions.size(), filePath, lineNumber)] },
+					.color{ 1.0f, 1.0f, 1.0f },
+					.texCoord{}
+				};
+
+				if (firstSlash != std::string_view::npos)
+				{
+					std::string_view const texCoordIndex{ corner.substr(firstSlash + 1, corner.find('/', firstSlash + 1) - firstSlash - 1) };
+					if (not texCoordIndex.empty())
+						vertex.texCoord = vTexCoords[resolveIndex(texCoordIndex, vTexCoords.size(), filePath, lineNumber)];
+				}
+
+				vPolygon.push_back(vertex);
+			}
+
+			if (vPolygon.size() < 3)
+				throw std::runtime_error(std::format("{} has a face with fewer than 3 corners on line {}!", filePath, lineNumber));
+
+			for (std::size_t corner{ 2 }; corner < vPolygon.size(); ++corner)
+			{
+				mesh.vVertices.push_back(vPolygon[0]);
+				mesh.vVertices.push_back(vPolygon[corner - 1]);
+				mesh.vVertices.push_back(vPolygon[corner]);
+			}
+		}
+	}
+
+	if (mesh.vVertices.size() > std::numeric_limits<std::uint32_t>::max())
+		throw std::runtime_error(std::format("{} has too many faces!", filePath));
+
+	mesh.vIndices.resize(mesh.vVertices.size());
+	std::iota(mesh.vIndices.begin(), mesh.vIndices.end(), 0);
+
+	return mesh;
+}
\ No newline at end of file
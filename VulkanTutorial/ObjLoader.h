@@ -0,0 +1,17 @@
+#if not defined fro_OBJ_LOADER_H
+#define fro_OBJ_LOADER_H
+
+#include "HelperStructs.h"
+
+#include <string_view>
+
+namespace fro
+{
+	// positions and texture coordinates of a Wavefront OBJ file, with polygons fanned into triangles and every
+	// corner its own vertex; deduplicateVertices() turns that into an indexed mesh. Texture coordinates get
+	// flipped to a top left origin, normals and materials are ignored
+	[[nodiscard("loaded mesh ignored!")]]
+	Mesh loadObj(std::string_view const filePath);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,759 @@
+#include "PipelineLibrary.h"
+
+#include "HelperFunctions.h"
+#include "VertexLayout.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+	bool isDepthOnly(fro::GraphicsPipelineDescription const& description)
+	{
+		return description.pFragmentShaderBytecode == nullptr or description.pFragmentShaderBytecode->empty();
+	}
+
+	// the parts of a pipeline that render into a depth only description have no color attachment
+	VkPipelineRenderingCreateInfo getRenderingCreateInfo(fro::GraphicsPipelineDescription const& description)
+	{
+		return
+		{
+			.sType{ VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO },
+			.colorAttachmentCount{ isDepthOnly(description) ? 0u : 1u },
+			.pColorAttachmentFormats{ &description.colorAttachmentFormat },
+			.depthAttachmentFormat{ description.depthState.format }
+		};
+	}
+
+	VkPipelineMultisampleStateCreateInfo getMultisampleStateCreateInfo(fro::GraphicsPipelineDescription const& description)
+	{
+		return
+		{
+			.sType{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO },
+			.rasterizationSamples{ description.sampleCount },
+			.sampleShadingEnable{ VK_FALSE }
+		};
+	}
+
+	VkPipelineDynamicStateCreateInfo getDynamicStateCreateInfo(std::vector<VkDynamicState> const& vDynamicStates)
+	{
+		return
+		{
+			.sType{ VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO },
+			.dynamicStateCount{ static_cast<std::uint32_t>(vDynamicStates.size()) },
+			.pDynamicStates{ vDynamicStates.data() }
+		};
+	}
+}
+
+#pragma region Constructors/Destructor
+fro::PipelineLibrary::PipelineLibrary(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, VkPipelineLayout const pipelineLayout, std::uint32_t const framesInFlight):
+	m_LogicalDevice{ logicalDevice },
+	m_PipelineLayout{ pipelineLayout },
+	m_FramesInFlight{ framesInFlight },
+	m_IsSupported{ isGraphicsPipelineLibrarySupported(physicalDevice) }
+{
+	// extended dynamic state 1 and 2 are core in Vulkan 1.3, only the third one's commands have to be looked up
+	VkPhysicalDeviceExtendedDynamicState3FeaturesEXT const extendedDynamicState3Features{ getExtendedDynamicState3Features(physicalDevice) };
+	if (extendedDynamicState3Features.extendedDynamicState3RasterizationSamples)
+		m_pSetRasterizationSamples = reinterpret_cast<PFN_vkCmdSetRasterizationSamplesEXT>(vkGetDeviceProcAddr(m_LogicalDevice, "vkCmdSetRasterizationSamplesEXT"));
+
+	if (extendedDynamicState3Features.extendedDynamicState3ColorBlendEnable)
+		m_pSetColorBlendEnable = reinterpret_cast<PFN_vkCmdSetColorBlendEnableEXT>(vkGetDeviceProcAddr(m_LogicalDevice, "vkCmdSetColorBlendEnableEXT"));
+
+	if (m_IsSupported)
+	{
+		VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT libraryProperties
+		{
+			.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT }
+		};
+
+		VkPhysicalDeviceProperties2 properties
+		{
+			.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 },
+			.pNext{ &libraryProperties }
+		};
+		vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+		m_IsFastLinkingSupported = libraryProperties.graphicsPipelineLibraryFastLinking;
+	}
+
+	// compiles are heavy enough that a few workers keep up, and leave the cores to the texture loader's workers
+	std::uint32_t const workerCount{ std::max(std::thread::hardware_concurrency() / 4, 1u) };
+	for (std::uint32_t index{}; index < workerCount; ++index)
+		m_vWorkers.emplace_back(std::bind_front(&PipelineLibrary::work, this));
+}
+
+fro::PipelineLibrary::~PipelineLibrary()
+{
+	for (std::jthread& worker : m_vWorkers)
+		worker.request_stop();
+
+	m_vWorkers.clear();
+
+	for (auto& [key, pipeline] : m_mPipelines)
+	{
+		if (not pipeline.isFastLinkedPipelineRetired)
+			vkDestroyPipeline(m_LogicalDevice, pipeline.fastLinkedPipeline.load(), nullptr);
+
+		vkDestroyPipeline(m_LogicalDevice, pipeline.optimizedPipeline.load(), nullptr);
+	}
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+bool fro::isGraphicsPipelineLibrarySupported(VkPhysicalDevice const physicalDevice)
+{
+	if (not isPhysicalDeviceExtensionAvailable(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME, physicalDevice) or
+		not isPhysicalDeviceExtensionAvailable(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME, physicalDevice))
+		return false;
+
+	VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT libraryFeatures
+	{
+		.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT }
+	};
+
+	VkPhysicalDeviceFeatures2 features
+	{
+		.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 },
+		.pNext{ &libraryFeatures }
+	};
+	vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+	return libraryFeatures.graphicsPipelineLibrary;
+}
+
+VkPhysicalDeviceExtendedDynamicState3FeaturesEXT fro::getExtendedDynamicState3Features(VkPhysicalDevice const physicalDevice)
+{
+	VkPhysicalDeviceExtendedDynamicState3FeaturesEXT supportedFeatures
+	{
+		.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT }
+	};
+
+	if (not isPhysicalDeviceExtensionAvailable(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME, physicalDevice))
+		return supportedFeatures;
+
+	VkPhysicalDeviceFeatures2 features
+	{
+		.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 },
+		.pNext{ &supportedFeatures }
+	};
+	vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+	return
+	{
+		.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT },
+		.extendedDynamicState3RasterizationSamples{ supportedFeatures.extendedDynamicState3RasterizationSamples },
+		.extendedDynamicState3ColorBlendEnable{ supportedFeatures.extendedDynamicState3ColorBlendEnable }
+	};
+}
+
+void fro::recordPipelineBind(VkCommandBuffer const commandBuffer, GraphicsPipeline const& pipeline)
+{
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipeline);
+
+	if (not pipeline.isStateDynamic)
+		return;
+
+	vkCmdSetPrimitiveTopology(commandBuffer, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+	vkCmdSetCullMode(commandBuffer, pipeline.materialState.cullMode);
+	vkCmdSetFrontFace(commandBuffer, pipeline.materialState.frontFace);
+	vkCmdSetDepthTestEnable(commandBuffer, VK_TRUE);
+	vkCmdSetDepthWriteEnable(commandBuffer, pipeline.depthState.isWriteEnabled);
+	vkCmdSetDepthCompareOp(commandBuffer, pipeline.depthState.compareOp);
+
+	if (pipeline.pSetRasterizationSamples)
+		pipeline.pSetRasterizationSamples(commandBuffer, pipeline.sampleCount);
+
+	if (pipeline.pSetColorBlendEnable and pipeline.hasColorAttachment)
+		pipeline.pSetColorBlendEnable(commandBuffer, 0, 1, &pipeline.materialState.isBlendEnabled);
+}
+
+void fro::PipelineLibrary::update()
+{
+	{
+		std::lock_guard const lock{ m_Mutex };
+		if (m_pException)
+			std::rethrow_exception(std::exchange(m_pException, nullptr));
+	}
+
+	m_WaitingFrameCount += m_IsFrameWaiting;
+	m_HitchedFrameCount += m_IsFrameHitched;
+	m_IsFrameWaiting = false;
+	m_IsFrameHitched = false;
+	++m_FrameNumber;
+
+	std::erase_if(m_vRetiredPipelines,
+		[this](RetiredPipeline const& retiredPipeline)
+		{
+			return m_FrameNumber - retiredPipeline.retiredFrame > m_FramesInFlight;
+		});
+
+	for (auto& [key, pipeline] : m_mPipelines)
+	{
+		if (pipeline.isFastLinkedPipelineRetired or not pipeline.optimizedPipeline.load(std::memory_order_acquire))
+			continue;
+
+		pipeline.isFastLinkedPipelineRetired = true;
+		if (VkPipeline const fastLinkedPipeline{ pipeline.fastLinkedPipeline.load(std::memory_order_acquire) })
+			m_vRetiredPipelines.push_back({ { fastLinkedPipeline, std::bind(vkDestroyPipeline, m_LogicalDevice, std::placeholders::_1, nullptr) }, m_FrameNumber });
+	}
+}
+
+void fro::PipelineLibrary::markFrameHitched()
+{
+	m_IsFrameHitched = true;
+}
+
+void fro::PipelineLibrary::prepare(GraphicsPipelineDescription const& description)
+{
+	[[maybe_unused]] Pipeline const& pipeline{ findOrQueuePipeline(description) };
+}
+
+std::optional<fro::GraphicsPipeline> fro::PipelineLibrary::getPipeline(GraphicsPipelineDescription const& description)
+{
+	Pipeline const& pipeline{ findOrQueuePipeline(description) };
+
+	VkPipeline handle{ pipeline.optimizedPipeline.load(std::memory_order_acquire) };
+	if (handle == VK_NULL_HANDLE)
+		handle = pipeline.fastLinkedPipeline.load(std::memory_order_acquire);
+
+	if (handle == VK_NULL_HANDLE)
+	{
+		m_IsFrameWaiting = true;
+		return std::nullopt;
+	}
+
+	return GraphicsPipeline
+	{
+		.pipeline{ handle },
+		.depthState{ description.depthState },
+		.materialState{ description.materialState },
+		.sampleCount{ description.sampleCount },
+		.hasColorAttachment{ not isDepthOnly(description) },
+		.isStateDynamic{ description.isStateDynamic },
+		.pSetRasterizationSamples{ description.isStateDynamic ? m_pSetRasterizationSamples : nullptr },
+		.pSetColorBlendEnable{ description.isStateDynamic ? m_pSetColorBlendEnable : nullptr }
+	};
+}
+
+void fro::PipelineLibrary::waitIdle()
+{
+	std::unique_lock lock{ m_Mutex };
+	m_JobsDone.wait(lock,
+		[this]()
+		{
+			return m_dJobs.empty() and m_BusyWorkerCount == 0;
+		});
+}
+
+fro::PipelineLibraryStatistics fro::PipelineLibrary::getStatistics() const
+{
+	PipelineLibraryStatistics statistics
+	{
+		.pipelineCount{ m_mPipelines.size() },
+		.creationTime{ m_CreationTime.load() },
+		.libraryCount{ m_LibraryCount.load() },
+		.waitingFrameCount{ m_WaitingFrameCount },
+		.hitchedFrameCount{ m_HitchedFrameCount },
+		.frameCount{ m_FrameNumber }
+	};
+
+	for (auto const& [key, pipeline] : m_mPipelines)
+	{
+		bool const isFastLinked{ not pipeline.isFastLinkedPipelineRetired and pipeline.fastLinkedPipeline.load() != VK_NULL_HANDLE };
+		bool const isOptimized{ pipeline.optimizedPipeline.load() != VK_NULL_HANDLE };
+
+		statistics.fastLinkedPipelineCount += isFastLinked;
+		statistics.optimizedPipelineCount += isOptimized;
+		statistics.pendingPipelineCount += not isFastLinked and not isOptimized;
+		statistics.pendingOptimizationCount += isFastLinked and not isOptimized;
+	}
+
+	return statistics;
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+fro::PipelineLibrary::Pipeline const& fro::PipelineLibrary::findOrQueuePipeline(GraphicsPipelineDescription const& description)
+{
+	GraphicsPipelineDescription const baseDescription{ getBaseDescription(description) };
+
+	PipelineKey const key
+	{
+		baseDescription.isStateDynamic, baseDescription.pVertexShaderBytecode, baseDescription.pFragmentShaderBytecode,
+		baseDescription.colorAttachmentFormat, baseDescription.depthState.format, baseDescription.depthState.compareOp, baseDescription.depthState.isWriteEnabled,
+		baseDescription.materialState.cullMode, baseDescription.materialState.frontFace, baseDescription.materialState.isBlendEnabled,
+		baseDescription.sampleCount, baseDescription.vFragmentSpecializationConstants
+	};
+
+	auto const [pipelineIterator, isInserted] { m_mPipelines.try_emplace(key) };
+	if (isInserted)
+		enqueue({ &pipelineIterator->second, baseDescription });
+
+	return pipelineIterator->second;
+}
+
+void fro::PipelineLibrary::enqueue(Job job)
+{
+	{
+		std::lock_guard const lock{ m_Mutex };
+		m_dJobs.push_back(std::move(job));
+	}
+	m_JobAvailable.notify_one();
+}
+
+void fro::PipelineLibrary::work(std::stop_token stopToken)
+{
+	while (true)
+	{
+		Job job{};
+		{
+			std::unique_lock lock{ m_Mutex };
+			if (not m_JobAvailable.wait(lock, stopToken, [this]() { return not m_dJobs.empty(); }))
+				return;
+
+			job = std::move(m_dJobs.front());
+			m_dJobs.pop_front();
+			++m_BusyWorkerCount;
+		}
+
+		auto const creationStart{ std::chrono::high_resolution_clock::now() };
+		std::exception_ptr pException{};
+		try
+		{
+			build(job);
+		}
+		catch (...)
+		{
+			pException = std::current_exception();
+		}
+		m_CreationTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - creationStart).count();
+
+		{
+			std::lock_guard const lock{ m_Mutex };
+			if (pException and not m_pException)
+				m_pException = pException;
+
+			--m_BusyWorkerCount;
+		}
+		m_JobsDone.notify_all();
+	}
+}
+
+void fro::PipelineLibrary::build(Job const& job)
+{
+	GraphicsPipelineDescription const& baseDescription{ job.baseDescription };
+
+	if (job.libraries.has_value())
+	{
+		job.pPipeline->optimizedPipeline.store(linkLibraries(job.libraries.value(), VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT), std::memory_order_release);
+		return;
+	}
+
+	if (not m_IsSupported)
+	{
+		VkGraphicsPipelineLibraryFlagsEXT constexpr allParts
+		{
+			VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT |
+			VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+		};
+
+		static std::vector<std::uint32_t> const vNoFragmentShaderBytecode{};
+		VkPipeline const pipeline
+		{
+			createPipeline(m_LogicalDevice, {}, m_PipelineLayout, baseDescription.colorAttachmentFormat, baseDescription.depthState, baseDescription.materialState,
+				baseDescription.sampleCount, getExtendedDynamicStates(allParts, baseDescription.isStateDynamic), *baseDescription.pVertexShaderBytecode,
+				isDepthOnly(baseDescription) ? vNoFragmentShaderBytecode : *baseDescription.pFragmentShaderBytecode, baseDescription.vFragmentSpecializationConstants)
+		};
+
+		job.pPipeline->optimizedPipeline.store(pipeline, std::memory_order_release);
+		return;
+	}
+
+	std::array<VkPipeline, 4> const aLibraries
+	{
+		getVertexInputLibrary(baseDescription),
+		getPreRasterizationLibrary(baseDescription),
+		getFragmentShaderLibrary(baseDescription),
+		getFragmentOutputLibrary(baseDescription)
+	};
+
+	if (not m_IsFastLinkingSupported)
+	{
+		job.pPipeline->optimizedPipeline.store(linkLibraries(aLibraries, VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT), std::memory_order_release);
+		return;
+	}
+
+	// the optimized link goes to the back of the queue, so pipelines nobody has yet come first
+	job.pPipeline->fastLinkedPipeline.store(linkLibraries(aLibraries, 0), std::memory_order_release);
+	enqueue({ job.pPipeline, baseDescription, aLibraries });
+}
+
+fro::GraphicsPipelineDescription fro::PipelineLibrary::getBaseDescription(GraphicsPipelineDescription const& description) const
+{
+	GraphicsPipelineDescription baseDescription{ description };
+	if (isDepthOnly(description))
+	{
+		baseDescription.pFragmentShaderBytecode = nullptr;
+		baseDescription.vFragmentSpecializationConstants.clear();
+	}
+
+	if (not description.isStateDynamic)
+		return baseDescription;
+
+	baseDescription.depthState.compareOp = VK_COMPARE_OP_LESS;
+	baseDescription.depthState.isWriteEnabled = VK_TRUE;
+	baseDescription.materialState.cullMode = VK_CULL_MODE_NONE;
+	baseDescription.materialState.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+	if (m_pSetColorBlendEnable)
+		baseDescription.materialState.isBlendEnabled = VK_FALSE;
+
+	if (m_pSetRasterizationSamples)
+		baseDescription.sampleCount = VK_SAMPLE_COUNT_1_BIT;
+
+	return baseDescription;
+}
+
+std::vector<VkDynamicState> fro::PipelineLibrary::getExtendedDynamicStates(VkGraphicsPipelineLibraryFlagsEXT const parts, bool const isStateDynamic) const
+{
+	std::vector<VkDynamicState> vDynamicStates{};
+	if (not isStateDynamic)
+		return vDynamicStates;
+
+	if (parts & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT)
+		vDynamicStates.push_back(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY);
+
+	if (parts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT)
+		vDynamicStates.insert(vDynamicStates.end(), { VK_DYNAMIC_STATE_CULL_MODE, VK_DYNAMIC_STATE_FRONT_FACE });
+
+	if (parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT)
+		vDynamicStates.insert(vDynamicStates.end(), { VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE, VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE, VK_DYNAMIC_STATE_DEPTH_COMPARE_OP });
+
+	// the sample count is part of both the fragment shader and the fragment output state, which have to agree on it
+	if (m_pSetRasterizationSamples and parts & (VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT))
+		vDynamicStates.push_back(VK_DYNAMIC_STATE_RASTERIZATION_SAMPLES_EXT);
+
+	if (m_pSetColorBlendEnable and parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT)
+		vDynamicStates.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+
+	return vDynamicStates;
+}
+
+template<typename KEY>
+VkPipeline fro::PipelineLibrary::findOrCreateLibrary(std::map<KEY, Library>& mLibraries, KEY const& key, std::function<UniquePointer<VkPipeline_T>()> const& libraryCreator)
+{
+	// the lock only covers the lookup, so workers create different libraries side by side; whoever inserts the entry
+	// creates the library, and everyone asking for it in the meantime waits on its future instead
+	std::promise<VkPipeline> handlePromise{};
+	std::shared_future<VkPipeline> handle{};
+	Library* pLibrary{};
+	{
+		std::lock_guard const lock{ m_LibraryMutex };
+		auto const [libraryIterator, isInserted] { mLibraries.try_emplace(key) };
+		if (isInserted)
+		{
+			libraryIterator->second.handle = handlePromise.get_future().share();
+			pLibrary = &libraryIterator->second;
+		}
+		else
+			handle = libraryIterator->second.handle;
+	}
+
+	// a creation that threw breaks the promise, which the waiting workers then throw as well
+	if (not pLibrary)
+		return handle.get();
+
+	UniquePointer<VkPipeline_T> pCreatedLibrary{ libraryCreator() };
+	VkPipeline const createdHandle{ pCreatedLibrary.get() };
+	{
+		std::lock_guard const lock{ m_LibraryMutex };
+		pLibrary->pLibrary = std::move(pCreatedLibrary);
+	}
+
+	++m_LibraryCount;
+	handlePromise.set_value(createdHandle);
+	return createdHandle;
+}
+
+VkPipeline fro::PipelineLibrary::getVertexInputLibrary(GraphicsPipelineDescription const& baseDescription)
+{
+	auto constexpr bindingDescription{ getVertexBindingDescription<QuantizedVertex>() };
+	auto constexpr attributeDescriptions{ getVertexAttributeDescriptions<QuantizedVertex>() };
+
+	// the position comes first, and is all a depth only vertex shader takes
+	std::uint32_t const attributeCount{ isDepthOnly(baseDescription) ? 1u : static_cast<std::uint32_t>(attributeDescriptions.size()) };
+
+	VertexInputKey const key{ baseDescription.isStateDynamic, attributeCount };
+
+	return findOrCreateLibrary(m_mVertexInputLibraries, key,
+		[&]()
+		{
+			VkPipelineVertexInputStateCreateInfo const vertexInputStateCreateInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO },
+				.vertexBindingDescriptionCount{ 1 },
+				.pVertexBindingDescriptions{ &bindingDescription },
+				.vertexAttributeDescriptionCount{ attributeCount },
+				.pVertexAttributeDescriptions{ attributeDescriptions.data() }
+			};
+
+			VkPipelineInputAssemblyStateCreateInfo const inputAssemblyStateCreateInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO },
+				.topology{ VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST },
+				.primitiveRestartEnable{ VK_FALSE }
+			};
+
+			std::vector<VkDynamicState> const vDynamicStates{ getExtendedDynamicStates(VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, baseDescription.isStateDynamic) };
+			VkPipelineDynamicStateCreateInfo const dynamicStateCreateInfo{ getDynamicStateCreateInfo(vDynamicStates) };
+
+			return createLibrary(
+				{
+					.pVertexInputState{ &vertexInputStateCreateInfo },
+					.pInputAssemblyState{ &inputAssemblyStateCreateInfo },
+					.pDynamicState{ &dynamicStateCreateInfo }
+				}, VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT);
+		});
+}
+
+VkPipeline fro::PipelineLibrary::getPreRasterizationLibrary(GraphicsPipelineDescription const& baseDescription)
+{
+	PreRasterizationKey const key
+	{
+		baseDescription.isStateDynamic, baseDescription.pVertexShaderBytecode, baseDescription.materialState.cullMode, baseDescription.materialState.frontFace
+	};
+
+	return findOrCreateLibrary(m_mPreRasterizationLibraries, key,
+		[&]()
+		{
+			std::unique_ptr<VkShaderModule_T, std::function<void(VkShaderModule_T*)>> const pVertexShaderModule
+			{
+				createShaderModule(*baseDescription.pVertexShaderBytecode, m_LogicalDevice),
+				std::bind(vkDestroyShaderModule, m_LogicalDevice, std::placeholders::_1, nullptr)
+			};
+
+			VkPipelineShaderStageCreateInfo const shaderStageCreateInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO },
+				.stage{ VK_SHADER_STAGE_VERTEX_BIT },
+				.module{ pVertexShaderModule.get() },
+				.pName{ "main" }
+			};
+
+			std::vector<VkDynamicState> vDynamicStates
+			{
+				VK_DYNAMIC_STATE_VIEWPORT,
+				VK_DYNAMIC_STATE_SCISSOR
+			};
+			std::vector<VkDynamicState> const vExtendedDynamicStates{ getExtendedDynamicStates(VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT, baseDescription.isStateDynamic) };
+			vDynamicStates.insert(vDynamicStates.end(), vExtendedDynamicStates.begin(), vExtendedDynamicStates.end());
+
+			VkPipelineDynamicStateCreateInfo const dynamicStateCreateInfo{ getDynamicStateCreateInfo(vDynamicStates) };
+
+			VkPipelineViewportStateCreateInfo const viewportStateCreateInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO },
+				.viewportCount{ 1 },
+				.scissorCount{ 1 }
+			};
+
+			VkPipelineRasterizationStateCreateInfo const rasterizationStateCreateInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO },
+				.depthClampEnable{ VK_FALSE },
+				.rasterizerDiscardEnable{ VK_FALSE },
+				.polygonMode{ VK_POLYGON_MODE_FILL },
+				.cullMode{ baseDescription.materialState.cullMode },
+				.frontFace{ baseDescription.materialState.frontFace },
+				.depthBiasEnable{ VK_FALSE },
+				.lineWidth{ 1.0f }
+			};
+
+			VkPipelineRenderingCreateInfo const renderingCreateInfo{ getRenderingCreateInfo(baseDescription) };
+
+			return createLibrary(
+				{
+					.pNext{ &renderingCreateInfo },
+					.stageCount{ 1 },
+					.pStages{ &shaderStageCreateInfo },
+					.pViewportState{ &viewportStateCreateInfo },
+					.pRasterizationState{ &rasterizationStateCreateInfo },
+					.pDynamicState{ &dynamicStateCreateInfo },
+					.layout{ m_PipelineLayout }
+				}, VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT);
+		});
+}
+
+VkPipeline fro::PipelineLibrary::getFragmentShaderLibrary(GraphicsPipelineDescription const& baseDescription)
+{
+	bool const isDepthOnlyLibrary{ isDepthOnly(baseDescription) };
+
+	FragmentShaderKey const key
+	{
+		baseDescription.isStateDynamic, baseDescription.pFragmentShaderBytecode,
+		baseDescription.depthState.compareOp, baseDescription.depthState.isWriteEnabled, baseDescription.sampleCount,
+		baseDescription.vFragmentSpecializationConstants
+	};
+
+	return findOrCreateLibrary(m_mFragmentShaderLibraries, key,
+		[&]()
+		{
+			std::unique_ptr<VkShaderModule_T, std::function<void(VkShaderModule_T*)>> const pFragmentShaderModule
+			{
+				isDepthOnlyLibrary ? VK_NULL_HANDLE : createShaderModule(*baseDescription.pFragmentShaderBytecode, m_LogicalDevice),
+				std::bind(vkDestroyShaderModule, m_LogicalDevice, std::placeholders::_1, nullptr)
+			};
+
+			std::vector<std::uint32_t> const& vConstants{ baseDescription.vFragmentSpecializationConstants };
+			std::vector<VkSpecializationMapEntry> const vSpecializationMapEntries{ getSpecializationMapEntries(vConstants) };
+			VkSpecializationInfo const specializationInfo
+			{
+				.mapEntryCount{ static_cast<std::uint32_t>(vSpecializationMapEntries.size()) },
+				.pMapEntries{ vSpecializationMapEntries.data() },
+				.dataSize{ vConstants.size() * sizeof(std::uint32_t) },
+				.pData{ vConstants.data() }
+			};
+
+			VkPipelineShaderStageCreateInfo const shaderStageCreateInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO },
+				.stage{ VK_SHADER_STAGE_FRAGMENT_BIT },
+				.module{ pFragmentShaderModule.get() },
+				.pName{ "main" },
+				.pSpecializationInfo{ vSpecializationMapEntries.empty() ? nullptr : &specializationInfo }
+			};
+
+			VkPipelineDepthStencilStateCreateInfo const depthStencilStateCreateInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO },
+				.depthTestEnable{ VK_TRUE },
+				.depthWriteEnable{ baseDescription.depthState.isWriteEnabled },
+				.depthCompareOp{ baseDescription.depthState.compareOp },
+				.depthBoundsTestEnable{ VK_FALSE },
+				.stencilTestEnable{ VK_FALSE }
+			};
+
+			std::vector<VkDynamicState> const vDynamicStates{ getExtendedDynamicStates(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, baseDescription.isStateDynamic) };
+			VkPipelineDynamicStateCreateInfo const dynamicStateCreateInfo{ getDynamicStateCreateInfo(vDynamicStates) };
+
+			VkPipelineMultisampleStateCreateInfo const multisampleStateCreateInfo{ getMultisampleStateCreateInfo(baseDescription) };
+			VkPipelineRenderingCreateInfo const renderingCreateInfo{ getRenderingCreateInfo(baseDescription) };
+
+			return createLibrary(
+				{
+					.pNext{ &renderingCreateInfo },
+					.stageCount{ isDepthOnlyLibrary ? 0u : 1u },
+					.pStages{ &shaderStageCreateInfo },
+					.pMultisampleState{ &multisampleStateCreateInfo },
+					.pDepthStencilState{ &depthStencilStateCreateInfo },
+					.pDynamicState{ &dynamicStateCreateInfo },
+					.layout{ m_PipelineLayout }
+				}, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT);
+		});
+}
+
+VkPipeline fro::PipelineLibrary::getFragmentOutputLibrary(GraphicsPipelineDescription const& baseDescription)
+{
+	bool const isDepthOnlyLibrary{ isDepthOnly(baseDescription) };
+
+	FragmentOutputKey const key
+	{
+		baseDescription.isStateDynamic, isDepthOnlyLibrary, baseDescription.colorAttachmentFormat, baseDescription.depthState.format,
+		baseDescription.sampleCount, baseDescription.materialState.isBlendEnabled
+	};
+
+	return findOrCreateLibrary(m_mFragmentOutputLibraries, key,
+		[&]()
+		{
+			// the blend factors are baked in even when blending is left dynamic, only whether it's enabled can change
+			VkPipelineColorBlendAttachmentState const colorBlendAttachmentState
+			{
+				.blendEnable{ baseDescription.materialState.isBlendEnabled },
+				.srcColorBlendFactor{ VK_BLEND_FACTOR_SRC_ALPHA },
+				.dstColorBlendFactor{ VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA },
+				.colorBlendOp{ VK_BLEND_OP_ADD },
+				.srcAlphaBlendFactor{ VK_BLEND_FACTOR_ONE },
+				.dstAlphaBlendFactor{ VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA },
+				.alphaBlendOp{ VK_BLEND_OP_ADD },
+				.colorWriteMask{ VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT }
+			};
+
+			VkPipelineColorBlendStateCreateInfo const colorBlendStateCreateInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO },
+				.logicOpEnable{ VK_FALSE },
+				.attachmentCount{ isDepthOnlyLibrary ? 0u : 1u },
+				.pAttachments{ &colorBlendAttachmentState }
+			};
+
+			std::vector<VkDynamicState> const vDynamicStates{ getExtendedDynamicStates(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, baseDescription.isStateDynamic) };
+			VkPipelineDynamicStateCreateInfo const dynamicStateCreateInfo{ getDynamicStateCreateInfo(vDynamicStates) };
+
+			VkPipelineMultisampleStateCreateInfo const multisampleStateCreateInfo{ getMultisampleStateCreateInfo(baseDescription) };
+			VkPipelineRenderingCreateInfo const renderingCreateInfo{ getRenderingCreateInfo(baseDescription) };
+
+			return createLibrary(
+				{
+					.pNext{ &renderingCreateInfo },
+					.pMultisampleState{ &multisampleStateCreateInfo },
+					.pColorBlendState{ &colorBlendStateCreateInfo },
+					.pDynamicState{ &dynamicStateCreateInfo }
+				}, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT);
+		});
+}
+
+fro::UniquePointer<VkPipeline_T> fro::PipelineLibrary::createLibrary(VkGraphicsPipelineCreateInfo createInfo, VkGraphicsPipelineLibraryFlagsEXT const libraryFlags) const
+{
+	VkGraphicsPipelineLibraryCreateInfoEXT const libraryCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT },
+		.pNext{ createInfo.pNext },
+		.flags{ libraryFlags }
+	};
+
+	createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	createInfo.pNext = &libraryCreateInfo;
+	// retaining what link time optimization needs lets the background links optimize across the libraries
+	createInfo.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+
+	VkPipeline library;
+	if (vkCreateGraphicsPipelines(m_LogicalDevice, VK_NULL_HANDLE, 1, &createInfo, nullptr, &library) != VK_SUCCESS)
+		throw std::runtime_error("vkCreateGraphicsPipelines() failed!");
+
+	return { library, std::bind(vkDestroyPipeline, m_LogicalDevice, std::placeholders::_1, nullptr) };
+}
+
+VkPipeline fro::PipelineLibrary::linkLibraries(std::array<VkPipeline, 4> const& aLibraries, VkPipelineCreateFlags const flags) const
+{
+	VkPipelineLibraryCreateInfoKHR const libraryCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR },
+		.libraryCount{ static_cast<std::uint32_t>(aLibraries.size()) },
+		.pLibraries{ aLibraries.data() }
+	};
+
+	VkGraphicsPipelineCreateInfo const pipelineCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO },
+		.pNext{ &libraryCreateInfo },
+		.flags{ flags },
+		.layout{ m_PipelineLayout }
+	};
+
+	VkPipeline pipeline;
+	if (vkCreateGraphicsPipelines(m_LogicalDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipeline) != VK_SUCCESS)
+		throw std::runtime_error("vkCreateGraphicsPipelines() failed!");
+
+	return pipeline;
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
@@ -0,0 +1,255 @@
+#if not defined fro_PIPELINE_LIBRARY_H
+#define fro_PIPELINE_LIBRARY_H
+
+#include "HelperStructs.h"
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace fro
+{
+	// a graphics pipeline rendering with dynamic rendering into one color attachment and a depth attachment
+	struct GraphicsPipelineDescription final
+	{
+		// both are told apart by address, so they have to outlive the library; without fragment shader bytecode
+		// it's a depth only pipeline that takes nothing but the vertices' positions and has no color attachment
+		std::vector<std::uint32_t> const* pVertexShaderBytecode;
+		std::vector<std::uint32_t> const* pFragmentShaderBytecode;
+		VkFormat colorAttachmentFormat;
+		DepthState depthState;
+		MaterialState materialState;
+		VkSampleCountFlagBits sampleCount;
+		// whether the pipeline uses extended dynamic state, leaving culling, depth testing and, where
+		// VK_EXT_extended_dynamic_state3 allows, the sample count and blending to be set while recording
+		bool isStateDynamic;
+		// the fragment shader's specialization constants' values by constant_id; pipelines that only differ in these
+		// share their shader module's bytecode, but are created apart
+		std::vector<std::uint32_t> vFragmentSpecializationConstants;
+	};
+
+	// a pipeline along with the state it was asked for, which recordPipelineBind() sets for as far as the pipeline
+	// leaves it dynamic
+	struct GraphicsPipeline final
+	{
+		VkPipeline pipeline;
+		DepthState depthState;
+		MaterialState materialState;
+		VkSampleCountFlagBits sampleCount;
+		bool hasColorAttachment;
+		bool isStateDynamic;
+		// only there when the pipeline leaves the sample count and blending to VK_EXT_extended_dynamic_state3
+		PFN_vkCmdSetRasterizationSamplesEXT pSetRasterizationSamples;
+		PFN_vkCmdSetColorBlendEnableEXT pSetColorBlendEnable;
+	};
+
+	struct PipelineLibraryStatistics final
+	{
+		std::size_t pipelineCount;
+		// summed over the workers, background links included
+		double creationTime;
+		std::size_t libraryCount;
+		std::size_t fastLinkedPipelineCount;
+		std::size_t optimizedPipelineCount;
+		// asked for, but not usable yet
+		std::size_t pendingPipelineCount;
+		std::size_t pendingOptimizationCount;
+		// frames that asked for a pipeline that wasn't ready, whether they had an older one to fall back to or not
+		std::uint64_t waitingFrameCount;
+		// frames that had no pipeline to draw with at all, and skipped their draws
+		std::uint64_t hitchedFrameCount;
+		std::uint64_t frameCount;
+	};
+
+	// whether the device can build pipelines out of independently created parts; createLogicalDevice() enables
+	// the extensions and the feature whenever it can
+	[[nodiscard("graphics pipeline library support result ignored!")]]
+	bool isGraphicsPipelineLibrarySupported(VkPhysicalDevice const physicalDevice);
+
+	// the VK_EXT_extended_dynamic_state3 features PipelineLibrary uses, for as far as the device supports them; ready
+	// to be chained into the logical device's creation
+	[[nodiscard("extended dynamic state 3 features ignored!")]]
+	VkPhysicalDeviceExtendedDynamicState3FeaturesEXT getExtendedDynamicState3Features(VkPhysicalDevice const physicalDevice);
+
+	// binds the pipeline and sets the state it leaves dynamic
+	void recordPipelineBind(VkCommandBuffer const commandBuffer, GraphicsPipeline const& pipeline);
+
+	// builds graphics pipelines on a pool of worker threads, so asking for a new one never stalls the render thread
+	// on a driver compile; until it's there, getPipeline() has nothing to hand out and callers fall back to a pipeline
+	// they know is ready, or skip their draws. Finished pipelines are published through atomics the render thread
+	// reads without taking a lock.
+	// With VK_EXT_graphics_pipeline_library, vertex input, pre-rasterization, fragment shader and fragment output
+	// libraries are each created once for the state they depend on and shared between every pipeline using that
+	// state. A new pipeline is fast linked from its libraries, and a link time optimized version is linked next to
+	// replace it. Without the extension, pipelines get created whole.
+	// Pipelines described as leaving their state dynamic are shared between materials that only differ in that
+	// state, and kept apart from the ones baking it in
+	class PipelineLibrary final
+	{
+	public:
+		PipelineLibrary(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, VkPipelineLayout const pipelineLayout, std::uint32_t const framesInFlight);
+
+		// drops the queued jobs and waits for the ones being worked on
+		~PipelineLibrary();
+
+		// once per frame, after the frame's fence wait: rethrows what the workers failed with, destroys the fast
+		// linked pipelines the optimized ones replaced once no frame in flight can be using them anymore, and closes
+		// the frame's waiting and hitch counts
+		void update();
+
+		// counts the frame as hitched; only the caller knows whether it still found a pipeline to fall back to
+		void markFrameHitched();
+
+		// queues the pipeline's creation if it hasn't been asked for before, without counting as waiting on it
+		void prepare(GraphicsPipelineDescription const& description);
+
+		// the optimized pipeline once it's there, the fast linked one until then, and nothing while neither is
+		[[nodiscard("graphics pipeline ignored!")]]
+		std::optional<GraphicsPipeline> getPipeline(GraphicsPipelineDescription const& description);
+
+		// blocks until every queued job is done, background links included
+		void waitIdle();
+
+		[[nodiscard("pipeline library statistics ignored!")]]
+		PipelineLibraryStatistics getStatistics() const;
+
+	private:
+		// every key starts with whether the state is dynamic, since a pipeline baking in a value isn't interchangeable
+		// with one leaving it dynamic
+		using VertexInputKey = std::tuple<bool, std::uint32_t>;
+		using PreRasterizationKey = std::tuple<bool, std::vector<std::uint32_t> const*, VkCullModeFlags, VkFrontFace>;
+		using FragmentShaderKey = std::tuple<bool, std::vector<std::uint32_t> const*, VkCompareOp, VkBool32, VkSampleCountFlagBits, std::vector<std::uint32_t>>;
+		using FragmentOutputKey = std::tuple<bool, bool, VkFormat, VkFormat, VkSampleCountFlagBits, VkBool32>;
+		using PipelineKey = std::tuple<bool, std::vector<std::uint32_t> const*, std::vector<std::uint32_t> const*, VkFormat, VkFormat, VkCompareOp, VkBool32,
+			VkCullModeFlags, VkFrontFace, VkBool32, VkSampleCountFlagBits, std::vector<std::uint32_t>>;
+
+		// the handles are stored once by a worker and owned by the library from then on; map nodes don't move, so
+		// workers can keep pointing at them while the render thread inserts others
+		struct Pipeline final
+		{
+			std::atomic<VkPipeline> fastLinkedPipeline{};
+			std::atomic<VkPipeline> optimizedPipeline{};
+			// only touched by the render thread
+			bool isFastLinkedPipelineRetired{};
+		};
+
+		struct Job final
+		{
+			Pipeline* pPipeline;
+			GraphicsPipelineDescription baseDescription;
+			// only link time optimization jobs have them
+			std::optional<std::array<VkPipeline, 4>> libraries;
+		};
+
+		// created by the first worker to need it; the handle is ready once the library is
+		struct Library final
+		{
+			std::shared_future<VkPipeline> handle;
+			UniquePointer<VkPipeline_T> pLibrary;
+		};
+
+		struct RetiredPipeline final
+		{
+			UniquePointer<VkPipeline_T> pPipeline;
+			std::uint64_t retiredFrame;
+		};
+
+		PipelineLibrary(PipelineLibrary const&) = delete;
+		PipelineLibrary(PipelineLibrary&&) noexcept = delete;
+
+		PipelineLibrary& operator=(PipelineLibrary const&) = delete;
+		PipelineLibrary& operator=(PipelineLibrary&&) noexcept = delete;
+
+		// queues the pipeline's creation the first time it's asked for
+		[[nodiscard("pipeline entry ignored!")]]
+		Pipeline const& findOrQueuePipeline(GraphicsPipelineDescription const& description);
+
+		void enqueue(Job job);
+		void work(std::stop_token stopToken);
+		void build(Job const& job);
+
+		// the description with whatever its mode leaves dynamic set to the same value for every pipeline
+		[[nodiscard("base pipeline description ignored!")]]
+		GraphicsPipelineDescription getBaseDescription(GraphicsPipelineDescription const& description) const;
+
+		// the state the given pipeline parts leave dynamic, if the mode uses extended dynamic state
+		[[nodiscard("extended dynamic states ignored!")]]
+		std::vector<VkDynamicState> getExtendedDynamicStates(VkGraphicsPipelineLibraryFlagsEXT const parts, bool const isStateDynamic) const;
+
+		// the library of the key, created by libraryCreator if no worker has created it or is creating it already
+		template<typename KEY>
+		[[nodiscard("pipeline library ignored!")]]
+		VkPipeline findOrCreateLibrary(std::map<KEY, Library>& mLibraries, KEY const& key, std::function<UniquePointer<VkPipeline_T>()> const& libraryCreator);
+
+		// the library getters take base descriptions, and are called by the workers
+		[[nodiscard("vertex input library ignored!")]]
+		VkPipeline getVertexInputLibrary(GraphicsPipelineDescription const& baseDescription);
+
+		[[nodiscard("pre-rasterization library ignored!")]]
+		VkPipeline getPreRasterizationLibrary(GraphicsPipelineDescription const& baseDescription);
+
+		[[nodiscard("fragment shader library ignored!")]]
+		VkPipeline getFragmentShaderLibrary(GraphicsPipelineDescription const& baseDescription);
+
+		[[nodiscard("fragment output library ignored!")]]
+		VkPipeline getFragmentOutputLibrary(GraphicsPipelineDescription const& baseDescription);
+
+		// createInfo gets the library flags and the part it builds chained in
+		[[nodiscard("pipeline library ignored!")]]
+		UniquePointer<VkPipeline_T> createLibrary(VkGraphicsPipelineCreateInfo createInfo, VkGraphicsPipelineLibraryFlagsEXT const libraryFlags) const;
+
+		[[nodiscard("linked pipeline ignored!")]]
+		VkPipeline linkLibraries(std::array<VkPipeline, 4> const& aLibraries, VkPipelineCreateFlags const flags) const;
+
+		VkDevice const m_LogicalDevice;
+		VkPipelineLayout const m_PipelineLayout;
+		std::uint32_t const m_FramesInFlight;
+		bool const m_IsSupported;
+		// without it, fast links can take as long as optimized ones, so pipelines only get linked optimized
+		bool m_IsFastLinkingSupported{};
+		PFN_vkCmdSetRasterizationSamplesEXT m_pSetRasterizationSamples{};
+		PFN_vkCmdSetColorBlendEnableEXT m_pSetColorBlendEnable{};
+
+		// only touched by the render thread
+		std::map<PipelineKey, Pipeline> m_mPipelines{};
+		std::vector<RetiredPipeline> m_vRetiredPipelines{};
+		std::uint64_t m_FrameNumber{};
+		std::uint64_t m_WaitingFrameCount{};
+		std::uint64_t m_HitchedFrameCount{};
+		bool m_IsFrameWaiting{};
+		bool m_IsFrameHitched{};
+
+		// shared between the workers, which only hold it to look up and insert libraries, never while creating one
+		std::mutex m_LibraryMutex{};
+		std::map<VertexInputKey, Library> m_mVertexInputLibraries{};
+		std::map<PreRasterizationKey, Library> m_mPreRasterizationLibraries{};
+		std::map<FragmentShaderKey, Library> m_mFragmentShaderLibraries{};
+		std::map<FragmentOutputKey, Library> m_mFragmentOutputLibraries{};
+		std::atomic<std::size_t> m_LibraryCount{};
+		std::atomic<double> m_CreationTime{};
+
+		std::mutex m_Mutex{};
+		std::condition_variable_any m_JobAvailable{};
+		std::condition_variable m_JobsDone{};
+		std::deque<Job> m_dJobs{};
+		std::size_t m_BusyWorkerCount{};
+		std::exception_ptr m_pException{};
+		std::vector<std::jthread> m_vWorkers{};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "PipelineStatisticsQueries.h"
+
+#include <stdexcept>
+
+#pragma region Constructors/Destructor
+fro::PipelineStatisticsQueries::PipelineStatisticsQueries(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, std::uint32_t const framesInFlight):
+	m_LogicalDevice{ logicalDevice },
+	m_vIsRecorded(framesInFlight)
+{
+	VkPhysicalDeviceFeatures features;
+	vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+
+	if (not features.pipelineStatisticsQuery)
+		return;
+
+	VkQueryPoolCreateInfo const queryPoolCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO },
+		.queryType{ VK_QUERY_TYPE_PIPELINE_STATISTICS },
+		.queryCount{ 1 },
+		.pipelineStatistics{ VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT }
+	};
+
+	for (std::uint32_t index{}; index < framesInFlight; ++index)
+	{
+		VkQueryPool queryPool;
+		if (vkCreateQueryPool(m_LogicalDevice, &queryPoolCreateInfo, nullptr, &queryPool) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateQueryPool() failed!");
+
+		m_vpQueryPools.push_back({ queryPool, std::bind(vkDestroyQueryPool, m_LogicalDevice, std::placeholders::_1, nullptr) });
+	}
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+void fro::PipelineStatisticsQueries::update(std::uint32_t const frameIndex)
+{
+	if (m_vpQueryPools.empty() or not m_vIsRecorded[frameIndex])
+		return;
+
+	std::uint64_t fragmentShaderInvocations;
+	if (vkGetQueryPoolResults(m_LogicalDevice, m_vpQueryPools[frameIndex].get(), 0, 1,
+		sizeof(fragmentShaderInvocations), &fragmentShaderInvocations, sizeof(fragmentShaderInvocations), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		m_Statistics = PipelineStatistics{ fragmentShaderInvocations };
+}
+
+void fro::PipelineStatisticsQueries::recordBegin(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex)
+{
+	if (m_vpQueryPools.empty())
+		return;
+
+	vkCmdResetQueryPool(commandBuffer, m_vpQueryPools[frameIndex].get(), 0, 1);
+	vkCmdBeginQuery(commandBuffer, m_vpQueryPools[frameIndex].get(), 0, 0);
+	m_vIsRecorded[frameIndex] = true;
+}
+
+void fro::PipelineStatisticsQueries::recordEnd(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex) const
+{
+	if (m_vpQueryPools.empty())
+		return;
+
+	vkCmdEndQuery(commandBuffer, m_vpQueryPools[frameIndex].get(), 0);
+}
+
+std::optional<fro::PipelineStatistics> fro::PipelineStatisticsQueries::getStatistics() const
+{
+	return m_Statistics;
+}
+#pragma endregion PublicMethods
\ No newline at end of file
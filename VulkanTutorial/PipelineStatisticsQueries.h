@@ -0,0 +1,55 @@
+#if not defined fro_PIPELINE_STATISTICS_QUERIES_H
+#define fro_PIPELINE_STATISTICS_QUERIES_H
+
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace fro
+{
+	struct PipelineStatistics final
+	{
+		std::uint64_t fragmentShaderInvocations;
+	};
+
+	// one pipeline statistics query per frame in flight, read back without waiting once the frame's fence has
+	// signaled; without the pipelineStatisticsQuery feature, recording does nothing and there are no statistics
+	class PipelineStatisticsQueries final
+	{
+	public:
+		PipelineStatisticsQueries(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, std::uint32_t const framesInFlight);
+
+		~PipelineStatisticsQueries() = default;
+
+		// reads back what frameIndex's last recording counted; call after the frame's fence wait
+		void update(std::uint32_t const frameIndex);
+
+		// outside a render pass, around everything the frame's statistics should count
+		void recordBegin(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex);
+		void recordEnd(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex) const;
+
+		// the last frame read back, none before the first one or without support
+		[[nodiscard("pipeline statistics ignored!")]]
+		std::optional<PipelineStatistics> getStatistics() const;
+
+	private:
+		PipelineStatisticsQueries(PipelineStatisticsQueries const&) = delete;
+		PipelineStatisticsQueries(PipelineStatisticsQueries&&) noexcept = delete;
+
+		PipelineStatisticsQueries& operator=(PipelineStatisticsQueries const&) = delete;
+		PipelineStatisticsQueries& operator=(PipelineStatisticsQueries&&) noexcept = delete;
+
+		VkDevice const m_LogicalDevice;
+
+		// empty without support
+		std::vector<UniquePointer<VkQueryPool_T>> m_vpQueryPools{};
+		std::vector<bool> m_vIsRecorded;
+		std::optional<PipelineStatistics> m_Statistics{};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,583 @@
+#include "RenderGraph.h"
+
+#include "HelperFunctions.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace
+{
+	VkImageAspectFlags getImageAspect(VkFormat const format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT;
+
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+		default:
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+		}
+	}
+
+	// where a resource stands between passes: the writes that haven't been waited on yet, and the stages and
+	// accesses that have been made to see them or read since
+	struct TrackedState final
+	{
+		VkPipelineStageFlags2 writeStageMask;
+		VkAccessFlags2 writeAccessMask;
+		VkPipelineStageFlags2 readStageMask;
+		VkPipelineStageFlags2 visibleStageMask;
+		VkAccessFlags2 visibleAccessMask;
+		VkImageLayout layout;
+	};
+
+	// nothing but render passes touch these, so on tile based GPUs they can live in tile memory and never need
+	// memory of their own
+	bool isAttachmentOnly(VkImageUsageFlags const usage)
+	{
+		VkImageUsageFlags constexpr attachmentUsage{ VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT };
+		return usage != 0 and (usage & ~attachmentUsage) == 0;
+	}
+
+	std::optional<std::uint32_t> findLazilyAllocatedMemoryType(std::uint32_t const memoryTypeBits, VkPhysicalDeviceMemoryProperties const& memoryProperties)
+	{
+		for (std::uint32_t index{}; index < memoryProperties.memoryTypeCount; ++index)
+			if ((memoryTypeBits & (1u << index)) and (memoryProperties.memoryTypes[index].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT))
+				return index;
+
+		return std::nullopt;
+	}
+
+	bool areLifetimesOverlapping(std::uint32_t const firstBegin, std::uint32_t const firstEnd, std::uint32_t const secondBegin, std::uint32_t const secondEnd)
+	{
+		return firstBegin <= secondEnd and secondBegin <= firstEnd;
+	}
+}
+
+#pragma region Constructors/Destructor
+fro::RenderGraph::PassBuilder::PassBuilder(Pass& pass):
+	m_Pass{ pass }
+{
+}
+
+fro::RenderGraph::RenderGraph(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, std::uint32_t const framesInFlight):
+	m_LogicalDevice{ logicalDevice },
+	m_PhysicalDevice{ physicalDevice },
+	m_vFrameTransientImages(framesInFlight)
+{
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+bool fro::TransientImageDescription::operator==(TransientImageDescription const& other) const
+{
+	return
+		format == other.format and
+		extent.width == other.extent.width and
+		extent.height == other.extent.height and
+		samples == other.samples;
+}
+
+fro::RenderGraph::PassBuilder& fro::RenderGraph::PassBuilder::read(RenderGraphResource const resource, ResourceUsage const usage)
+{
+	if (getResourceUsageInfo(usage).isWrite)
+		throw std::runtime_error("render graph pass reads with a writing usage!");
+
+	m_Pass.vReads.push_back({ resource, usage });
+	return *this;
+}
+
+fro::RenderGraph::PassBuilder& fro::RenderGraph::PassBuilder::write(RenderGraphResource const resource, ResourceUsage const usage)
+{
+	if (not getResourceUsageInfo(usage).isWrite)
+		throw std::runtime_error("render graph pass writes with a reading usage!");
+
+	m_Pass.vWrites.push_back({ resource, usage });
+	return *this;
+}
+
+fro::RenderGraph::PassBuilder& fro::RenderGraph::PassBuilder::execute(std::function<void(VkCommandBuffer)> execution)
+{
+	m_Pass.execution = std::move(execution);
+	return *this;
+}
+
+void fro::RenderGraph::reset()
+{
+	m_dPasses.clear();
+	m_vResources.clear();
+	m_vTransientDescriptions.clear();
+	m_vExecutedPasses.clear();
+	m_vBarrierBatches.clear();
+	m_pTransientImages = nullptr;
+}
+
+fro::RenderGraphResource fro::RenderGraph::importImage(VkImage const image, VkImageAspectFlags const aspectMask, ResourceState const& initialState, std::optional<ResourceUsage> const finalUsage)
+{
+	m_vResources.push_back(
+		{
+			.image{ image },
+			.aspectMask{ aspectMask },
+			.initialState{ initialState },
+			.finalUsage{ finalUsage }
+		});
+
+	return static_cast<RenderGraphResource>(m_vResources.size() - 1);
+}
+
+fro::RenderGraphResource fro::RenderGraph::importBuffer(VkBuffer const buffer, ResourceState const& initialState, std::optional<ResourceUsage> const finalUsage)
+{
+	m_vResources.push_back(
+		{
+			.buffer{ buffer },
+			.initialState{ initialState },
+			.finalUsage{ finalUsage }
+		});
+
+	return static_cast<RenderGraphResource>(m_vResources.size() - 1);
+}
+
+fro::RenderGraphResource fro::RenderGraph::createImage(TransientImageDescription const& description)
+{
+	m_vResources.push_back(
+		{
+			.aspectMask{ getImageAspect(description.format) },
+			.initialState{ g_DiscardedResourceState },
+			.transientIndex{ static_cast<std::uint32_t>(m_vTransientDescriptions.size()) }
+		});
+
+	m_vTransientDescriptions.push_back(description);
+	return static_cast<RenderGraphResource>(m_vResources.size() - 1);
+}
+
+fro::RenderGraph::PassBuilder fro::RenderGraph::addPass(std::string_view const name)
+{
+	m_dPasses.push_back({ .name{ std::string(name) } });
+	return PassBuilder{ m_dPasses.back() };
+}
+
+void fro::RenderGraph::compile(std::uint32_t const frameIndex)
+{
+	cullPasses();
+
+	// lifetimes count executed passes, so culled ones don't stretch them
+	std::vector<TransientImage> vImages(m_vTransientDescriptions.size());
+	for (std::size_t index{}; index < vImages.size(); ++index)
+		vImages[index] = { m_vTransientDescriptions[index], 0, std::numeric_limits<std::uint32_t>::max(), 0 };
+
+	for (std::uint32_t executedPass{}; executedPass < m_vExecutedPasses.size(); ++executedPass)
+	{
+		Pass const& pass{ m_dPasses[m_vExecutedPasses[executedPass]] };
+		for (std::vector<Access> const* const pAccesses : { &pass.vReads, &pass.vWrites })
+			for (Access const& access : *pAccesses)
+			{
+				std::optional<std::uint32_t> const transientIndex{ m_vResources[access.resource].transientIndex };
+				if (not transientIndex.has_value())
+					continue;
+
+				TransientImage& image{ vImages[transientIndex.value()] };
+				image.usage |= getResourceUsageInfo(access.usage).imageUsage;
+				image.firstPass = std::min(image.firstPass, executedPass);
+				image.lastPass = std::max(image.lastPass, executedPass);
+			}
+	}
+
+	TransientImages& transientImages{ m_vFrameTransientImages.at(frameIndex) };
+	if (transientImages.vImages != vImages)
+		allocateTransientImages(transientImages, std::move(vImages));
+
+	for (Resource& resource : m_vResources)
+		if (resource.transientIndex.has_value() and transientImages.vpImages[resource.transientIndex.value()])
+		{
+			resource.image = transientImages.vpImages[resource.transientIndex.value()].get();
+			resource.imageView = transientImages.vpImageViews[resource.transientIndex.value()].get();
+		}
+
+	m_pTransientImages = &transientImages;
+	planBarriers(transientImages);
+}
+
+void fro::RenderGraph::execute(VkCommandBuffer const commandBuffer) const
+{
+	for (std::size_t executedPass{}; executedPass < m_vExecutedPasses.size(); ++executedPass)
+	{
+		m_vBarrierBatches[executedPass].record(commandBuffer);
+
+		Pass const& pass{ m_dPasses[m_vExecutedPasses[executedPass]] };
+		if (pass.execution)
+			pass.execution(commandBuffer);
+	}
+
+	m_vBarrierBatches.back().record(commandBuffer);
+}
+
+VkImage fro::RenderGraph::getImage(RenderGraphResource const resource) const
+{
+	return m_vResources.at(resource).image;
+}
+
+VkImageView fro::RenderGraph::getImageView(RenderGraphResource const resource) const
+{
+	return m_vResources.at(resource).imageView;
+}
+
+fro::RenderGraphStatistics fro::RenderGraph::getStatistics() const
+{
+	RenderGraphStatistics statistics
+	{
+		.passCount{ m_dPasses.size() },
+		.culledPassCount{ m_dPasses.size() - m_vExecutedPasses.size() },
+		.transientBytes{ m_pTransientImages ? m_pTransientImages->bytes : 0 },
+		.allocatedTransientBytes{ m_pTransientImages ? m_pTransientImages->allocatedBytes : 0 },
+		.lazilyAllocatedTransientBytes{ m_pTransientImages ? m_pTransientImages->lazilyAllocatedBytes : 0 }
+	};
+
+	for (BarrierBuilder const& barrierBatch : m_vBarrierBatches)
+	{
+		std::size_t const barrierCount{ barrierBatch.getBarrierCount() };
+		statistics.barrierCount += barrierCount;
+		statistics.barrierBatchCount += barrierCount > 0;
+	}
+
+	return statistics;
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+bool fro::RenderGraph::TransientImage::operator==(TransientImage const& other) const
+{
+	return
+		description == other.description and
+		usage == other.usage and
+		firstPass == other.firstPass and
+		lastPass == other.lastPass;
+}
+
+void fro::RenderGraph::cullPasses()
+{
+	// walking back from the passes with observable writes, a pass is needed when a needed pass reads what it
+	// writes; a write without a read in the same pass overwrites, so the resource's earlier writers aren't
+	std::vector<bool> vIsResourceNeeded(m_vResources.size());
+	for (std::size_t index{ m_dPasses.size() }; index-- > 0;)
+	{
+		Pass const& pass{ m_dPasses[index] };
+		bool const isNeeded
+		{
+			std::any_of(pass.vWrites.begin(), pass.vWrites.end(),
+				[this, &vIsResourceNeeded](Access const& access)
+				{
+					return not m_vResources[access.resource].transientIndex.has_value() or vIsResourceNeeded[access.resource];
+				})
+		};
+
+		if (not isNeeded)
+			continue;
+
+		m_vExecutedPasses.push_back(static_cast<std::uint32_t>(index));
+
+		for (Access const& access : pass.vWrites)
+			vIsResourceNeeded[access.resource] = false;
+
+		for (Access const& access : pass.vReads)
+			vIsResourceNeeded[access.resource] = true;
+	}
+
+	std::reverse(m_vExecutedPasses.begin(), m_vExecutedPasses.end());
+}
+
+void fro::RenderGraph::allocateTransientImages(TransientImages& transientImages, std::vector<TransientImage> vImages) const
+{
+	// views before images before the memory they're bound to
+	transientImages.vpImageViews.clear();
+	transientImages.vpImages.clear();
+	transientImages.vpMemories.clear();
+
+	transientImages.vImages = std::move(vImages);
+	std::size_t const imageCount{ transientImages.vImages.size() };
+	transientImages.vpImages.resize(imageCount);
+	transientImages.vpImageViews.resize(imageCount);
+	transientImages.vvAliasedImages.assign(imageCount, {});
+	transientImages.bytes = 0;
+	transientImages.allocatedBytes = 0;
+	transientImages.lazilyAllocatedBytes = 0;
+
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &memoryProperties);
+
+	std::vector<VkMemoryRequirements> vMemoryRequirements(imageCount);
+	std::map<std::uint32_t, std::vector<std::uint32_t>> mMemoryTypeImages{};
+	for (std::uint32_t index{}; index < imageCount; ++index)
+	{
+		TransientImage const& transientImage{ transientImages.vImages[index] };
+
+		// declared, but only by culled passes
+		if (transientImage.usage == 0)
+			continue;
+
+		bool const isTransientAttachment{ isAttachmentOnly(transientImage.usage) };
+
+		VkImageCreateInfo const imageCreateInfo
+		{
+			.sType{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO },
+			.imageType{ VK_IMAGE_TYPE_2D },
+			.format{ transientImage.description.format },
+			.extent{ transientImage.description.extent.width, transientImage.description.extent.height, 1 },
+			.mipLevels{ 1 },
+			.arrayLayers{ 1 },
+			.samples{ transientImage.description.samples },
+			.tiling{ VK_IMAGE_TILING_OPTIMAL },
+			.usage{ transientImage.usage | (isTransientAttachment ? static_cast<VkImageUsageFlags>(VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) : 0u) },
+			.sharingMode{ VK_SHARING_MODE_EXCLUSIVE },
+			.initialLayout{ VK_IMAGE_LAYOUT_UNDEFINED }
+		};
+
+		VkImage image;
+		if (vkCreateImage(m_LogicalDevice, &imageCreateInfo, nullptr, &image) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateImage() failed!");
+
+		transientImages.vpImages[index] = { image, std::bind(vkDestroyImage, m_LogicalDevice, std::placeholders::_1, nullptr) };
+
+		vkGetImageMemoryRequirements(m_LogicalDevice, image, &vMemoryRequirements[index]);
+		transientImages.bytes += vMemoryRequirements[index].size;
+
+		std::optional<std::uint32_t> const lazilyAllocatedMemoryType
+		{
+			isTransientAttachment ? findLazilyAllocatedMemoryType(vMemoryRequirements[index].memoryTypeBits, memoryProperties) : std::nullopt
+		};
+
+		std::uint32_t const memoryType
+		{
+			lazilyAllocatedMemoryType.has_value() ?
+			lazilyAllocatedMemoryType.value() :
+			getMemoryType(vMemoryRequirements[index].memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_PhysicalDevice)
+		};
+
+		mMemoryTypeImages[memoryType].push_back(index);
+	}
+
+	// largest first, each at the lowest offset that doesn't overlap an image alive at the same time
+	std::vector<VkDeviceSize> vOffsets(imageCount);
+	for (auto& [memoryType, vMemoryTypeImages] : mMemoryTypeImages)
+	{
+		std::sort(vMemoryTypeImages.begin(), vMemoryTypeImages.end(),
+			[&vMemoryRequirements](std::uint32_t const first, std::uint32_t const second)
+			{
+				return vMemoryRequirements[first].size > vMemoryRequirements[second].size;
+			});
+
+		VkDeviceSize memorySize{};
+		for (std::size_t placed{}; placed < vMemoryTypeImages.size(); ++placed)
+		{
+			std::uint32_t const index{ vMemoryTypeImages[placed] };
+			TransientImage const& image{ transientImages.vImages[index] };
+			VkMemoryRequirements const& memoryRequirements{ vMemoryRequirements[index] };
+
+			std::vector<std::uint32_t> vConcurrentImages{};
+			std::vector<VkDeviceSize> vCandidateOffsets{ 0 };
+			for (std::size_t other{}; other < placed; ++other)
+			{
+				std::uint32_t const otherIndex{ vMemoryTypeImages[other] };
+				TransientImage const& otherImage{ transientImages.vImages[otherIndex] };
+				if (not areLifetimesOverlapping(image.firstPass, image.lastPass, otherImage.firstPass, otherImage.lastPass))
+					continue;
+
+				vConcurrentImages.push_back(otherIndex);
+				VkDeviceSize const end{ vOffsets[otherIndex] + vMemoryRequirements[otherIndex].size };
+				vCandidateOffsets.push_back((end + memoryRequirements.alignment - 1) / memoryRequirements.alignment * memoryRequirements.alignment);
+			}
+
+			std::sort(vCandidateOffsets.begin(), vCandidateOffsets.end());
+			vOffsets[index] = *std::find_if(vCandidateOffsets.begin(), vCandidateOffsets.end(),
+				[&](VkDeviceSize const offset)
+				{
+					return std::none_of(vConcurrentImages.begin(), vConcurrentImages.end(),
+						[&](std::uint32_t const otherIndex)
+						{
+							return offset < vOffsets[otherIndex] + vMemoryRequirements[otherIndex].size and vOffsets[otherIndex] < offset + memoryRequirements.size;
+						});
+				});
+
+			memorySize = std::max(memorySize, vOffsets[index] + memoryRequirements.size);
+
+			for (std::size_t other{}; other < placed; ++other)
+			{
+				std::uint32_t const otherIndex{ vMemoryTypeImages[other] };
+				if (vOffsets[index] < vOffsets[otherIndex] + vMemoryRequirements[otherIndex].size and vOffsets[otherIndex] < vOffsets[index] + memoryRequirements.size and
+					not areLifetimesOverlapping(image.firstPass, image.lastPass, transientImages.vImages[otherIndex].firstPass, transientImages.vImages[otherIndex].lastPass))
+				{
+					// whichever comes first hands the memory over to the other
+					if (transientImages.vImages[otherIndex].lastPass < image.firstPass)
+						transientImages.vvAliasedImages[index].push_back(otherIndex);
+					else
+						transientImages.vvAliasedImages[otherIndex].push_back(index);
+				}
+			}
+		}
+
+		VkMemoryAllocateInfo const allocateInfo
+		{
+			.sType{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO },
+			.allocationSize{ memorySize },
+			.memoryTypeIndex{ memoryType }
+		};
+
+		VkDeviceMemory memory;
+		if (vkAllocateMemory(m_LogicalDevice, &allocateInfo, nullptr, &memory) != VK_SUCCESS)
+			throw std::runtime_error("vkAllocateMemory() failed!");
+
+		transientImages.vpMemories.push_back({ memory, std::bind(vkFreeMemory, m_LogicalDevice, std::placeholders::_1, nullptr) });
+		transientImages.allocatedBytes += memorySize;
+		if (memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+			transientImages.lazilyAllocatedBytes += memorySize;
+
+		for (std::uint32_t const index : vMemoryTypeImages)
+		{
+			if (vkBindImageMemory(m_LogicalDevice, transientImages.vpImages[index].get(), memory, vOffsets[index]) != VK_SUCCESS)
+				throw std::runtime_error("vkBindImageMemory() failed!");
+
+			VkImageViewCreateInfo const viewCreateInfo
+			{
+				.sType{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO },
+				.image{ transientImages.vpImages[index].get() },
+				.viewType{ VK_IMAGE_VIEW_TYPE_2D },
+				.format{ transientImages.vImages[index].description.format },
+				.subresourceRange{ getImageAspect(transientImages.vImages[index].description.format), 0, 1, 0, 1 }
+			};
+
+			VkImageView imageView;
+			if (vkCreateImageView(m_LogicalDevice, &viewCreateInfo, nullptr, &imageView) != VK_SUCCESS)
+				throw std::runtime_error("vkCreateImageView() failed!");
+
+			transientImages.vpImageViews[index] = { imageView, std::bind(vkDestroyImageView, m_LogicalDevice, std::placeholders::_1, nullptr) };
+		}
+	}
+}
+
+void fro::RenderGraph::planBarriers(TransientImages const& transientImages)
+{
+	std::vector<TrackedState> vStates(m_vResources.size());
+	std::vector<bool> vIsTouched(m_vResources.size());
+	for (std::size_t index{}; index < m_vResources.size(); ++index)
+		vStates[index] = { m_vResources[index].initialState.stageMask, m_vResources[index].initialState.accessMask, 0, 0, 0, m_vResources[index].initialState.layout };
+
+	std::vector<RenderGraphResource> vTransientResources(transientImages.vImages.size());
+	for (RenderGraphResource resource{}; resource < m_vResources.size(); ++resource)
+		if (m_vResources[resource].transientIndex.has_value())
+			vTransientResources[m_vResources[resource].transientIndex.value()] = resource;
+
+	auto const addAccess
+	{
+		[&](BarrierBuilder& barrierBatch, RenderGraphResource const resource, ResourceUsageInfo const& usageInfo)
+		{
+			Resource const& graphResource{ m_vResources[resource] };
+			TrackedState& state{ vStates[resource] };
+
+			// a transient image's first use waits for the images it takes the memory over from
+			if (not vIsTouched[resource] and graphResource.transientIndex.has_value())
+				for (std::uint32_t const aliasedImage : transientImages.vvAliasedImages[graphResource.transientIndex.value()])
+				{
+					TrackedState const& aliasedState{ vStates[vTransientResources[aliasedImage]] };
+					state.writeStageMask |= aliasedState.writeStageMask | aliasedState.readStageMask;
+					state.writeAccessMask |= aliasedState.writeAccessMask;
+				}
+
+			vIsTouched[resource] = true;
+
+			bool const isImage{ graphResource.image != VK_NULL_HANDLE };
+			bool const isLayoutChanging{ isImage and state.layout != usageInfo.layout };
+			bool const isVisible
+			{
+				(usageInfo.stageMask & ~state.visibleStageMask) == 0 and
+				(usageInfo.accessMask & ~state.visibleAccessMask) == 0
+			};
+			bool const isHazard
+			{
+				usageInfo.isWrite ?
+				(state.writeStageMask | state.readStageMask) != 0 :
+				state.writeStageMask != 0 and not isVisible
+			};
+
+			if (isLayoutChanging or isHazard)
+			{
+				ResourceState const srcState{ state.writeStageMask | (usageInfo.isWrite or isLayoutChanging ? state.readStageMask : 0), state.writeAccessMask, state.layout };
+				ResourceState const dstState{ usageInfo.stageMask, usageInfo.accessMask, usageInfo.layout };
+
+				if (isImage)
+					barrierBatch.addImageBarrier(graphResource.image, { graphResource.aspectMask, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS }, srcState, dstState);
+				else
+					barrierBatch.addBufferBarrier(graphResource.buffer, srcState, dstState);
+
+				state.visibleStageMask |= usageInfo.stageMask;
+				state.visibleAccessMask |= usageInfo.accessMask;
+
+				// a layout transition is a write of its own, which later reads at other stages have to wait for
+				if (isLayoutChanging and not usageInfo.isWrite)
+				{
+					state.writeStageMask = usageInfo.stageMask;
+					state.writeAccessMask = 0;
+					state.readStageMask = 0;
+				}
+			}
+
+			if (isImage)
+				state.layout = usageInfo.layout;
+
+			if (usageInfo.isWrite)
+			{
+				state.writeStageMask = usageInfo.stageMask;
+				state.writeAccessMask = usageInfo.accessMask & g_WriteAccessMask;
+				state.readStageMask = 0;
+				state.visibleStageMask = 0;
+				state.visibleAccessMask = 0;
+			}
+			else
+				state.readStageMask |= usageInfo.stageMask;
+		}
+	};
+
+	for (std::uint32_t const passIndex : m_vExecutedPasses)
+	{
+		Pass const& pass{ m_dPasses[passIndex] };
+
+		// a resource declared more than once in a pass gets one barrier covering every usage
+		std::map<RenderGraphResource, ResourceUsageInfo> mPassUsages{};
+		for (std::vector<Access> const* const pAccesses : { &pass.vReads, &pass.vWrites })
+			for (Access const& access : *pAccesses)
+			{
+				ResourceUsageInfo const usageInfo{ getResourceUsageInfo(access.usage) };
+				auto const [usage, isInserted] { mPassUsages.try_emplace(access.resource, usageInfo) };
+				if (isInserted)
+					continue;
+
+				if (m_vResources[access.resource].image != VK_NULL_HANDLE and usage->second.layout != usageInfo.layout)
+					throw std::runtime_error(pass.name + " uses an image in two layouts!");
+
+				usage->second.stageMask |= usageInfo.stageMask;
+				usage->second.accessMask |= usageInfo.accessMask;
+				usage->second.isWrite = usage->second.isWrite or usageInfo.isWrite;
+			}
+
+		BarrierBuilder& barrierBatch{ m_vBarrierBatches.emplace_back() };
+		for (auto const& [resource, usageInfo] : mPassUsages)
+			addAccess(barrierBatch, resource, usageInfo);
+	}
+
+	BarrierBuilder& finalBarrierBatch{ m_vBarrierBatches.emplace_back() };
+	for (RenderGraphResource resource{}; resource < m_vResources.size(); ++resource)
+		if (m_vResources[resource].finalUsage.has_value())
+			addAccess(finalBarrierBatch, resource, getResourceUsageInfo(m_vResources[resource].finalUsage.value()));
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
@@ -0,0 +1,183 @@
+#if not defined fro_RENDER_GRAPH_H
+#define fro_RENDER_GRAPH_H
+
+#include "BarrierBuilder.h"
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fro
+{
+	struct TransientImageDescription final
+	{
+		VkFormat format;
+		VkExtent2D extent;
+		VkSampleCountFlagBits samples;
+
+		bool operator==(TransientImageDescription const& other) const;
+	};
+
+	struct RenderGraphStatistics final
+	{
+		std::size_t passCount;
+		std::size_t culledPassCount;
+		std::size_t barrierCount;
+		std::size_t barrierBatchCount;
+		// what the transient images would take on their own, and what they take aliased
+		VkDeviceSize transientBytes;
+		VkDeviceSize allocatedTransientBytes;
+		// the part of it in lazily allocated memory, which tile based GPUs only back when they have to
+		VkDeviceSize lazilyAllocatedTransientBytes;
+	};
+
+	using RenderGraphResource = std::uint32_t;
+
+	// a frame's passes in submission order, each declaring the resources it reads and writes. Compiling culls
+	// the passes nothing observable depends on, derives one batched pipeline barrier per pass from the
+	// declared usages, and places transient images whose lifetimes don't overlap in the same memory. Transient
+	// images only ever used as attachments go in lazily allocated memory where there is any. The
+	// graph is rebuilt every frame; transient images stay allocated as long as a frame declares the same ones
+	class RenderGraph final
+	{
+		struct Pass;
+
+	public:
+		class PassBuilder final
+		{
+		public:
+			PassBuilder& read(RenderGraphResource const resource, ResourceUsage const usage);
+			PassBuilder& write(RenderGraphResource const resource, ResourceUsage const usage);
+
+			// recorded outside of any render pass, after the pass's barriers
+			PassBuilder& execute(std::function<void(VkCommandBuffer)> execution);
+
+		private:
+			friend RenderGraph;
+
+			explicit PassBuilder(Pass& pass);
+
+			Pass& m_Pass;
+		};
+
+		RenderGraph(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, std::uint32_t const framesInFlight);
+
+		~RenderGraph() = default;
+
+		// forgets the previous frame's passes and resources, but not the transient images' memory
+		void reset();
+
+		// writing an imported resource keeps the pass from being culled; the resource ends up in finalUsage's
+		// state, or wherever its last pass left it
+		[[nodiscard("imported render graph image ignored!")]]
+		RenderGraphResource importImage(VkImage const image, VkImageAspectFlags const aspectMask, ResourceState const& initialState, std::optional<ResourceUsage> const finalUsage);
+
+		[[nodiscard("imported render graph buffer ignored!")]]
+		RenderGraphResource importBuffer(VkBuffer const buffer, ResourceState const& initialState, std::optional<ResourceUsage> const finalUsage);
+
+		// an image that lives only within the frame, with its usage flags gathered from what the passes declare
+		[[nodiscard("transient render graph image ignored!")]]
+		RenderGraphResource createImage(TransientImageDescription const& description);
+
+		[[nodiscard("render graph pass builder ignored!")]]
+		PassBuilder addPass(std::string_view const name);
+
+		// frameIndex picks the frame in flight's transient images, which its fence wait has to have freed up
+		void compile(std::uint32_t const frameIndex);
+
+		void execute(VkCommandBuffer const commandBuffer) const;
+
+		// valid after compile()
+		[[nodiscard("render graph image ignored!")]]
+		VkImage getImage(RenderGraphResource const resource) const;
+
+		[[nodiscard("render graph image view ignored!")]]
+		VkImageView getImageView(RenderGraphResource const resource) const;
+
+		[[nodiscard("render graph statistics ignored!")]]
+		RenderGraphStatistics getStatistics() const;
+
+	private:
+		struct Access final
+		{
+			RenderGraphResource resource;
+			ResourceUsage usage;
+		};
+
+		struct Pass final
+		{
+			std::string name;
+			std::vector<Access> vReads;
+			std::vector<Access> vWrites;
+			std::function<void(VkCommandBuffer)> execution;
+		};
+
+		struct Resource final
+		{
+			VkImage image;
+			VkImageView imageView;
+			VkBuffer buffer;
+			VkImageAspectFlags aspectMask;
+			ResourceState initialState;
+			std::optional<ResourceUsage> finalUsage;
+			// the index into the transient images, none for imported resources
+			std::optional<std::uint32_t> transientIndex;
+		};
+
+		struct TransientImage final
+		{
+			TransientImageDescription description;
+			VkImageUsageFlags usage;
+			std::uint32_t firstPass;
+			std::uint32_t lastPass;
+
+			bool operator==(TransientImage const& other) const;
+		};
+
+		struct TransientImages final
+		{
+			std::vector<TransientImage> vImages;
+			std::vector<UniquePointer<VkDeviceMemory_T>> vpMemories;
+			std::vector<UniquePointer<VkImage_T>> vpImages;
+			std::vector<UniquePointer<VkImageView_T>> vpImageViews;
+			// the transient images whose memory each one reuses, all of them done by the time it's first used
+			std::vector<std::vector<std::uint32_t>> vvAliasedImages;
+			VkDeviceSize bytes;
+			VkDeviceSize allocatedBytes;
+			VkDeviceSize lazilyAllocatedBytes;
+		};
+
+		RenderGraph(RenderGraph const&) = delete;
+		RenderGraph(RenderGraph&&) noexcept = delete;
+
+		RenderGraph& operator=(RenderGraph const&) = delete;
+		RenderGraph& operator=(RenderGraph&&) noexcept = delete;
+
+		void cullPasses();
+		void allocateTransientImages(TransientImages& transientImages, std::vector<TransientImage> vImages) const;
+		void planBarriers(TransientImages const& transientImages);
+
+		VkDevice const m_LogicalDevice;
+		VkPhysicalDevice const m_PhysicalDevice;
+
+		std::deque<Pass> m_dPasses{};
+		std::vector<Resource> m_vResources{};
+		std::vector<TransientImageDescription> m_vTransientDescriptions{};
+		std::vector<TransientImages> m_vFrameTransientImages;
+
+		// filled by compile()
+		std::vector<std::uint32_t> m_vExecutedPasses{};
+		// one before each executed pass, and a last one for the imported resources' final states
+		std::vector<BarrierBuilder> m_vBarrierBatches{};
+		TransientImages const* m_pTransientImages{};
+	};
+}
+
+#endif
\ No newline at end of file
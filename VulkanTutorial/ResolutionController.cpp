@@ -0,0 +1,62 @@
+#include "ResolutionController.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+	// how much of each new measurement goes into the smoothed frame time
+	double constexpr g_FrameTimeSmoothing{ 0.1 };
+}
+
+#pragma region Constructors/Destructor
+fro::ResolutionController::ResolutionController(ResolutionControllerSettings const& settings):
+	m_Settings{ settings },
+	m_Scale{ settings.maxScale }
+{
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+void fro::ResolutionController::update(double const frameTime)
+{
+	m_SmoothedFrameTime = m_SmoothedFrameTime == 0.0 ? frameTime : std::lerp(m_SmoothedFrameTime, frameTime, g_FrameTimeSmoothing);
+
+	// holding still close to the target keeps noise in the measurements from resizing the scene every frame
+	if (m_SmoothedFrameTime <= 0.0 or std::abs(m_SmoothedFrameTime - m_Settings.targetFrameTime) <= m_Settings.targetFrameTime * m_Settings.tolerance)
+		return;
+
+	float const targetScale{ m_Scale * static_cast<float>(std::sqrt(m_Settings.targetFrameTime / m_SmoothedFrameTime)) };
+	float const scaleStep{ std::clamp(targetScale - m_Scale, -m_Settings.maxScaleStep, m_Settings.maxScaleStep) };
+
+	m_Scale = std::clamp(m_Scale + scaleStep, m_Settings.minScale, m_Settings.maxScale);
+}
+
+void fro::ResolutionController::reset()
+{
+	m_Scale = m_Settings.maxScale;
+	m_SmoothedFrameTime = 0.0;
+}
+
+float fro::ResolutionController::getScale() const
+{
+	return m_Scale;
+}
+
+VkExtent2D fro::ResolutionController::getRenderExtent(VkExtent2D const outputExtent) const
+{
+	return
+	{
+		std::max(static_cast<std::uint32_t>(std::lround(static_cast<float>(outputExtent.width) * m_Scale)), 1u),
+		std::max(static_cast<std::uint32_t>(std::lround(static_cast<float>(outputExtent.height) * m_Scale)), 1u)
+	};
+}
+
+double fro::ResolutionController::getSmoothedFrameTime() const
+{
+	return m_SmoothedFrameTime;
+}
+#pragma endregion PublicMethods
\ No newline at end of file
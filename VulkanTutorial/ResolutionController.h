@@ -0,0 +1,61 @@
+#if not defined fro_RESOLUTION_CONTROLLER_H
+#define fro_RESOLUTION_CONTROLLER_H
+
+#include <Vulkan/vulkan_core.h>
+
+namespace fro
+{
+	struct ResolutionControllerSettings final
+	{
+		// in milliseconds of GPU time
+		double targetFrameTime;
+		// per axis, as a fraction of the output extent
+		float minScale;
+		float maxScale;
+		// how far the smoothed frame time may stray from the target, as a fraction of it, before the scale moves
+		double tolerance;
+		// the most the scale moves per frame, so a single slow frame can't drop the resolution all at once
+		float maxScaleStep;
+	};
+
+	// picks the fraction of the output extent the scene renders at from measured GPU frame times. GPU time is
+	// taken to grow with the rendered pixel count, the square of the scale, so the scale that would hit the
+	// target is the current one times the square root of the target over the smoothed frame time
+	class ResolutionController final
+	{
+	public:
+		explicit ResolutionController(ResolutionControllerSettings const& settings);
+
+		~ResolutionController() = default;
+
+		void update(double const frameTime);
+
+		// forgets the measured frame times and goes back to the largest scale
+		void reset();
+
+		[[nodiscard("render scale ignored!")]]
+		float getScale() const;
+
+		// outputExtent scaled, at least one pixel on either axis
+		[[nodiscard("render extent ignored!")]]
+		VkExtent2D getRenderExtent(VkExtent2D const outputExtent) const;
+
+		[[nodiscard("smoothed frame time ignored!")]]
+		double getSmoothedFrameTime() const;
+
+	private:
+		ResolutionController(ResolutionController const&) = delete;
+		ResolutionController(ResolutionController&&) noexcept = delete;
+
+		ResolutionController& operator=(ResolutionController const&) = delete;
+		ResolutionController& operator=(ResolutionController&&) noexcept = delete;
+
+		ResolutionControllerSettings const m_Settings;
+
+		float m_Scale;
+		// zero until the first measurement
+		double m_SmoothedFrameTime{};
+	};
+}
+
+#endif
\ No newline at end of file
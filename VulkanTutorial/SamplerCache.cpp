@@ -0,0 +1,172 @@
+#include "SamplerCache.h"
+
+#include "Hashing.hpp"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace
+{
+	VkPhysicalDeviceLimits getLimits(VkPhysicalDevice const physicalDevice)
+	{
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+		return properties.limits;
+	}
+
+	fro::SamplerQuality clampQuality(fro::SamplerQuality const quality, VkPhysicalDeviceLimits const& limits)
+	{
+		return
+		{
+			.maxAnisotropy{ std::clamp(quality.maxAnisotropy, 1.0f, limits.maxSamplerAnisotropy) },
+			.mipLodBias{ std::clamp(quality.mipLodBias, -limits.maxSamplerLodBias, limits.maxSamplerLodBias) }
+		};
+	}
+
+	bool isBorderColorUsed(VkSamplerCreateInfo const& createInfo)
+	{
+		return
+			createInfo.addressModeU == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER or
+			createInfo.addressModeV == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER or
+			createInfo.addressModeW == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+	}
+
+	// zeroes out whatever the sampler won't use, so that it can't make otherwise identical samplers differ
+	VkSamplerCreateInfo normalize(VkSamplerCreateInfo createInfo)
+	{
+		if (not createInfo.anisotropyEnable)
+			createInfo.maxAnisotropy = 1.0f;
+
+		if (not createInfo.compareEnable)
+			createInfo.compareOp = VK_COMPARE_OP_NEVER;
+
+		if (not isBorderColorUsed(createInfo))
+			createInfo.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+
+		return createInfo;
+	}
+}
+
+#pragma region Constructors/Destructor
+fro::SamplerCache::SamplerCache(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, SamplerQuality const quality)
+	: m_LogicalDevice{ logicalDevice }
+	, m_Limits{ getLimits(physicalDevice) }
+	, m_Quality{ clampQuality(quality, m_Limits) }
+{
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+VkSampler fro::SamplerCache::getSampler(VkSamplerCreateInfo const& createInfo)
+{
+	if (createInfo.pNext)
+		throw std::runtime_error("samplers with extension structures can't be cached!");
+
+	SamplerKey const key{ normalize(createInfo) };
+
+	auto samplerIterator{ m_umSamplers.find(key) };
+	if (samplerIterator == m_umSamplers.end())
+	{
+		if (m_umSamplers.size() == m_Limits.maxSamplerAllocationCount)
+			throw std::runtime_error(std::format("all {} samplers the device allows are in use!", m_Limits.maxSamplerAllocationCount));
+
+		VkSampler sampler;
+		if (vkCreateSampler(m_LogicalDevice, &key.createInfo, nullptr, &sampler) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateSampler() failed!");
+
+		samplerIterator = m_umSamplers.emplace(key, UniquePointer<VkSampler_T>{ sampler, std::bind(vkDestroySampler, m_LogicalDevice, std::placeholders::_1, nullptr) }).first;
+	}
+
+	return samplerIterator->second.get();
+}
+
+VkSamplerCreateInfo fro::SamplerCache::applyQuality(VkSamplerCreateInfo const& createInfo) const
+{
+	VkSamplerCreateInfo qualityCreateInfo{ createInfo };
+	qualityCreateInfo.anisotropyEnable = createInfo.anisotropyEnable and m_Quality.maxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+	qualityCreateInfo.maxAnisotropy = m_Quality.maxAnisotropy;
+	qualityCreateInfo.mipLodBias = std::clamp(createInfo.mipLodBias + m_Quality.mipLodBias, -m_Limits.maxSamplerLodBias, m_Limits.maxSamplerLodBias);
+
+	return qualityCreateInfo;
+}
+
+void fro::SamplerCache::setQuality(SamplerQuality const quality)
+{
+	SamplerQuality const clampedQuality{ clampQuality(quality, m_Limits) };
+
+	if (clampedQuality.maxAnisotropy == m_Quality.maxAnisotropy and clampedQuality.mipLodBias == m_Quality.mipLodBias)
+		return;
+
+	m_Quality = clampedQuality;
+	++m_QualityVersion;
+}
+
+fro::SamplerQuality fro::SamplerCache::getQuality() const
+{
+	return m_Quality;
+}
+
+std::uint64_t fro::SamplerCache::getQualityVersion() const
+{
+	return m_QualityVersion;
+}
+
+std::size_t fro::SamplerCache::getSamplerCount() const
+{
+	return m_umSamplers.size();
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+bool fro::SamplerCache::SamplerKey::operator==(SamplerKey const& other) const
+{
+	return
+		createInfo.flags == other.createInfo.flags and
+		createInfo.magFilter == other.createInfo.magFilter and
+		createInfo.minFilter == other.createInfo.minFilter and
+		createInfo.mipmapMode == other.createInfo.mipmapMode and
+		createInfo.addressModeU == other.createInfo.addressModeU and
+		createInfo.addressModeV == other.createInfo.addressModeV and
+		createInfo.addressModeW == other.createInfo.addressModeW and
+		createInfo.mipLodBias == other.createInfo.mipLodBias and
+		createInfo.anisotropyEnable == other.createInfo.anisotropyEnable and
+		createInfo.maxAnisotropy == other.createInfo.maxAnisotropy and
+		createInfo.compareEnable == other.createInfo.compareEnable and
+		createInfo.compareOp == other.createInfo.compareOp and
+		createInfo.minLod == other.createInfo.minLod and
+		createInfo.maxLod == other.createInfo.maxLod and
+		createInfo.borderColor == other.createInfo.borderColor and
+		createInfo.unnormalizedCoordinates == other.createInfo.unnormalizedCoordinates;
+}
+
+std::size_t fro::SamplerCache::KeyHasher::operator()(SamplerKey const& key) const
+{
+	VkSamplerCreateInfo const& createInfo{ key.createInfo };
+
+	std::size_t seed{};
+	hashCombine(seed, createInfo.flags);
+	hashCombine(seed, createInfo.magFilter);
+	hashCombine(seed, createInfo.minFilter);
+	hashCombine(seed, createInfo.mipmapMode);
+	hashCombine(seed, createInfo.addressModeU);
+	hashCombine(seed, createInfo.addressModeV);
+	hashCombine(seed, createInfo.addressModeW);
+	hashCombine(seed, createInfo.mipLodBias);
+	hashCombine(seed, createInfo.anisotropyEnable);
+	hashCombine(seed, createInfo.maxAnisotropy);
+	hashCombine(seed, createInfo.compareEnable);
+	hashCombine(seed, createInfo.compareOp);
+	hashCombine(seed, createInfo.minLod);
+	hashCombine(seed, createInfo.maxLod);
+	hashCombine(seed, createInfo.borderColor);
+	hashCombine(seed, createInfo.unnormalizedCoordinates);
+
+	return seed;
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
@@ -0,0 +1,81 @@
+#if not defined fro_SAMPLER_CACHE_H
+#define fro_SAMPLER_CACHE_H
+
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <unordered_map>
+
+namespace fro
+{
+	// the global filtering quality that applyQuality() folds into a sampler description
+	struct SamplerQuality final
+	{
+		// 1 turns anisotropic filtering off
+		float maxAnisotropy;
+		// added to the sampler's own bias; positive values pick coarser levels
+		float mipLodBias;
+	};
+
+	// owns every sampler created through it, and hands out the same handle for descriptions that sample
+	// identically; devices can have as few as 4000 samplers in total, so materials share them through here
+	class SamplerCache final
+	{
+	public:
+		SamplerCache(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, SamplerQuality const quality);
+
+		~SamplerCache() = default;
+
+		// state the description leaves unused (anisotropy, compare op or border color when they're disabled)
+		// doesn't tell samplers apart; extension structures can't be cached
+		[[nodiscard("cached sampler ignored!")]]
+		VkSampler getSampler(VkSamplerCreateInfo const& createInfo);
+
+		// the description with the current quality applied, for samplers that should follow the global setting;
+		// anisotropy only applies to descriptions that enable it
+		[[nodiscard("sampler description ignored!")]]
+		VkSamplerCreateInfo applyQuality(VkSamplerCreateInfo const& createInfo) const;
+
+		// clamped to the device's limits; samplers handed out before stay valid, users pick up the new ones
+		// by calling applyQuality() and getSampler() again when the quality version changes
+		void setQuality(SamplerQuality const quality);
+
+		[[nodiscard("sampler quality ignored!")]]
+		SamplerQuality getQuality() const;
+
+		[[nodiscard("sampler quality version ignored!")]]
+		std::uint64_t getQualityVersion() const;
+
+		[[nodiscard("sampler count ignored!")]]
+		std::size_t getSamplerCount() const;
+
+	private:
+		struct SamplerKey final
+		{
+			VkSamplerCreateInfo createInfo;
+
+			bool operator==(SamplerKey const& other) const;
+		};
+
+		struct KeyHasher final
+		{
+			std::size_t operator()(SamplerKey const& key) const;
+		};
+
+		SamplerCache(SamplerCache const&) = delete;
+		SamplerCache(SamplerCache&&) noexcept = delete;
+
+		SamplerCache& operator=(SamplerCache const&) = delete;
+		SamplerCache& operator=(SamplerCache&&) noexcept = delete;
+
+		VkDevice const m_LogicalDevice;
+		VkPhysicalDeviceLimits const m_Limits;
+
+		SamplerQuality m_Quality;
+		std::uint64_t m_QualityVersion{};
+		std::unordered_map<SamplerKey, UniquePointer<VkSampler_T>, KeyHasher> m_umSamplers{};
+	};
+}
+
+#endif
\ No newline at end of file
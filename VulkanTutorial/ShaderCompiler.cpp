@@ -1,5 +1,7 @@
 #include "ShaderCompiler.h"
 
+#include "ShaderVariants.h"
+
 #include <string>
 #include <filesystem>
 #include <fstream>
@@ -9,18 +11,55 @@
 #include <stdexcept>
 #include <format>
 #include <regex>
+#include <mutex>
+
+#include <spirv-tools/optimizer.hpp>
+
+namespace
+{
+	struct StatisticsLog final
+	{
+		std::mutex mutex{};
+		std::vector<fro::ShaderStatistics> vStatistics{};
+	};
+
+	// shared by every compiler, which can be compiling on different threads
+	StatisticsLog& getStatisticsLog()
+	{
+		static StatisticsLog statisticsLog{};
+		return statisticsLog;
+	}
+
+	fro::SpirvSize getSpirvSize(std::vector<std::uint32_t> const& vBytecode)
+	{
+		// past the 5 word header, every instruction starts with a word holding its word count in the upper 16 bits
+		std::size_t instructionCount{};
+		for (std::size_t wordIndex{ 5 }; wordIndex < vBytecode.size(); wordIndex += vBytecode[wordIndex] >> 16)
+		{
+			if ((vBytecode[wordIndex] >> 16) == 0)
+				throw std::runtime_error("SPIR-V instruction without words!");
+
+			++instructionCount;
+		}
+
+		return { vBytecode.size() * sizeof(std::uint32_t), instructionCount };
+	}
+}
 
 #pragma region Constructors/Destructor
-fro::ShaderCompiler::ShaderCompiler(std::string_view shadersDirectory)
+fro::ShaderCompiler::ShaderCompiler(std::string_view shadersDirectory, ShaderCompileProfile const profile)
 	: m_ShadersDirectory{ shadersDirectory }
+	, m_Profile{ profile }
 {
+	if (m_Profile == ShaderCompileProfile::Release)
+		m_vOptimizerFlags = { "--strip-nonsemantic", "--remove-duplicates", "--compact-ids" };
 }
 #pragma endregion Constructors/Destructor
 
 
 
 #pragma region Operators
-std::vector<std::uint32_t> fro::ShaderCompiler::operator()(std::string_view shaderFileName, shaderc_shader_kind shaderKind)
+std::vector<std::uint32_t> fro::ShaderCompiler::operator()(std::string_view shaderFileName, shaderc_shader_kind shaderKind, std::vector<std::string_view> const& vMacroNames)
 {
 	std::string const fullFileDirectory{ std::format("{}/{}", m_ShadersDirectory, shaderFileName) };
 
@@ -40,18 +79,41 @@ std::vector<std::uint32_t> fro::ShaderCompiler::operator()(std::string_view shad
 		vShaderSourceCodeLines.emplace_back(lineSourceCode + "\n");
 	}
 
+	shaderc::CompileOptions options{};
+	options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+	if (m_Profile == ShaderCompileProfile::Debug)
+	{
+		options.SetOptimizationLevel(shaderc_optimization_level_zero);
+		options.SetGenerateDebugInfo();
+	}
+	else
+		options.SetOptimizationLevel(shaderc_optimization_level_performance);
+
+	for (std::string_view const macroName : vMacroNames)
+		options.AddMacroDefinition(macroName.data(), macroName.size(), nullptr, 0);
+
 	shaderc::SpvCompilationResult const shaderResult
 	{
 		m_Compiler.CompileGlslToSpv
 		(
 			std::reduce(vShaderSourceCodeLines.begin(), vShaderSourceCodeLines.end()),
 			shaderKind,
-			shaderFileName.data()
+			shaderFileName.data(),
+			options
 		)
 	};
 
 	if (shaderResult.GetCompilationStatus() == shaderc_compilation_status_success)
-		return { shaderResult.begin(), shaderResult.end() };
+	{
+		std::vector<std::uint32_t> const vBytecode{ shaderResult.begin(), shaderResult.end() };
+		std::vector<std::uint32_t> vOptimizedBytecode{ optimize(vBytecode) };
+
+		StatisticsLog& statisticsLog{ getStatisticsLog() };
+		std::lock_guard const lock{ statisticsLog.mutex };
+		statisticsLog.vStatistics.push_back({ getShaderVariantName(shaderFileName, vMacroNames), m_Profile, getSpirvSize(vBytecode), getSpirvSize(vOptimizedBytecode) });
+
+		return vOptimizedBytecode;
+	}
 
 	std::string const errorMessage{ shaderResult.GetErrorMessage() };
 	std::smatch lineErrorMatch;
@@ -89,4 +151,36 @@ void fro::ShaderCompiler::setShadersDirectory(std::string_view shadersDirectory)
 {
 	m_ShadersDirectory = shadersDirectory;
 }
-#pragma endregion PublicMethods
\ No newline at end of file
+
+void fro::ShaderCompiler::setOptimizerFlags(std::vector<std::string> vOptimizerFlags)
+{
+	m_vOptimizerFlags = std::move(vOptimizerFlags);
+}
+
+std::vector<fro::ShaderStatistics> fro::ShaderCompiler::getStatistics()
+{
+	StatisticsLog& statisticsLog{ getStatisticsLog() };
+	std::lock_guard const lock{ statisticsLog.mutex };
+	return statisticsLog.vStatistics;
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+std::vector<std::uint32_t> fro::ShaderCompiler::optimize(std::vector<std::uint32_t> const& vBytecode) const
+{
+	if (m_vOptimizerFlags.empty())
+		return vBytecode;
+
+	spvtools::Optimizer optimizer{ SPV_ENV_VULKAN_1_3 };
+	if (not optimizer.RegisterPassesFromFlags(m_vOptimizerFlags))
+		throw std::runtime_error("spvtools::Optimizer::RegisterPassesFromFlags() failed!");
+
+	std::vector<std::uint32_t> vOptimizedBytecode{};
+	if (not optimizer.Run(vBytecode.data(), vBytecode.size(), &vOptimizedBytecode))
+		throw std::runtime_error("spvtools::Optimizer::Run() failed!");
+
+	return vOptimizedBytecode;
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
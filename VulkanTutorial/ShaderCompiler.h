@@ -1,14 +1,50 @@
 #pragma once
 
 #include <shaderc/shaderc.hpp>
+#include <string>
+#include <vector>
 #include <xstring>
 
 namespace fro
 {
+	enum class ShaderCompileProfile
+	{
+		// unoptimized, with debug info for shader debuggers
+		Debug,
+		// optimized for performance and stripped of debug info, followed by the extra spirv-opt passes
+		Release
+	};
+
+	ShaderCompileProfile constexpr g_DefaultShaderCompileProfile
+	{
+#if defined NDEBUG
+		ShaderCompileProfile::Release
+#else
+		ShaderCompileProfile::Debug
+#endif
+	};
+
+	struct SpirvSize final
+	{
+		std::size_t byteSize;
+		std::size_t instructionCount;
+	};
+
+	struct ShaderStatistics final
+	{
+		// as getShaderVariantName() names it
+		std::string name;
+		ShaderCompileProfile profile;
+		// straight out of the compiler, and after the extra spirv-opt passes, if any ran
+		SpirvSize compiledSize;
+		SpirvSize optimizedSize;
+	};
+
 	class ShaderCompiler final
 	{
 	public:
-		ShaderCompiler(std::string_view shadersDirectory);
+		// both profiles target Vulkan 1.3, which pickSuitedPhysicalDevice() requires anyway
+		ShaderCompiler(std::string_view shadersDirectory, ShaderCompileProfile const profile = g_DefaultShaderCompileProfile);
 		ShaderCompiler(const ShaderCompiler&) = default;
 		ShaderCompiler(ShaderCompiler&&) noexcept = default;
 
@@ -17,13 +53,27 @@ namespace fro
 		ShaderCompiler& operator=(const ShaderCompiler&) = default;
 		ShaderCompiler& operator=(ShaderCompiler&&) noexcept = default;
 
+		// every name in vMacroNames gets defined, without a value
 		[[nodiscard("compiled shader bytecode ignored!")]]
-		std::vector<std::uint32_t> operator()(std::string_view shaderFileName, shaderc_shader_kind shaderKind);
+		std::vector<std::uint32_t> operator()(std::string_view shaderFileName, shaderc_shader_kind shaderKind, std::vector<std::string_view> const& vMacroNames = {});
 
 		void setShadersDirectory(std::string_view shadersDirectory);
 
+		// spirv-opt command line flags, run after the compiler's own passes; none skips spirv-opt. The release
+		// profile starts out with passes that shrink the module without changing what it executes
+		void setOptimizerFlags(std::vector<std::string> vOptimizerFlags);
+
+		// every shader compiled so far, by any compiler
+		[[nodiscard("shader statistics ignored!")]]
+		static std::vector<ShaderStatistics> getStatistics();
+
 	private:
+		[[nodiscard("optimized shader bytecode ignored!")]]
+		std::vector<std::uint32_t> optimize(std::vector<std::uint32_t> const& vBytecode) const;
+
 		shaderc::Compiler m_Compiler{};
 		std::string_view m_ShadersDirectory;
+		ShaderCompileProfile m_Profile;
+		std::vector<std::string> m_vOptimizerFlags;
 	};
 }
\ No newline at end of file
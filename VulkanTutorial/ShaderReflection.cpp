@@ -0,0 +1,400 @@
+#include "ShaderReflection.h"
+
+#include <spirv-headers/spirv.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <format>
+#include <optional>
+#include <unordered_map>
+
+namespace
+{
+	struct SpirvDecorations final
+	{
+		std::optional<std::uint32_t> descriptorSet{};
+		std::optional<std::uint32_t> binding{};
+		std::optional<std::uint32_t> arrayStride{};
+		bool isBlock{};
+		bool isBufferBlock{};
+		std::unordered_map<std::uint32_t, std::uint32_t> umMemberOffsets{};
+		std::unordered_map<std::uint32_t, std::uint32_t> umMemberMatrixStrides{};
+	};
+
+	struct SpirvInstruction final
+	{
+		spv::Op opcode{};
+		std::vector<std::uint32_t> vOperands{};
+	};
+
+	struct SpirvModule final
+	{
+		std::unordered_map<std::uint32_t, SpirvInstruction> umTypes{};
+		std::unordered_map<std::uint32_t, std::uint32_t> umConstants{};
+		std::unordered_map<std::uint32_t, SpirvDecorations> umDecorations{};
+		std::vector<std::pair<std::uint32_t, SpirvInstruction>> vVariables{};
+	};
+
+	SpirvModule parseSpirvModule(std::vector<std::uint32_t> const& vBytecode)
+	{
+		std::size_t constexpr headerWordCount{ 5 };
+		if (vBytecode.size() < headerWordCount or vBytecode[0] != spv::MagicNumber)
+			throw std::runtime_error("bytecode is not a SPIR-V module!");
+
+		SpirvModule spirvModule{};
+		for (std::size_t wordIndex{ headerWordCount }; wordIndex < vBytecode.size();)
+		{
+			std::uint32_t const wordCount{ vBytecode[wordIndex] >> spv::WordCountShift };
+			auto const opcode{ static_cast<spv::Op>(vBytecode[wordIndex] & spv::OpCodeMask) };
+
+			if (wordCount == 0 or wordIndex + wordCount > vBytecode.size())
+				throw std::runtime_error("SPIR-V module is malformed!");
+
+			std::vector<std::uint32_t> const vOperands{ vBytecode.begin() + wordIndex + 1, vBytecode.begin() + wordIndex + wordCount };
+			wordIndex += wordCount;
+
+			switch (opcode)
+			{
+			case spv::OpDecorate:
+			{
+				SpirvDecorations& decorations{ spirvModule.umDecorations[vOperands[0]] };
+				switch (static_cast<spv::Decoration>(vOperands[1]))
+				{
+				case spv::DecorationDescriptorSet:
+					decorations.descriptorSet = vOperands[2];
+					break;
+
+				case spv::DecorationBinding:
+					decorations.binding = vOperands[2];
+					break;
+
+				case spv::DecorationArrayStride:
+					decorations.arrayStride = vOperands[2];
+					break;
+
+				case spv::DecorationBlock:
+					decorations.isBlock = true;
+					break;
+
+				case spv::DecorationBufferBlock:
+					decorations.isBufferBlock = true;
+					break;
+
+				default:
+					break;
+				}
+				break;
+			}
+
+			case spv::OpMemberDecorate:
+			{
+				SpirvDecorations& decorations{ spirvModule.umDecorations[vOperands[0]] };
+				if (static_cast<spv::Decoration>(vOperands[2]) == spv::DecorationOffset)
+					decorations.umMemberOffsets[vOperands[1]] = vOperands[3];
+				else if (static_cast<spv::Decoration>(vOperands[2]) == spv::DecorationMatrixStride)
+					decorations.umMemberMatrixStrides[vOperands[1]] = vOperands[3];
+				break;
+			}
+
+			case spv::OpTypeBool:
+			case spv::OpTypeInt:
+			case spv::OpTypeFloat:
+			case spv::OpTypeVector:
+			case spv::OpTypeMatrix:
+			case spv::OpTypeImage:
+			case spv::OpTypeSampler:
+			case spv::OpTypeSampledImage:
+			case spv::OpTypeArray:
+			case spv::OpTypeRuntimeArray:
+			case spv::OpTypeStruct:
+			case spv::OpTypePointer:
+			case spv::OpTypeAccelerationStructureKHR:
+				spirvModule.umTypes[vOperands[0]] = { opcode, { vOperands.begin() + 1, vOperands.end() } };
+				break;
+
+			case spv::OpConstant:
+			case spv::OpSpecConstant:
+				spirvModule.umConstants[vOperands[1]] = vOperands[2];
+				break;
+
+			case spv::OpVariable:
+				spirvModule.vVariables.push_back({ vOperands[1], { opcode, { vOperands[0], vOperands[2] } } });
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		return spirvModule;
+	}
+
+	SpirvInstruction const& getType(SpirvModule const& spirvModule, std::uint32_t const typeId)
+	{
+		auto const typeIterator{ spirvModule.umTypes.find(typeId) };
+		if (typeIterator == spirvModule.umTypes.end())
+			throw std::runtime_error(std::format("SPIR-V type %{} is not declared!", typeId));
+
+		return typeIterator->second;
+	}
+
+	SpirvDecorations const& getDecorations(SpirvModule const& spirvModule, std::uint32_t const id)
+	{
+		static SpirvDecorations const noDecorations{};
+
+		auto const decorationsIterator{ spirvModule.umDecorations.find(id) };
+		return decorationsIterator == spirvModule.umDecorations.end() ? noDecorations : decorationsIterator->second;
+	}
+
+	std::uint32_t getTypeSize(SpirvModule const& spirvModule, std::uint32_t const typeId, std::optional<std::uint32_t> const matrixStride = {})
+	{
+		SpirvInstruction const& type{ getType(spirvModule, typeId) };
+
+		switch (type.opcode)
+		{
+		case spv::OpTypeBool:
+			return 4;
+
+		case spv::OpTypeInt:
+		case spv::OpTypeFloat:
+			return type.vOperands[0] / 8;
+
+		case spv::OpTypeVector:
+			return getTypeSize(spirvModule, type.vOperands[0]) * type.vOperands[1];
+
+		case spv::OpTypeMatrix:
+			return matrixStride.value_or(getTypeSize(spirvModule, type.vOperands[0])) * type.vOperands[1];
+
+		case spv::OpTypeArray:
+		{
+			std::uint32_t const elementCount{ spirvModule.umConstants.at(type.vOperands[1]) };
+			std::optional<std::uint32_t> const arrayStride{ getDecorations(spirvModule, typeId).arrayStride };
+
+			return arrayStride.value_or(getTypeSize(spirvModule, type.vOperands[0], matrixStride)) * elementCount;
+		}
+
+		case spv::OpTypeStruct:
+		{
+			SpirvDecorations const& decorations{ getDecorations(spirvModule, typeId) };
+
+			std::uint32_t size{};
+			for (std::uint32_t memberIndex{}; memberIndex < type.vOperands.size(); ++memberIndex)
+			{
+				auto const offsetIterator{ decorations.umMemberOffsets.find(memberIndex) };
+				auto const matrixStrideIterator{ decorations.umMemberMatrixStrides.find(memberIndex) };
+
+				std::uint32_t const memberOffset{ offsetIterator == decorations.umMemberOffsets.end() ? size : offsetIterator->second };
+				std::optional<std::uint32_t> const memberMatrixStride
+				{
+					matrixStrideIterator == decorations.umMemberMatrixStrides.end() ?
+					std::nullopt : std::optional<std::uint32_t>{ matrixStrideIterator->second }
+				};
+
+				size = std::max(size, memberOffset + getTypeSize(spirvModule, type.vOperands[memberIndex], memberMatrixStride));
+			}
+
+			return size;
+		}
+
+		default:
+			throw std::runtime_error(std::format("size of SPIR-V type %{} cannot be determined!", typeId));
+		}
+	}
+
+	std::uint32_t getPushConstantOffset(SpirvModule const& spirvModule, std::uint32_t const structTypeId)
+	{
+		SpirvDecorations const& decorations{ getDecorations(spirvModule, structTypeId) };
+		if (decorations.umMemberOffsets.empty())
+			return 0;
+
+		return std::min_element
+		(
+			decorations.umMemberOffsets.begin(), decorations.umMemberOffsets.end(),
+			[](auto const& firstMemberOffset, auto const& secondMemberOffset)
+			{
+				return firstMemberOffset.second < secondMemberOffset.second;
+			}
+		)->second;
+	}
+
+	VkDescriptorType getDescriptorType(SpirvModule const& spirvModule, std::uint32_t const typeId, spv::StorageClass const storageClass)
+	{
+		SpirvInstruction const& type{ getType(spirvModule, typeId) };
+
+		switch (storageClass)
+		{
+		case spv::StorageClassUniform:
+			return getDecorations(spirvModule, typeId).isBufferBlock ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+		case spv::StorageClassStorageBuffer:
+			return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
+		case spv::StorageClassUniformConstant:
+			switch (type.opcode)
+			{
+			case spv::OpTypeSampler:
+				return VK_DESCRIPTOR_TYPE_SAMPLER;
+
+			case spv::OpTypeSampledImage:
+				return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+			case spv::OpTypeAccelerationStructureKHR:
+				return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+
+			case spv::OpTypeImage:
+			{
+				auto const dimension{ static_cast<spv::Dim>(type.vOperands[1]) };
+				bool const isStorage{ type.vOperands[5] == 2 };
+
+				if (dimension == spv::DimSubpassData)
+					return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+
+				if (dimension == spv::DimBuffer)
+					return isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+
+				return isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+			}
+
+			default:
+				break;
+			}
+			break;
+
+		default:
+			break;
+		}
+
+		throw std::runtime_error(std::format("SPIR-V type %{} is not a descriptor type!", typeId));
+	}
+}
+
+fro::ShaderReflection fro::reflectShader(std::vector<std::uint32_t> const& vBytecode, VkShaderStageFlagBits const shaderStage)
+{
+	SpirvModule const spirvModule{ parseSpirvModule(vBytecode) };
+
+	ShaderReflection shaderReflection{};
+	for (auto const& [variableId, variable] : spirvModule.vVariables)
+	{
+		auto const storageClass{ static_cast<spv::StorageClass>(variable.vOperands[1]) };
+
+		SpirvInstruction const& pointerType{ getType(spirvModule, variable.vOperands[0]) };
+		std::uint32_t typeId{ pointerType.vOperands[1] };
+
+		if (storageClass == spv::StorageClassPushConstant)
+		{
+			std::uint32_t const offset{ getPushConstantOffset(spirvModule, typeId) };
+
+			shaderReflection.vPushConstantRanges.push_back
+			(
+				VkPushConstantRange
+				{
+					.stageFlags{ static_cast<VkShaderStageFlags>(shaderStage) },
+					.offset{ offset },
+					.size{ getTypeSize(spirvModule, typeId) - offset }
+				}
+			);
+			continue;
+		}
+
+		SpirvDecorations const& decorations{ getDecorations(spirvModule, variableId) };
+		if (not decorations.descriptorSet.has_value() or not decorations.binding.has_value())
+			continue;
+
+		std::uint32_t descriptorCount{ 1 };
+		for (SpirvInstruction const* pType{ &getType(spirvModule, typeId) };
+			pType->opcode == spv::OpTypeArray or pType->opcode == spv::OpTypeRuntimeArray;
+			pType = &getType(spirvModule, typeId))
+		{
+			if (pType->opcode == spv::OpTypeArray)
+				descriptorCount *= spirvModule.umConstants.at(pType->vOperands[1]);
+
+			typeId = pType->vOperands[0];
+		}
+
+		std::uint32_t const descriptorSet{ decorations.descriptorSet.value() };
+		if (shaderReflection.vvDescriptorSetLayoutBindings.size() <= descriptorSet)
+			shaderReflection.vvDescriptorSetLayoutBindings.resize(descriptorSet + 1);
+
+		shaderReflection.vvDescriptorSetLayoutBindings[descriptorSet].push_back
+		(
+			VkDescriptorSetLayoutBinding
+			{
+				.binding{ decorations.binding.value() },
+				.descriptorType{ getDescriptorType(spirvModule, typeId, storageClass) },
+				.descriptorCount{ descriptorCount },
+				.stageFlags{ static_cast<VkShaderStageFlags>(shaderStage) }
+			}
+		);
+	}
+
+	return shaderReflection;
+}
+
+fro::ShaderReflection fro::mergeShaderReflections(std::vector<ShaderReflection> const& vShaderReflections)
+{
+	ShaderReflection mergedShaderReflection{};
+	for (ShaderReflection const& shaderReflection : vShaderReflections)
+	{
+		if (mergedShaderReflection.vvDescriptorSetLayoutBindings.size() < shaderReflection.vvDescriptorSetLayoutBindings.size())
+			mergedShaderReflection.vvDescriptorSetLayoutBindings.resize(shaderReflection.vvDescriptorSetLayoutBindings.size());
+
+		for (std::size_t descriptorSet{}; descriptorSet < shaderReflection.vvDescriptorSetLayoutBindings.size(); ++descriptorSet)
+			for (VkDescriptorSetLayoutBinding const& binding : shaderReflection.vvDescriptorSetLayoutBindings[descriptorSet])
+			{
+				std::vector<VkDescriptorSetLayoutBinding>& vMergedBindings{ mergedShaderReflection.vvDescriptorSetLayoutBindings[descriptorSet] };
+
+				auto const mergedBindingIterator
+				{
+					std::find_if
+					(
+						vMergedBindings.begin(), vMergedBindings.end(),
+						[&binding](VkDescriptorSetLayoutBinding const& mergedBinding)
+						{
+							return mergedBinding.binding == binding.binding;
+						}
+					)
+				};
+
+				if (mergedBindingIterator == vMergedBindings.end())
+					vMergedBindings.push_back(binding);
+				else if (mergedBindingIterator->descriptorType != binding.descriptorType or mergedBindingIterator->descriptorCount != binding.descriptorCount)
+					throw std::runtime_error(std::format("shader stages disagree on set {} binding {}!", descriptorSet, binding.binding));
+				else
+					mergedBindingIterator->stageFlags |= binding.stageFlags;
+			}
+
+		for (VkPushConstantRange const& pushConstantRange : shaderReflection.vPushConstantRanges)
+		{
+			auto const mergedPushConstantRangeIterator
+			{
+				std::find_if
+				(
+					mergedShaderReflection.vPushConstantRanges.begin(), mergedShaderReflection.vPushConstantRanges.end(),
+					[&pushConstantRange](VkPushConstantRange const& mergedPushConstantRange)
+					{
+						return
+							mergedPushConstantRange.offset == pushConstantRange.offset and
+							mergedPushConstantRange.size == pushConstantRange.size;
+					}
+				)
+			};
+
+			if (mergedPushConstantRangeIterator == mergedShaderReflection.vPushConstantRanges.end())
+				mergedShaderReflection.vPushConstantRanges.push_back(pushConstantRange);
+			else
+				mergedPushConstantRangeIterator->stageFlags |= pushConstantRange.stageFlags;
+		}
+	}
+
+	for (std::vector<VkDescriptorSetLayoutBinding>& vBindings : mergedShaderReflection.vvDescriptorSetLayoutBindings)
+		std::sort
+		(
+			vBindings.begin(), vBindings.end(),
+			[](VkDescriptorSetLayoutBinding const& firstBinding, VkDescriptorSetLayoutBinding const& secondBinding)
+			{
+				return firstBinding.binding < secondBinding.binding;
+			}
+		);
+
+	return mergedShaderReflection;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#if not defined fro_SHADER_REFLECTION_H
+#define fro_SHADER_REFLECTION_H
+
+#include <Vulkan/vulkan_core.h>
+
+#include <vector>
+#include <cstdint>
+
+namespace fro
+{
+	// the descriptor set bindings and push constant ranges a set of shader stages expects,
+	// indexed by descriptor set number
+	struct ShaderReflection final
+	{
+		std::vector<std::vector<VkDescriptorSetLayoutBinding>> vvDescriptorSetLayoutBindings{};
+		std::vector<VkPushConstantRange> vPushConstantRanges{};
+	};
+
+	[[nodiscard("reflected shader interface ignored!")]]
+	ShaderReflection reflectShader(std::vector<std::uint32_t> const& vBytecode, VkShaderStageFlagBits const shaderStage);
+
+	[[nodiscard("merged shader interface ignored!")]]
+	ShaderReflection mergeShaderReflections(std::vector<ShaderReflection> const& vShaderReflections);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "ShaderVariants.h"
+
+#if defined fro_RUNTIME_SHADER_COMPILATION
+#include "ShaderCompiler.h"
+#else
+#include <EmbeddedShaders.hpp>
+#endif
+
+#include <algorithm>
+#include <format>
+#include <ranges>
+#include <stdexcept>
+
+#if defined fro_RUNTIME_SHADER_COMPILATION
+#include <filesystem>
+#include <fstream>
+#endif
+
+namespace
+{
+#if defined fro_RUNTIME_SHADER_COMPILATION
+	std::string_view constexpr g_FeaturesHeader{ "// features, defined by the compiler per variant:" };
+
+	std::vector<std::string> readFeatureNames(std::filesystem::path const& filePath)
+	{
+		std::ifstream file{ filePath };
+		if (not file.is_open())
+			throw std::runtime_error(std::format("couldn't open {}!", filePath.string()));
+
+		std::string line{};
+		while (std::getline(file, line))
+			if (line == g_FeaturesHeader)
+				break;
+
+		std::vector<std::string> vFeatureNames{};
+		while (std::getline(file, line) and line.starts_with("// "))
+		{
+			std::size_t const nameEnd{ line.find(" - ") };
+			if (nameEnd == std::string::npos)
+				throw std::runtime_error(std::format("{} has a feature without a description!", filePath.string()));
+
+			vFeatureNames.push_back(line.substr(3, nameEnd - 3));
+		}
+
+		return vFeatureNames;
+	}
+#else
+	std::vector<std::string> findEmbeddedFeatureNames(std::string_view const shaderFileName)
+	{
+		auto const shaderIterator
+		{
+			std::ranges::find(fro::g_aEmbeddedShaderFeatures, shaderFileName, &fro::EmbeddedShaderFeatures::shaderFileName)
+		};
+
+		if (shaderIterator == std::ranges::end(fro::g_aEmbeddedShaderFeatures))
+			throw std::runtime_error(std::format("{} wasn't embedded!", shaderFileName));
+
+		std::vector<std::string> vFeatureNames{};
+		for (auto const featureName : std::views::split(shaderIterator->featureNames, ' '))
+			if (not featureName.empty())
+				vFeatureNames.emplace_back(featureName.begin(), featureName.end());
+
+		return vFeatureNames;
+	}
+
+	std::vector<std::uint32_t> findEmbeddedBytecode(std::string_view const variantName)
+	{
+		auto const shaderIterator
+		{
+			std::ranges::find(fro::g_aEmbeddedShaders, variantName, &fro::EmbeddedShader::name)
+		};
+
+		if (shaderIterator == std::ranges::end(fro::g_aEmbeddedShaders))
+			throw std::runtime_error(std::format("{} wasn't embedded!", variantName));
+
+		return { shaderIterator->bytecode.begin(), shaderIterator->bytecode.end() };
+	}
+#endif
+}
+
+std::string fro::getShaderVariantName(std::string_view const shaderFileName, std::vector<std::string_view> vMacroNames)
+{
+	std::ranges::sort(vMacroNames);
+
+	std::string name{ shaderFileName };
+	for (std::string_view const macroName : vMacroNames)
+		name += std::format(" {}", macroName);
+
+	return name;
+}
+
+#pragma region Constructors/Destructor
+fro::ShaderVariants::ShaderVariants(std::string_view const shadersDirectory, std::string_view const shaderFileName, shaderc_shader_kind const shaderKind)
+	: m_ShadersDirectory{ shadersDirectory }
+	, m_ShaderFileName{ shaderFileName }
+	, m_ShaderKind{ shaderKind }
+#if defined fro_RUNTIME_SHADER_COMPILATION
+	, m_vFeatureNames{ readFeatureNames(std::filesystem::path{ m_ShadersDirectory } / m_ShaderFileName) }
+#else
+	, m_vFeatureNames{ findEmbeddedFeatureNames(m_ShaderFileName) }
+#endif
+{
+	if (m_vFeatureNames.size() > 32)
+		throw std::runtime_error(std::format("{} declares more than 32 features!", m_ShaderFileName));
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+std::vector<std::uint32_t> const& fro::ShaderVariants::getBytecode(std::vector<std::string_view> const& vEnabledFeatureNames)
+{
+	std::uint32_t featureMask{};
+	for (std::string_view const featureName : vEnabledFeatureNames)
+	{
+		auto const featureIterator{ std::find(m_vFeatureNames.begin(), m_vFeatureNames.end(), featureName) };
+		if (featureIterator == m_vFeatureNames.end())
+			throw std::runtime_error(std::format("{} has no {} feature!", m_ShaderFileName, featureName));
+
+		featureMask |= 1u << static_cast<std::uint32_t>(featureIterator - m_vFeatureNames.begin());
+	}
+
+	auto const variantIterator{ m_umVariants.find(featureMask) };
+	if (variantIterator != m_umVariants.end())
+		return *variantIterator->second;
+
+	// defined in declaration order, whatever order they were asked for in
+	std::vector<std::string_view> vMacroNames{};
+	for (std::size_t featureIndex{}; featureIndex < m_vFeatureNames.size(); ++featureIndex)
+		if (featureMask & (1u << featureIndex))
+			vMacroNames.push_back(m_vFeatureNames[featureIndex]);
+
+#if defined fro_RUNTIME_SHADER_COMPILATION
+	std::vector<std::uint32_t> const& vBytecode{ deduplicate(ShaderCompiler{ m_ShadersDirectory }(m_ShaderFileName, m_ShaderKind, vMacroNames)) };
+#else
+	std::vector<std::uint32_t> const& vBytecode{ deduplicate(findEmbeddedBytecode(getShaderVariantName(m_ShaderFileName, vMacroNames))) };
+#endif
+	m_umVariants.emplace(featureMask, &vBytecode);
+	return vBytecode;
+}
+
+std::vector<std::string> const& fro::ShaderVariants::getFeatureNames() const
+{
+	return m_vFeatureNames;
+}
+
+std::size_t fro::ShaderVariants::getVariantCount() const
+{
+	return m_umVariants.size();
+}
+
+std::size_t fro::ShaderVariants::getBytecodeCount() const
+{
+	return m_lBytecodes.size();
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+std::vector<std::uint32_t> const& fro::ShaderVariants::deduplicate(std::vector<std::uint32_t>&& vBytecode)
+{
+	std::size_t const hash
+	{
+		std::hash<std::string_view>{}({ reinterpret_cast<char const*>(vBytecode.data()), vBytecode.size() * sizeof(std::uint32_t) })
+	};
+
+	auto const [begin, end] { m_umBytecodesByHash.equal_range(hash) };
+	for (auto bytecodeIterator{ begin }; bytecodeIterator != end; ++bytecodeIterator)
+		if (*bytecodeIterator->second == vBytecode)
+			return *bytecodeIterator->second;
+
+	std::vector<std::uint32_t> const& vStoredBytecode{ m_lBytecodes.emplace_back(std::move(vBytecode)) };
+	m_umBytecodesByHash.emplace(hash, &vStoredBytecode);
+	return vStoredBytecode;
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
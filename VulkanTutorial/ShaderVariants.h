@@ -0,0 +1,75 @@
+#if not defined fro_SHADER_VARIANTS_H
+#define fro_SHADER_VARIANTS_H
+
+#include <shaderc/shaderc.h>
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fro
+{
+	// the file name followed by the macros in alphabetical order, which is how embedded variants get looked up
+	[[nodiscard("shader variant name ignored!")]]
+	std::string getShaderVariantName(std::string_view const shaderFileName, std::vector<std::string_view> vMacroNames);
+
+	// the permutations of one shader file over the features it declares; each feature is a macro the shader tests
+	// with #if defined, so a variant only holds the code its features need. The shader declares them in a comment
+	// block starting with a "// features, defined by the compiler per variant:" line, one "// NAME - description"
+	// line per feature, which is the only place they're listed. Variants get compiled the first time
+	// they're asked for, and variants that compile to the same SPIR-V share one bytecode, so pipelines, which tell
+	// bytecode apart by address, get shared as well. Branches too cheap to be worth a permutation belong in
+	// specialization constants instead.
+	// With fro_RUNTIME_SHADER_COMPILATION defined, variants get compiled from the shader files while running.
+	// Otherwise they come from the EmbeddedShaders.hpp ShaderBaker generates before the build, which holds every
+	// variant of every shader in the directory along with its features, and shaderc isn't needed at all
+	class ShaderVariants final
+	{
+	public:
+		// the shader can declare no more than 32 features
+		ShaderVariants(std::string_view const shadersDirectory, std::string_view const shaderFileName, shaderc_shader_kind const shaderKind);
+
+		~ShaderVariants() = default;
+
+		// throws for features the shader didn't declare; the bytecode stays where it is for as long as this lives
+		[[nodiscard("shader variant bytecode ignored!")]]
+		std::vector<std::uint32_t> const& getBytecode(std::vector<std::string_view> const& vEnabledFeatureNames);
+
+		// in the order the shader declares them
+		[[nodiscard("feature names ignored!")]]
+		std::vector<std::string> const& getFeatureNames() const;
+
+		[[nodiscard("variant count ignored!")]]
+		std::size_t getVariantCount() const;
+
+		// variants that compiled to the same SPIR-V count once
+		[[nodiscard("bytecode count ignored!")]]
+		std::size_t getBytecodeCount() const;
+
+	private:
+		ShaderVariants(ShaderVariants const&) = delete;
+		ShaderVariants(ShaderVariants&&) noexcept = delete;
+
+		ShaderVariants& operator=(ShaderVariants const&) = delete;
+		ShaderVariants& operator=(ShaderVariants&&) noexcept = delete;
+
+		[[nodiscard("deduplicated bytecode ignored!")]]
+		std::vector<std::uint32_t> const& deduplicate(std::vector<std::uint32_t>&& vBytecode);
+
+		std::string const m_ShadersDirectory;
+		std::string const m_ShaderFileName;
+		shaderc_shader_kind const m_ShaderKind;
+		std::vector<std::string> const m_vFeatureNames;
+
+		// list nodes don't move, so the bytecode can be handed out by reference
+		std::list<std::vector<std::uint32_t>> m_lBytecodes{};
+		std::unordered_multimap<std::size_t, std::vector<std::uint32_t> const*> m_umBytecodesByHash{};
+		// by feature mask, bit i being m_vFeatureNames[i]
+		std::unordered_map<std::uint32_t, std::vector<std::uint32_t> const*> m_umVariants{};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,13 +1,79 @@
 #version 450
 
+// features, defined by the compiler per variant:
+// VIRTUAL_TEXTURE - samples through a page table and writes tile requests into the feedback buffer
+
 layout(location = 0) in vec3 fragmentColor;
 layout(location = 1) in vec2 fragTexCoord;
 
 layout(location = 0) out vec4 outputColor;
 
+#if defined VIRTUAL_TEXTURE
+// whether physicalTexture is the sparse image itself rather than an atlas; a specialization constant, so the
+// branches not taken get dropped when the pipeline is created
+layout(constant_id = 0) const bool IS_SPARSE = false;
+
+// the feedback writes would otherwise push the depth test after the shader, and occluded fragments would
+// request tiles
+layout(early_fragment_tests) in;
+
+// per tile: the atlas tile to sample (xy) and the level it belongs to (z), which is coarser than the tile's own
+// when the tile itself isn't resident
+layout(binding = 1) uniform usampler2D pageTable;
+// the atlas, or the sparse image itself
+layout(binding = 2) uniform sampler2D physicalTexture;
+
+layout(binding = 3) buffer Feedback
+{
+    uint requestedTiles[];
+} feedback;
+
+layout(binding = 4) uniform VirtualTextureParameters
+{
+    // width, height, level count, padding
+    uvec4 virtualSize;
+    // atlas tiles per row, atlas tiles per column, tile size
+    uvec4 physicalLayout;
+    // tiles per row, tiles per column, index of the level's first tile in the feedback buffer
+    uvec4 levels[16];
+} parameters;
+#else
 layout(binding = 1) uniform sampler2D texSampler;
+#endif
 
 void main()
 {
+#if defined VIRTUAL_TEXTURE
+    vec2 texel = fragTexCoord * vec2(parameters.virtualSize.xy);
+    vec2 texelDx = dFdx(texel);
+    vec2 texelDy = dFdy(texel);
+    float lod = clamp(0.5 * log2(max(dot(texelDx, texelDx), dot(texelDy, texelDy))), 0.0, float(parameters.virtualSize.z - 1u));
+
+    float tileSize = float(parameters.physicalLayout.z);
+    uint level = uint(lod);
+    uvec2 levelTiles = parameters.levels[level].xy;
+    uvec2 tile = min(uvec2(texel / (exp2(float(level)) * tileSize)), levelTiles - 1u);
+
+    // a 4x4 pixel grid finds every tile that covers more than a handful of pixels
+    if ((uint(gl_FragCoord.x) & 3u) == 0u && (uint(gl_FragCoord.y) & 3u) == 0u)
+        feedback.requestedTiles[parameters.levels[level].z + tile.y * levelTiles.x + tile.x] = 1u;
+
+    uvec4 entry = texelFetch(pageTable, ivec2(tile), int(level));
+    float residentLevel = float(entry.z);
+
+    if (IS_SPARSE)
+    {
+        outputColor = textureLod(physicalTexture, fragTexCoord, max(lod, residentLevel));
+        return;
+    }
+
+    // tiles have no borders, so filtering is kept half a texel inside the tile
+    uvec2 residentTiles = parameters.levels[entry.z].xy;
+    vec2 residentTile = min(texel / (exp2(residentLevel) * tileSize), vec2(residentTiles) - 0.0001);
+    vec2 halfTexel = vec2(0.5 / tileSize);
+    vec2 tileCoord = clamp(fract(residentTile), halfTexel, 1.0 - halfTexel);
+    outputColor = textureLod(physicalTexture, (vec2(entry.xy) + tileCoord) / vec2(parameters.physicalLayout.xy), 0.0);
+#else
     outputColor = texture(texSampler, fragTexCoord);
+#endif
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #version 450
 
+// features, defined by the compiler per variant:
+// DEPTH_ONLY - takes nothing but the position and outputs nothing but the depth, for the depth pre-pass
+
 layout(binding = 0) uniform UniformBufferObject 
 {
     mat4 modelMatrix;
@@ -7,12 +10,19 @@ layout(binding = 0) uniform UniformBufferObject
     mat4 projectionMatrix;
 } uniformBufferObject;
 
-layout(location = 0) in vec2 inPosition;
+layout(location = 0) in vec3 inPosition;
+
+#if !defined DEPTH_ONLY
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
 
 layout(location = 0) out vec3 fragmentColor;
 layout(location = 1) out vec2 fragTexCoord;
+#endif
+
+// every variant computes the depth with the same expression, so the forward pass's EQUAL depth test passes exactly
+// where the depth pre-pass wrote the nearest depth
+invariant gl_Position;
 
 void main() 
 {
@@ -20,8 +30,10 @@ void main()
         uniformBufferObject.projectionMatrix *
         uniformBufferObject.viewMatrix *
         uniformBufferObject.modelMatrix *
-        vec4(inPosition, 0.0f, 1.0f);
+        vec4(inPosition, 1.0f);
 
+#if !defined DEPTH_ONLY
     fragmentColor = inColor;
     fragTexCoord = inTexCoord;
+#endif
 }
\ No newline at end of file
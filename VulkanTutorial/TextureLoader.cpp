@@ -0,0 +1,493 @@
+#include "TextureLoader.h"
+
+#include "BarrierBuilder.h"
+#include "FormatSupport.h"
+#include "HelperFunctions.h"
+#include "Ktx2Texture.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#undef STB_IMAGE_IMPLEMENTATION
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+	VkCommandPool createTransferCommandPool(VkDevice const logicalDevice, std::uint32_t const queueFamilyIndex)
+	{
+		VkCommandPoolCreateInfo const commandPoolCreateInfo
+		{
+			.sType{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO },
+			.flags{ VK_COMMAND_POOL_CREATE_TRANSIENT_BIT },
+			.queueFamilyIndex{ queueFamilyIndex }
+		};
+
+		VkCommandPool commandPool;
+		if (vkCreateCommandPool(logicalDevice, &commandPoolCreateInfo, nullptr, &commandPool) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateCommandPool() failed!");
+
+		return commandPool;
+	}
+}
+
+#pragma region Constructors/Destructor
+fro::TextureLoader::TextureLoader(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, VkQueue const graphicsQueue, std::uint32_t const graphicsQueueFamilyIndex)
+	: m_LogicalDevice{ logicalDevice }
+	, m_PhysicalDevice{ physicalDevice }
+	, m_GraphicsQueue{ graphicsQueue }
+	, m_pCommandPool{ createTransferCommandPool(logicalDevice, graphicsQueueFamilyIndex), std::bind(vkDestroyCommandPool, logicalDevice, std::placeholders::_1, nullptr) }
+	, m_Placeholder{ createPlaceholder() }
+{
+	std::uint32_t const workerCount{ std::max(std::thread::hardware_concurrency(), 2u) - 1 };
+	for (std::uint32_t index{}; index < workerCount; ++index)
+		m_vWorkers.emplace_back(std::bind_front(&TextureLoader::work, this));
+}
+
+fro::TextureLoader::~TextureLoader()
+{
+	for (std::jthread& worker : m_vWorkers)
+		worker.request_stop();
+
+	m_vWorkers.clear();
+
+	for (UploadBatch const& uploadBatch : m_vUploadBatches)
+	{
+		VkFence const fence{ uploadBatch.pFence.get() };
+		vkWaitForFences(m_LogicalDevice, 1, &fence, VK_TRUE, UINT64_MAX);
+	}
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+fro::TextureLoader::TextureHandle fro::TextureLoader::load(std::string filePath)
+{
+	return enqueue({ .filePath{ std::move(filePath) } });
+}
+
+fro::TextureLoader::TextureHandle fro::TextureLoader::load(AssetPack const& assetPack, AssetPackEntry const& entry, std::uint32_t const baseLevel)
+{
+	if (baseLevel >= entry.levelCount)
+		throw std::out_of_range(std::format("base level {} is out of range for a texture with {} levels!", baseLevel, entry.levelCount));
+
+	return enqueue({ .pAssetPack{ &assetPack }, .pAssetPackEntry{ &entry }, .baseLevel{ baseLevel } });
+}
+
+void fro::TextureLoader::unload(TextureHandle const textureHandle)
+{
+	Texture& texture{ m_vTextures.at(textureHandle) };
+	if (not texture.isResident)
+		throw std::runtime_error("only resident textures can be unloaded!");
+
+	texture = {};
+	m_vFreeTextureHandles.push_back(textureHandle);
+}
+
+void fro::TextureLoader::processUploads()
+{
+	retireUploadBatches();
+
+	std::vector<StagedTexture> vStagedTextures{};
+	{
+		std::lock_guard const lock{ m_Mutex };
+		vStagedTextures.swap(m_vStagedTextures);
+	}
+
+	if (vStagedTextures.empty())
+		return;
+
+	for (StagedTexture const& stagedTexture : vStagedTextures)
+		if (stagedTexture.pException)
+			std::rethrow_exception(stagedTexture.pException);
+
+	VkCommandBufferAllocateInfo const allocateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO },
+		.commandPool{ m_pCommandPool.get() },
+		.level{ VK_COMMAND_BUFFER_LEVEL_PRIMARY },
+		.commandBufferCount{ 1 }
+	};
+
+	VkCommandBuffer commandBuffer;
+	if (vkAllocateCommandBuffers(m_LogicalDevice, &allocateInfo, &commandBuffer) != VK_SUCCESS)
+		throw std::runtime_error("vkAllocateCommandBuffers() failed!");
+
+	VkCommandBufferBeginInfo const beginInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO },
+		.flags{ VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT }
+	};
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+		throw std::runtime_error("vkBeginCommandBuffer() failed!");
+
+	recordUploads(commandBuffer, vStagedTextures);
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+		throw std::runtime_error("vkEndCommandBuffer() failed!");
+
+	VkFenceCreateInfo const fenceCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO }
+	};
+
+	VkFence fence;
+	if (vkCreateFence(m_LogicalDevice, &fenceCreateInfo, nullptr, &fence) != VK_SUCCESS)
+		throw std::runtime_error("vkCreateFence() failed!");
+
+	UploadBatch uploadBatch
+	{
+		.commandBuffer{ commandBuffer },
+		.pFence{ fence, std::bind(vkDestroyFence, m_LogicalDevice, std::placeholders::_1, nullptr) },
+		.vStagedTextures{ std::move(vStagedTextures) }
+	};
+
+	VkSubmitInfo const submitInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_SUBMIT_INFO },
+		.commandBufferCount{ 1 },
+		.pCommandBuffers{ &commandBuffer }
+	};
+
+	if (vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS)
+		throw std::runtime_error("vkQueueSubmit() failed!");
+
+	m_vUploadBatches.push_back(std::move(uploadBatch));
+}
+
+VkImageView fro::TextureLoader::getImageView(TextureHandle const textureHandle) const
+{
+	Texture const& texture{ m_vTextures.at(textureHandle) };
+
+	return texture.isResident ? texture.pImageView.get() : m_Placeholder.pImageView.get();
+}
+
+bool fro::TextureLoader::isResident(TextureHandle const textureHandle) const
+{
+	return m_vTextures.at(textureHandle).isResident;
+}
+
+VkDeviceSize fro::TextureLoader::getMemorySize(TextureHandle const textureHandle) const
+{
+	Texture const& texture{ m_vTextures.at(textureHandle) };
+
+	return texture.isResident ? texture.memorySize : 0;
+}
+
+std::uint64_t fro::TextureLoader::getResidencyVersion() const
+{
+	return m_ResidencyVersion;
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+fro::TextureLoader::TextureHandle fro::TextureLoader::enqueue(Job job)
+{
+	if (m_vFreeTextureHandles.empty())
+	{
+		job.handle = m_vTextures.size();
+		m_vTextures.push_back({});
+	}
+	else
+	{
+		job.handle = m_vFreeTextureHandles.back();
+		m_vFreeTextureHandles.pop_back();
+	}
+
+	TextureHandle const textureHandle{ job.handle };
+	{
+		std::lock_guard const lock{ m_Mutex };
+		m_dJobs.push_back(std::move(job));
+	}
+	m_JobAvailable.notify_one();
+
+	return textureHandle;
+}
+
+void fro::TextureLoader::work(std::stop_token stopToken)
+{
+	while (true)
+	{
+		Job job{};
+		{
+			std::unique_lock lock{ m_Mutex };
+			if (not m_JobAvailable.wait(lock, stopToken, [this]() { return not m_dJobs.empty(); }))
+				return;
+
+			job = std::move(m_dJobs.front());
+			m_dJobs.pop_front();
+		}
+
+		StagedTexture stagedTexture{ .handle{ job.handle } };
+		try
+		{
+			stagedTexture = stage(job);
+		}
+		catch (...)
+		{
+			stagedTexture.pException = std::current_exception();
+		}
+
+		std::lock_guard const lock{ m_Mutex };
+		m_vStagedTextures.push_back(std::move(stagedTexture));
+	}
+}
+
+fro::TextureLoader::StagedTexture fro::TextureLoader::stage(Job const& job) const
+{
+	if (job.pAssetPackEntry)
+		return stageAssetPackEntry(job.handle, *job.pAssetPack, *job.pAssetPackEntry, job.baseLevel);
+
+	return stageFile(job.handle, job.filePath);
+}
+
+fro::TextureLoader::StagedTexture fro::TextureLoader::stageFile(TextureHandle const textureHandle, std::string const& filePath) const
+{
+	StagedTexture stagedTexture{ .handle{ textureHandle } };
+	std::uint8_t* pMappedData;
+
+	// block-compressed KTX2 levels are read from disk straight into the staging buffer
+	if (filePath.ends_with(".ktx2"))
+	{
+		Ktx2Texture ktx2Texture{ readKtx2Texture(filePath) };
+
+		stagedTexture.format = ktx2Texture.format;
+		stagedTexture.width = ktx2Texture.vLevels.front().width;
+		stagedTexture.height = ktx2Texture.vLevels.front().height;
+		stagedTexture.mipLevels = static_cast<std::uint32_t>(ktx2Texture.vLevels.size());
+		stagedTexture.pStagingBuffer = createStagingBuffer(ktx2Texture.vLevels.back().offset + ktx2Texture.vLevels.back().size, pMappedData);
+
+		readKtx2Levels(filePath, ktx2Texture, pMappedData);
+		stagedTexture.vLevels = std::move(ktx2Texture.vLevels);
+	}
+	else
+	{
+		int textureWidth;
+		int textureHeight;
+		int textureChannels;
+
+		std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> const pPixels
+		{
+			stbi_load(filePath.c_str(), &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha),
+			stbi_image_free
+		};
+		if (not pPixels)
+			throw std::runtime_error(std::format("stbi_load() failed for {}!", filePath));
+
+		stagedTexture.format = VK_FORMAT_R8G8B8A8_SRGB;
+		stagedTexture.width = static_cast<std::uint32_t>(textureWidth);
+		stagedTexture.height = static_cast<std::uint32_t>(textureHeight);
+		stagedTexture.mipLevels = getMipLevelCount(stagedTexture.width, stagedTexture.height);
+
+		// without linear blit support the whole chain is filtered here, off the render thread
+		if (isLinearBlitSupported(stagedTexture.format, m_PhysicalDevice))
+		{
+			std::size_t const size{ static_cast<std::size_t>(stagedTexture.width) * stagedTexture.height * 4 };
+
+			stagedTexture.vLevels.push_back({ stagedTexture.width, stagedTexture.height, 0, size });
+			stagedTexture.pStagingBuffer = createStagingBuffer(size, pMappedData);
+			std::memcpy(pMappedData, pPixels.get(), size);
+		}
+		else
+		{
+			MipChain mipChain{ generateMipChain(pPixels.get(), stagedTexture.width, stagedTexture.height, stagedTexture.format == VK_FORMAT_R8G8B8A8_SRGB) };
+
+			stagedTexture.pStagingBuffer = createStagingBuffer(mipChain.vPixels.size(), pMappedData);
+			std::memcpy(pMappedData, mipChain.vPixels.data(), mipChain.vPixels.size());
+			stagedTexture.vLevels = std::move(mipChain.vLevels);
+		}
+	}
+
+	vkUnmapMemory(m_LogicalDevice, stagedTexture.pStagingBuffer.second.get());
+
+	return stagedTexture;
+}
+
+fro::TextureLoader::StagedTexture fro::TextureLoader::stageAssetPackEntry(TextureHandle const textureHandle, AssetPack const& assetPack, AssetPackEntry const& entry, std::uint32_t const baseLevel) const
+{
+	StagedTexture stagedTexture
+	{
+		.handle{ textureHandle },
+		.format{ entry.format },
+		.width{ entry.aLevels[baseLevel].width },
+		.height{ entry.aLevels[baseLevel].height },
+		.mipLevels{ entry.levelCount - baseLevel }
+	};
+
+	std::uint64_t const baseOffset{ entry.aLevels[baseLevel].offset };
+	for (std::uint32_t level{ baseLevel }; level < entry.levelCount; ++level)
+	{
+		AssetPackLevel const& packedLevel{ entry.aLevels[level] };
+		stagedTexture.vLevels.push_back({ packedLevel.width, packedLevel.height, static_cast<std::size_t>(packedLevel.offset - baseOffset), static_cast<std::size_t>(packedLevel.size) });
+	}
+
+	// levels are stored largest first, so the ones from baseLevel down are a single run of the payload that's
+	// already in upload layout; the mapped pages go straight into the staging buffer
+	std::span<std::uint8_t const> const payload{ assetPack.getPayload(entry).subspan(static_cast<std::size_t>(baseOffset)) };
+
+	std::uint8_t* pMappedData;
+	stagedTexture.pStagingBuffer = createStagingBuffer(payload.size(), pMappedData);
+	std::memcpy(pMappedData, payload.data(), payload.size());
+	vkUnmapMemory(m_LogicalDevice, stagedTexture.pStagingBuffer.second.get());
+
+	return stagedTexture;
+}
+
+std::pair<fro::UniquePointer<VkBuffer_T>, fro::UniquePointer<VkDeviceMemory_T>> fro::TextureLoader::createStagingBuffer(VkDeviceSize const size, std::uint8_t*& pMappedData) const
+{
+	auto pStagingBuffer
+	{
+		createBuffer(m_LogicalDevice, m_PhysicalDevice,
+			size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+	};
+
+	void* pData;
+	if (vkMapMemory(m_LogicalDevice, pStagingBuffer.second.get(), 0, size, 0, &pData) != VK_SUCCESS)
+		throw std::runtime_error("vkMapMemory() failed!");
+
+	pMappedData = static_cast<std::uint8_t*>(pData);
+
+	return pStagingBuffer;
+}
+
+void fro::TextureLoader::recordUploads(VkCommandBuffer const commandBuffer, std::vector<StagedTexture> const& vStagedTextures)
+{
+	BarrierBuilder barrierBuilder{};
+	for (StagedTexture const& stagedTexture : vStagedTextures)
+	{
+		bool const isBlitRequired{ stagedTexture.vLevels.size() < stagedTexture.mipLevels };
+
+		Texture& texture{ m_vTextures[stagedTexture.handle] };
+		texture.pImage = createImage(m_LogicalDevice, m_PhysicalDevice,
+			stagedTexture.width, stagedTexture.height, stagedTexture.mipLevels,
+			stagedTexture.format, VK_IMAGE_TILING_OPTIMAL,
+			(isBlitRequired ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0) | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		texture.pImageView = createImageView(texture.pImage.first.get(), stagedTexture.format, m_LogicalDevice, stagedTexture.mipLevels);
+
+		VkMemoryRequirements memoryRequirements;
+		vkGetImageMemoryRequirements(m_LogicalDevice, texture.pImage.first.get(), &memoryRequirements);
+		texture.memorySize = memoryRequirements.size;
+
+		barrierBuilder.addImageBarrier(texture.pImage.first.get(), { VK_IMAGE_ASPECT_COLOR_BIT, 0, stagedTexture.mipLevels, 0, 1 },
+			g_DiscardedResourceState, getResourceState(ResourceUsage::TransferWrite));
+	}
+
+	barrierBuilder.flush(commandBuffer);
+
+	for (StagedTexture const& stagedTexture : vStagedTextures)
+	{
+		VkImage const image{ m_vTextures[stagedTexture.handle].pImage.first.get() };
+
+		std::vector<VkBufferImageCopy> vRegions{};
+		for (std::uint32_t level{}; level < stagedTexture.vLevels.size(); ++level)
+			vRegions.push_back
+			(
+				VkBufferImageCopy
+				{
+					.bufferOffset{ stagedTexture.vLevels[level].offset },
+					.imageSubresource
+					{
+						.aspectMask{ VK_IMAGE_ASPECT_COLOR_BIT },
+						.mipLevel{ level },
+						.layerCount{ 1 }
+					},
+					.imageExtent{ stagedTexture.vLevels[level].width, stagedTexture.vLevels[level].height, 1 }
+				}
+			);
+
+		vkCmdCopyBufferToImage(commandBuffer, stagedTexture.pStagingBuffer.first.get(), image,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<std::uint32_t>(vRegions.size()), vRegions.data());
+
+		if (stagedTexture.vLevels.size() < stagedTexture.mipLevels)
+			recordMipmapGeneration(commandBuffer, image, stagedTexture.width, stagedTexture.height, stagedTexture.mipLevels);
+		else
+			barrierBuilder.addImageBarrier(image, { VK_IMAGE_ASPECT_COLOR_BIT, 0, stagedTexture.mipLevels, 0, 1 },
+				ResourceUsage::TransferWrite, ResourceUsage::FragmentSampledRead);
+	}
+
+	barrierBuilder.flush(commandBuffer);
+}
+
+void fro::TextureLoader::retireUploadBatches()
+{
+	std::erase_if
+	(
+		m_vUploadBatches,
+		[this](UploadBatch const& uploadBatch)
+		{
+			if (vkGetFenceStatus(m_LogicalDevice, uploadBatch.pFence.get()) != VK_SUCCESS)
+				return false;
+
+			for (StagedTexture const& stagedTexture : uploadBatch.vStagedTextures)
+				m_vTextures[stagedTexture.handle].isResident = true;
+
+			++m_ResidencyVersion;
+			vkFreeCommandBuffers(m_LogicalDevice, m_pCommandPool.get(), 1, &uploadBatch.commandBuffer);
+
+			return true;
+		}
+	);
+}
+
+fro::TextureLoader::Texture fro::TextureLoader::createPlaceholder()
+{
+	std::array<std::uint8_t, 4> constexpr aPlaceholderPixel{ 128, 128, 128, 255 };
+
+	std::uint8_t* pMappedData;
+	auto const pStagingBuffer{ createStagingBuffer(aPlaceholderPixel.size(), pMappedData) };
+	std::memcpy(pMappedData, aPlaceholderPixel.data(), aPlaceholderPixel.size());
+	vkUnmapMemory(m_LogicalDevice, pStagingBuffer.second.get());
+
+	Texture placeholder
+	{
+		.pImage
+		{
+			createImage(m_LogicalDevice, m_PhysicalDevice, 1, 1, 1,
+				VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL,
+				VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+		},
+		.isResident{ true }
+	};
+	placeholder.pImageView = createImageView(placeholder.pImage.first.get(), VK_FORMAT_R8G8B8A8_UNORM, m_LogicalDevice, 1);
+
+	VkImage const image{ placeholder.pImage.first.get() };
+	VkCommandBuffer const commandBuffer{ beginSingleTimeCommands(m_pCommandPool.get(), m_LogicalDevice) };
+
+	VkImageSubresourceRange constexpr subresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+	BarrierBuilder barrierBuilder{};
+	barrierBuilder
+		.addImageBarrier(image, subresourceRange, g_DiscardedResourceState, getResourceState(ResourceUsage::TransferWrite))
+		.flush(commandBuffer);
+
+	VkBufferImageCopy const region
+	{
+		.imageSubresource
+		{
+			.aspectMask{ VK_IMAGE_ASPECT_COLOR_BIT },
+			.layerCount{ 1 }
+		},
+		.imageExtent{ 1, 1, 1 }
+	};
+	vkCmdCopyBufferToImage(commandBuffer, pStagingBuffer.first.get(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	barrierBuilder
+		.addImageBarrier(image, subresourceRange, ResourceUsage::TransferWrite, ResourceUsage::FragmentSampledRead)
+		.flush(commandBuffer);
+
+	endSingleTimeCommands(commandBuffer, m_GraphicsQueue, m_pCommandPool.get(), m_LogicalDevice);
+
+	return placeholder;
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
@@ -0,0 +1,131 @@
+#if not defined fro_TEXTURE_LOADER_H
+#define fro_TEXTURE_LOADER_H
+
+#include "AssetPack.h"
+#include "MipChain.h"
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fro
+{
+	// decodes textures on a pool of worker threads straight into staging buffers, and uploads everything
+	// that finished decoding in one batched submission per processUploads() call; until a texture is
+	// resident its handle resolves to a 1x1 placeholder
+	class TextureLoader final
+	{
+	public:
+		using TextureHandle = std::size_t;
+
+		TextureLoader(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, VkQueue const graphicsQueue, std::uint32_t const graphicsQueueFamilyIndex);
+
+		~TextureLoader();
+
+		[[nodiscard("texture handle ignored!")]]
+		TextureHandle load(std::string filePath);
+
+		// the pack has to outlive the loader; its payloads are copied into staging memory as-is,
+		// skipping every level above baseLevel
+		[[nodiscard("texture handle ignored!")]]
+		TextureHandle load(AssetPack const& assetPack, AssetPackEntry const& entry, std::uint32_t const baseLevel);
+
+		// frees a resident texture's image right away, so the GPU must be done with it; its handle gets reused
+		void unload(TextureHandle const textureHandle);
+
+		// must be called from the thread that submits to the graphics queue
+		void processUploads();
+
+		[[nodiscard("texture image view ignored!")]]
+		VkImageView getImageView(TextureHandle const textureHandle) const;
+
+		[[nodiscard("texture residency ignored!")]]
+		bool isResident(TextureHandle const textureHandle) const;
+
+		// the size of the resident image's allocation, 0 until the texture is resident
+		[[nodiscard("texture memory size ignored!")]]
+		VkDeviceSize getMemorySize(TextureHandle const textureHandle) const;
+
+		// bumped every time a texture becomes resident, so users know when to rewrite their descriptors
+		[[nodiscard("residency version ignored!")]]
+		std::uint64_t getResidencyVersion() const;
+
+	private:
+		struct Job final
+		{
+			TextureHandle handle;
+			std::string filePath;
+			AssetPack const* pAssetPack;
+			AssetPackEntry const* pAssetPackEntry;
+			std::uint32_t baseLevel;
+		};
+
+		struct StagedTexture final
+		{
+			TextureHandle handle;
+			VkFormat format;
+			std::uint32_t width;
+			std::uint32_t height;
+			std::uint32_t mipLevels;
+			std::vector<MipLevel> vLevels;
+			std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>> pStagingBuffer;
+			std::exception_ptr pException;
+		};
+
+		struct Texture final
+		{
+			std::pair<UniquePointer<VkImage_T>, UniquePointer<VkDeviceMemory_T>> pImage;
+			UniquePointer<VkImageView_T> pImageView;
+			VkDeviceSize memorySize;
+			bool isResident;
+		};
+
+		struct UploadBatch final
+		{
+			VkCommandBuffer commandBuffer;
+			UniquePointer<VkFence_T> pFence;
+			std::vector<StagedTexture> vStagedTextures;
+		};
+
+		TextureLoader(TextureLoader const&) = delete;
+		TextureLoader(TextureLoader&&) noexcept = delete;
+
+		TextureLoader& operator=(TextureLoader const&) = delete;
+		TextureLoader& operator=(TextureLoader&&) noexcept = delete;
+
+		TextureHandle enqueue(Job job);
+		void work(std::stop_token stopToken);
+		StagedTexture stage(Job const& job) const;
+		StagedTexture stageFile(TextureHandle const textureHandle, std::string const& filePath) const;
+		StagedTexture stageAssetPackEntry(TextureHandle const textureHandle, AssetPack const& assetPack, AssetPackEntry const& entry, std::uint32_t const baseLevel) const;
+		std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>> createStagingBuffer(VkDeviceSize const size, std::uint8_t*& pMappedData) const;
+		void recordUploads(VkCommandBuffer const commandBuffer, std::vector<StagedTexture> const& vStagedTextures);
+		void retireUploadBatches();
+		Texture createPlaceholder();
+
+		VkDevice const m_LogicalDevice;
+		VkPhysicalDevice const m_PhysicalDevice;
+		VkQueue const m_GraphicsQueue;
+		UniquePointer<VkCommandPool_T> const m_pCommandPool;
+		Texture const m_Placeholder;
+		std::vector<Texture> m_vTextures{};
+		std::vector<TextureHandle> m_vFreeTextureHandles{};
+		std::vector<UploadBatch> m_vUploadBatches{};
+		std::uint64_t m_ResidencyVersion{};
+
+		std::mutex m_Mutex{};
+		std::condition_variable_any m_JobAvailable{};
+		std::deque<Job> m_dJobs{};
+		std::vector<StagedTexture> m_vStagedTextures{};
+		std::vector<std::jthread> m_vWorkers{};
+	};
+}
+
+#endif
\ No newline at end of file
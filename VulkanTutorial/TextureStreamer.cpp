@@ -0,0 +1,295 @@
+#include "TextureStreamer.h"
+
+#include "HelperFunctions.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// levels this size and smaller are never evicted, so every texture always has something to sample
+	std::uint32_t constexpr g_MipTailSize{ 64 };
+
+	// a texture that hasn't been requested for this many frames only keeps its mip tail under pressure
+	std::uint64_t constexpr g_RequestLifetimeFrames{ 60 };
+
+	// caps how much gets staged per frame, so a burst of requests doesn't turn into a hitch
+	VkDeviceSize constexpr g_MaxStreamedBytesPerFrame{ 32ull * 1024 * 1024 };
+
+	VkDeviceSize getLevelsSize(fro::AssetPackEntry const& entry, std::uint32_t const baseLevel)
+	{
+		VkDeviceSize size{};
+		for (std::uint32_t level{ baseLevel }; level < entry.levelCount; ++level)
+			size += entry.aLevels[level].size;
+
+		return size;
+	}
+}
+
+#pragma region Constructors/Destructor
+fro::TextureStreamer::TextureStreamer(TextureLoader& textureLoader, AssetPack const& assetPack, VkPhysicalDevice const physicalDevice, VkDeviceSize const budget, std::uint32_t const framesInFlight)
+	: m_TextureLoader{ textureLoader }
+	, m_AssetPack{ assetPack }
+	, m_PhysicalDevice{ physicalDevice }
+	, m_Budget{ budget }
+	, m_FramesInFlight{ framesInFlight }
+	, m_IsMemoryBudgetSupported
+	{
+		[physicalDevice]()
+		{
+			VkPhysicalDeviceProperties physicalDeviceProperties;
+			vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+
+			return
+				physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_1 and
+				isPhysicalDeviceExtensionAvailable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, physicalDevice);
+		}()
+	}
+	, m_LastBudget{ budget }
+{
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+fro::TextureStreamer::StreamedTextureHandle fro::TextureStreamer::add(AssetPackEntry const& entry)
+{
+	std::uint32_t tailLevel{};
+	while (tailLevel + 1 < entry.levelCount and std::max(entry.aLevels[tailLevel].width, entry.aLevels[tailLevel].height) > g_MipTailSize)
+		++tailLevel;
+
+	StreamedTexture& streamedTexture
+	{
+		m_vStreamedTextures.emplace_back
+		(
+			StreamedTexture
+			{
+				.pEntry{ &entry },
+				.tailLevel{ tailLevel },
+				.requestedLevel{ tailLevel },
+				.lastRequestedFrame{ m_Frame }
+			}
+		)
+	};
+
+	// the mip tail is loaded regardless of the budget
+	stream(streamedTexture, tailLevel);
+
+	return m_vStreamedTextures.size() - 1;
+}
+
+void fro::TextureStreamer::request(StreamedTextureHandle const streamedTextureHandle, float const screenSpaceSize)
+{
+	StreamedTexture& streamedTexture{ m_vStreamedTextures.at(streamedTextureHandle) };
+	AssetPackLevel const& largestLevel{ streamedTexture.pEntry->aLevels.front() };
+
+	// every level halves the texel density, so the level whose size matches the screen footprint is log2 of the ratio
+	float const texelsPerPixel{ static_cast<float>(std::max(largestLevel.width, largestLevel.height)) / std::max(screenSpaceSize, 1.0f) };
+	float const level{ std::floor(std::log2(std::max(texelsPerPixel, 1.0f))) };
+
+	streamedTexture.requestedLevel = std::min(static_cast<std::uint32_t>(level), streamedTexture.tailLevel);
+	streamedTexture.lastRequestedFrame = m_Frame;
+}
+
+void fro::TextureStreamer::update()
+{
+	promotePendingTextures();
+	releaseRetiredTextures();
+
+	m_LastBudget = queryBudget();
+	evictLeastRecentlyUsed(m_LastBudget);
+	streamIn(m_LastBudget);
+
+	m_PendingRequests = static_cast<std::size_t>(std::ranges::count_if(m_vStreamedTextures,
+		[this](StreamedTexture const& streamedTexture)
+		{
+			return streamedTexture.pendingHandle.has_value() or getDesiredLevel(streamedTexture) < getTargetLevel(streamedTexture);
+		}));
+
+	++m_Frame;
+}
+
+VkImageView fro::TextureStreamer::getImageView(StreamedTextureHandle const streamedTextureHandle) const
+{
+	StreamedTexture const& streamedTexture{ m_vStreamedTextures.at(streamedTextureHandle) };
+
+	// until the mip tail lands the loader hands out its placeholder
+	return m_TextureLoader.getImageView(streamedTexture.residentHandle.has_value() ? *streamedTexture.residentHandle : streamedTexture.pendingHandle.value());
+}
+
+fro::TextureStreamerStatistics fro::TextureStreamer::getStatistics() const
+{
+	return TextureStreamerStatistics
+	{
+		.residentBytes{ m_ResidentBytes },
+		.budgetBytes{ m_LastBudget },
+		.pendingRequests{ m_PendingRequests },
+		.evictedLevels{ m_EvictedLevels }
+	};
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+void fro::TextureStreamer::promotePendingTextures()
+{
+	for (StreamedTexture& streamedTexture : m_vStreamedTextures)
+	{
+		if (not streamedTexture.pendingHandle.has_value() or not m_TextureLoader.isResident(streamedTexture.pendingHandle.value()))
+			continue;
+
+		// descriptor sets of frames still in flight can reference the replaced image, so it lives on for a while
+		if (streamedTexture.residentHandle.has_value())
+			m_dRetiredTextures.push_back({ streamedTexture.residentHandle.value(), m_Frame });
+
+		streamedTexture.residentHandle = streamedTexture.pendingHandle;
+		streamedTexture.residentLevel = streamedTexture.pendingLevel;
+		streamedTexture.pendingHandle.reset();
+
+		m_ResidentBytes += m_TextureLoader.getMemorySize(streamedTexture.residentHandle.value());
+	}
+}
+
+void fro::TextureStreamer::releaseRetiredTextures()
+{
+	while (not m_dRetiredTextures.empty() and m_dRetiredTextures.front().frame + m_FramesInFlight <= m_Frame)
+	{
+		TextureLoader::TextureHandle const textureHandle{ m_dRetiredTextures.front().handle };
+
+		m_ResidentBytes -= m_TextureLoader.getMemorySize(textureHandle);
+		m_TextureLoader.unload(textureHandle);
+		m_dRetiredTextures.pop_front();
+	}
+}
+
+void fro::TextureStreamer::evictLeastRecentlyUsed(VkDeviceSize const budget)
+{
+	VkDeviceSize projectedBytes{ getProjectedBytes() };
+	if (projectedBytes <= budget)
+		return;
+
+	// only detail beyond what a texture was last asked for is given up, and stale requests ask for the tail only
+	std::vector<StreamedTexture*> vpCandidates{};
+	for (StreamedTexture& streamedTexture : m_vStreamedTextures)
+		if (not streamedTexture.pendingHandle.has_value() and streamedTexture.residentLevel < getDesiredLevel(streamedTexture))
+			vpCandidates.push_back(&streamedTexture);
+
+	std::ranges::sort(vpCandidates,
+		[](StreamedTexture const* const pFirst, StreamedTexture const* const pSecond)
+		{
+			return pFirst->lastRequestedFrame < pSecond->lastRequestedFrame;
+		});
+
+	for (StreamedTexture* const pCandidate : vpCandidates)
+	{
+		if (projectedBytes <= budget)
+			break;
+
+		std::uint32_t const desiredLevel{ getDesiredLevel(*pCandidate) };
+
+		projectedBytes -= getLevelsSize(*pCandidate->pEntry, pCandidate->residentLevel) - getLevelsSize(*pCandidate->pEntry, desiredLevel);
+		m_EvictedLevels += desiredLevel - pCandidate->residentLevel;
+		stream(*pCandidate, desiredLevel);
+	}
+}
+
+void fro::TextureStreamer::streamIn(VkDeviceSize const budget)
+{
+	std::vector<StreamedTexture*> vpCandidates{};
+	for (StreamedTexture& streamedTexture : m_vStreamedTextures)
+		if (streamedTexture.residentHandle.has_value() and not streamedTexture.pendingHandle.has_value() and getDesiredLevel(streamedTexture) < streamedTexture.residentLevel)
+			vpCandidates.push_back(&streamedTexture);
+
+	// most recently requested first, then the ones missing the most detail
+	std::ranges::sort(vpCandidates,
+		[this](StreamedTexture const* const pFirst, StreamedTexture const* const pSecond)
+		{
+			if (pFirst->lastRequestedFrame != pSecond->lastRequestedFrame)
+				return pFirst->lastRequestedFrame > pSecond->lastRequestedFrame;
+
+			return pFirst->residentLevel - getDesiredLevel(*pFirst) > pSecond->residentLevel - getDesiredLevel(*pSecond);
+		});
+
+	VkDeviceSize projectedBytes{ getProjectedBytes() };
+	VkDeviceSize streamedBytes{};
+	for (StreamedTexture* const pCandidate : vpCandidates)
+	{
+		VkDeviceSize const residentSize{ getLevelsSize(*pCandidate->pEntry, pCandidate->residentLevel) };
+
+		// settles for fewer extra levels when the full request doesn't fit
+		for (std::uint32_t level{ getDesiredLevel(*pCandidate) }; level < pCandidate->residentLevel; ++level)
+		{
+			VkDeviceSize const size{ getLevelsSize(*pCandidate->pEntry, level) };
+			if (projectedBytes + size - residentSize > budget or streamedBytes + size > g_MaxStreamedBytesPerFrame)
+				continue;
+
+			projectedBytes += size - residentSize;
+			streamedBytes += size;
+			stream(*pCandidate, level);
+			break;
+		}
+	}
+}
+
+void fro::TextureStreamer::stream(StreamedTexture& streamedTexture, std::uint32_t const baseLevel)
+{
+	streamedTexture.pendingHandle = m_TextureLoader.load(m_AssetPack, *streamedTexture.pEntry, baseLevel);
+	streamedTexture.pendingLevel = baseLevel;
+}
+
+VkDeviceSize fro::TextureStreamer::queryBudget() const
+{
+	if (not m_IsMemoryBudgetSupported)
+		return m_Budget;
+
+	VkPhysicalDeviceMemoryBudgetPropertiesEXT memoryBudgetProperties
+	{
+		.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT }
+	};
+
+	VkPhysicalDeviceMemoryProperties2 memoryProperties
+	{
+		.sType{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2 },
+		.pNext{ &memoryBudgetProperties }
+	};
+
+	vkGetPhysicalDeviceMemoryProperties2(m_PhysicalDevice, &memoryProperties);
+
+	// the heap usage already includes what's resident here, everything else in it belongs to someone else
+	VkDeviceSize availableBytes{};
+	for (std::uint32_t heapIndex{}; heapIndex < memoryProperties.memoryProperties.memoryHeapCount; ++heapIndex)
+		if (memoryProperties.memoryProperties.memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+		{
+			VkDeviceSize const heapBudget{ memoryBudgetProperties.heapBudget[heapIndex] };
+			VkDeviceSize const heapUsage{ std::min(memoryBudgetProperties.heapUsage[heapIndex], heapBudget) };
+
+			availableBytes = std::max(availableBytes, heapBudget - heapUsage);
+		}
+
+	return std::min(m_Budget, m_ResidentBytes + availableBytes);
+}
+
+VkDeviceSize fro::TextureStreamer::getProjectedBytes() const
+{
+	VkDeviceSize projectedBytes{};
+	for (StreamedTexture const& streamedTexture : m_vStreamedTextures)
+		projectedBytes += getLevelsSize(*streamedTexture.pEntry, getTargetLevel(streamedTexture));
+
+	return projectedBytes;
+}
+
+std::uint32_t fro::TextureStreamer::getDesiredLevel(StreamedTexture const& streamedTexture) const
+{
+	if (m_Frame - streamedTexture.lastRequestedFrame > g_RequestLifetimeFrames)
+		return streamedTexture.tailLevel;
+
+	return streamedTexture.requestedLevel;
+}
+
+std::uint32_t fro::TextureStreamer::getTargetLevel(StreamedTexture const& streamedTexture) const
+{
+	return streamedTexture.pendingHandle.has_value() ? streamedTexture.pendingLevel : streamedTexture.residentLevel;
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
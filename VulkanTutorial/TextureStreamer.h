@@ -0,0 +1,105 @@
+#if not defined fro_TEXTURE_STREAMER_H
+#define fro_TEXTURE_STREAMER_H
+
+#include "AssetPack.h"
+#include "TextureLoader.h"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace fro
+{
+	struct TextureStreamerStatistics final
+	{
+		VkDeviceSize residentBytes;
+		VkDeviceSize budgetBytes;
+		std::size_t pendingRequests;
+		std::size_t evictedLevels;
+	};
+
+	// keeps every packed texture at the detail its on-screen size asks for, within a VRAM budget; a texture's
+	// resident image holds its levels from some base level down, and moving that base level reloads the texture
+	// from the asset pack with more or fewer levels. Under pressure the least recently requested textures give
+	// up the levels they have beyond what they were last asked for, down to a small always-resident mip tail
+	class TextureStreamer final
+	{
+	public:
+		using StreamedTextureHandle = std::size_t;
+
+		// the budget gets clamped further by what VK_EXT_memory_budget reports as available, when the device has it
+		// and it was enabled on the logical device
+		TextureStreamer(TextureLoader& textureLoader, AssetPack const& assetPack, VkPhysicalDevice const physicalDevice, VkDeviceSize const budget, std::uint32_t const framesInFlight);
+
+		~TextureStreamer() = default;
+
+		[[nodiscard("streamed texture handle ignored!")]]
+		StreamedTextureHandle add(AssetPackEntry const& entry);
+
+		// screenSpaceSize is the number of pixels the texture spans on screen along its larger axis
+		void request(StreamedTextureHandle const streamedTextureHandle, float const screenSpaceSize);
+
+		// call once per frame, after the frame's fence wait and TextureLoader::processUploads()
+		void update();
+
+		[[nodiscard("streamed texture image view ignored!")]]
+		VkImageView getImageView(StreamedTextureHandle const streamedTextureHandle) const;
+
+		[[nodiscard("texture streamer statistics ignored!")]]
+		TextureStreamerStatistics getStatistics() const;
+
+	private:
+		struct StreamedTexture final
+		{
+			AssetPackEntry const* pEntry;
+			std::uint32_t tailLevel;
+			std::uint32_t requestedLevel;
+			std::uint64_t lastRequestedFrame;
+			std::optional<TextureLoader::TextureHandle> residentHandle;
+			std::uint32_t residentLevel;
+			std::optional<TextureLoader::TextureHandle> pendingHandle;
+			std::uint32_t pendingLevel;
+		};
+
+		struct RetiredTexture final
+		{
+			TextureLoader::TextureHandle handle;
+			std::uint64_t frame;
+		};
+
+		TextureStreamer(TextureStreamer const&) = delete;
+		TextureStreamer(TextureStreamer&&) noexcept = delete;
+
+		TextureStreamer& operator=(TextureStreamer const&) = delete;
+		TextureStreamer& operator=(TextureStreamer&&) noexcept = delete;
+
+		void promotePendingTextures();
+		void releaseRetiredTextures();
+		void evictLeastRecentlyUsed(VkDeviceSize const budget);
+		void streamIn(VkDeviceSize const budget);
+		void stream(StreamedTexture& streamedTexture, std::uint32_t const baseLevel);
+		VkDeviceSize queryBudget() const;
+		VkDeviceSize getProjectedBytes() const;
+		std::uint32_t getDesiredLevel(StreamedTexture const& streamedTexture) const;
+		std::uint32_t getTargetLevel(StreamedTexture const& streamedTexture) const;
+
+		TextureLoader& m_TextureLoader;
+		AssetPack const& m_AssetPack;
+		VkPhysicalDevice const m_PhysicalDevice;
+		VkDeviceSize const m_Budget;
+		std::uint32_t const m_FramesInFlight;
+		bool const m_IsMemoryBudgetSupported;
+
+		std::vector<StreamedTexture> m_vStreamedTextures{};
+		std::deque<RetiredTexture> m_dRetiredTextures{};
+		std::uint64_t m_Frame{};
+		VkDeviceSize m_ResidentBytes{};
+		VkDeviceSize m_LastBudget{};
+		std::size_t m_PendingRequests{};
+		std::size_t m_EvictedLevels{};
+	};
+}
+
+#endif
\ No newline at end of file
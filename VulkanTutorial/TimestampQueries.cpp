@@ -0,0 +1,74 @@
+#include "TimestampQueries.h"
+
+#include <array>
+#include <stdexcept>
+
+#pragma region Constructors/Destructor
+fro::TimestampQueries::TimestampQueries(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, std::uint32_t const framesInFlight):
+	m_LogicalDevice{ logicalDevice },
+	m_vIsRecorded(framesInFlight)
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	// covers every graphics and compute queue, so there's no need to look at the queue family's valid bits
+	if (not properties.limits.timestampComputeAndGraphics)
+		return;
+
+	m_TimestampPeriod = static_cast<double>(properties.limits.timestampPeriod);
+
+	VkQueryPoolCreateInfo const queryPoolCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO },
+		.queryType{ VK_QUERY_TYPE_TIMESTAMP },
+		.queryCount{ 2 }
+	};
+
+	for (std::uint32_t index{}; index < framesInFlight; ++index)
+	{
+		VkQueryPool queryPool;
+		if (vkCreateQueryPool(m_LogicalDevice, &queryPoolCreateInfo, nullptr, &queryPool) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateQueryPool() failed!");
+
+		m_vpQueryPools.push_back({ queryPool, std::bind(vkDestroyQueryPool, m_LogicalDevice, std::placeholders::_1, nullptr) });
+	}
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+void fro::TimestampQueries::update(std::uint32_t const frameIndex)
+{
+	if (m_vpQueryPools.empty() or not m_vIsRecorded[frameIndex])
+		return;
+
+	std::array<std::uint64_t, 2> aTimestamps;
+	if (vkGetQueryPoolResults(m_LogicalDevice, m_vpQueryPools[frameIndex].get(), 0, static_cast<std::uint32_t>(aTimestamps.size()),
+		sizeof(aTimestamps), aTimestamps.data(), sizeof(std::uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		m_FrameTime = static_cast<double>(aTimestamps[1] - aTimestamps[0]) * m_TimestampPeriod / 1'000'000.0;
+}
+
+void fro::TimestampQueries::recordBegin(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex)
+{
+	if (m_vpQueryPools.empty())
+		return;
+
+	vkCmdResetQueryPool(commandBuffer, m_vpQueryPools[frameIndex].get(), 0, 2);
+	vkCmdWriteTimestamp2(commandBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, m_vpQueryPools[frameIndex].get(), 0);
+	m_vIsRecorded[frameIndex] = true;
+}
+
+void fro::TimestampQueries::recordEnd(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex) const
+{
+	if (m_vpQueryPools.empty())
+		return;
+
+	vkCmdWriteTimestamp2(commandBuffer, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, m_vpQueryPools[frameIndex].get(), 1);
+}
+
+std::optional<double> fro::TimestampQueries::getFrameTime() const
+{
+	return m_FrameTime;
+}
+#pragma endregion PublicMethods
\ No newline at end of file
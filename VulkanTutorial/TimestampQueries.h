@@ -0,0 +1,52 @@
+#if not defined fro_TIMESTAMP_QUERIES_H
+#define fro_TIMESTAMP_QUERIES_H
+
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace fro
+{
+	// a pair of timestamps per frame in flight around the frame's GPU work, read back without waiting once the
+	// frame's fence has signaled; without timestampComputeAndGraphics, recording does nothing and there's no time
+	class TimestampQueries final
+	{
+	public:
+		TimestampQueries(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, std::uint32_t const framesInFlight);
+
+		~TimestampQueries() = default;
+
+		// reads back frameIndex's last recorded timestamps; call after the frame's fence wait
+		void update(std::uint32_t const frameIndex);
+
+		// outside a render pass, around everything the frame's time should cover
+		void recordBegin(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex);
+		void recordEnd(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex) const;
+
+		// in milliseconds, of the last frame read back; none before the first one or without support
+		[[nodiscard("GPU frame time ignored!")]]
+		std::optional<double> getFrameTime() const;
+
+	private:
+		TimestampQueries(TimestampQueries const&) = delete;
+		TimestampQueries(TimestampQueries&&) noexcept = delete;
+
+		TimestampQueries& operator=(TimestampQueries const&) = delete;
+		TimestampQueries& operator=(TimestampQueries&&) noexcept = delete;
+
+		VkDevice const m_LogicalDevice;
+		// nanoseconds per timestamp tick
+		double m_TimestampPeriod{};
+
+		// empty without support
+		std::vector<UniquePointer<VkQueryPool_T>> m_vpQueryPools{};
+		std::vector<bool> m_vIsRecorded;
+		std::optional<double> m_FrameTime{};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "Upscaler.h"
+
+#include "HelperFunctions.h"
+#include "ShaderVariants.h"
+
+#include <array>
+#include <stdexcept>
+
+namespace
+{
+	std::uint32_t constexpr g_WorkgroupSize{ 8 };
+
+	VkSamplerCreateInfo getTexelFetchSamplerCreateInfo()
+	{
+		return
+		{
+			.sType{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO },
+			.magFilter{ VK_FILTER_NEAREST },
+			.minFilter{ VK_FILTER_NEAREST },
+			.mipmapMode{ VK_SAMPLER_MIPMAP_MODE_NEAREST },
+			.addressModeU{ VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE },
+			.addressModeV{ VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE },
+			.addressModeW{ VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE },
+			.compareOp{ VK_COMPARE_OP_ALWAYS },
+			.borderColor{ VK_BORDER_COLOR_INT_OPAQUE_BLACK }
+		};
+	}
+
+	struct UpscalePushConstants final
+	{
+		std::int32_t renderWidth;
+		std::int32_t renderHeight;
+		std::int32_t outputWidth;
+		std::int32_t outputHeight;
+	};
+
+	struct SharpenPushConstants final
+	{
+		std::int32_t width;
+		std::int32_t height;
+		float sharpness;
+	};
+}
+
+#pragma region Constructors/Destructor
+fro::Upscaler::Upscaler(VkDevice const logicalDevice, LayoutCache& layoutCache, SamplerCache& samplerCache, std::uint32_t const framesInFlight):
+	m_LogicalDevice{ logicalDevice },
+	m_Sampler{ samplerCache.getSampler(getTexelFetchSamplerCreateInfo()) },
+	m_UpscaleStage{ createStage("easu.comp", layoutCache, framesInFlight) },
+	m_SharpenStage{ createStage("rcas.comp", layoutCache, framesInFlight) }
+{
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+void fro::Upscaler::recordUpscale(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex, VkImageView const sceneColor, VkExtent2D const renderExtent,
+	VkImageView const upscaledColor, VkExtent2D const outputExtent) const
+{
+	UpscalePushConstants const pushConstants
+	{
+		static_cast<std::int32_t>(renderExtent.width), static_cast<std::int32_t>(renderExtent.height),
+		static_cast<std::int32_t>(outputExtent.width), static_cast<std::int32_t>(outputExtent.height)
+	};
+
+	recordStage(commandBuffer, m_UpscaleStage, frameIndex, sceneColor, upscaledColor, outputExtent, &pushConstants, sizeof(pushConstants));
+}
+
+void fro::Upscaler::recordSharpen(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex, VkImageView const upscaledColor, VkImageView const sharpenedColor,
+	VkExtent2D const extent, float const sharpness) const
+{
+	SharpenPushConstants const pushConstants{ static_cast<std::int32_t>(extent.width), static_cast<std::int32_t>(extent.height), sharpness };
+
+	recordStage(commandBuffer, m_SharpenStage, frameIndex, upscaledColor, sharpenedColor, extent, &pushConstants, sizeof(pushConstants));
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+fro::Upscaler::Stage fro::Upscaler::createStage(std::string_view const shaderName, LayoutCache& layoutCache, std::uint32_t const framesInFlight) const
+{
+	Stage stage{ .vShaderBytecode{ ShaderVariants{ "Shaders", shaderName, shaderc_shader_kind::shaderc_compute_shader }.getBytecode({}) } };
+	stage.shaderReflection = reflectShader(stage.vShaderBytecode, VK_SHADER_STAGE_COMPUTE_BIT);
+	stage.vDescriptorSetLayouts = layoutCache.getDescriptorSetLayouts(stage.shaderReflection);
+	stage.pipelineLayout = layoutCache.getPipelineLayout(stage.vDescriptorSetLayouts, stage.shaderReflection.vPushConstantRanges);
+	stage.pPipeline = { createComputePipeline(m_LogicalDevice, stage.pipelineLayout, stage.vShaderBytecode), std::bind(vkDestroyPipeline, m_LogicalDevice, std::placeholders::_1, nullptr) };
+	stage.pDescriptorPool =
+	{
+		createDescriptorPool(stage.shaderReflection.vvDescriptorSetLayoutBindings.at(0), framesInFlight, m_LogicalDevice),
+		std::bind(vkDestroyDescriptorPool, m_LogicalDevice, std::placeholders::_1, nullptr)
+	};
+
+	std::vector<VkDescriptorSetLayout> const vLayouts(framesInFlight, stage.vDescriptorSetLayouts.at(0));
+	VkDescriptorSetAllocateInfo const allocationInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO },
+		.descriptorPool{ stage.pDescriptorPool.get() },
+		.descriptorSetCount{ static_cast<std::uint32_t>(vLayouts.size()) },
+		.pSetLayouts{ vLayouts.data() }
+	};
+
+	stage.vDescriptorSets.resize(vLayouts.size());
+	if (vkAllocateDescriptorSets(m_LogicalDevice, &allocationInfo, stage.vDescriptorSets.data()) != VK_SUCCESS)
+		throw std::runtime_error("vkAllocateDescriptorSets() failed!");
+
+	return stage;
+}
+
+void fro::Upscaler::recordStage(VkCommandBuffer const commandBuffer, Stage const& stage, std::uint32_t const frameIndex, VkImageView const input, VkImageView const output,
+	VkExtent2D const dispatchExtent, void const* const pPushConstants, std::uint32_t const pushConstantsSize) const
+{
+	// the frame's fence wait has freed its descriptor set up
+	VkDescriptorImageInfo const inputInfo{ m_Sampler, input, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+	VkDescriptorImageInfo const outputInfo{ VK_NULL_HANDLE, output, VK_IMAGE_LAYOUT_GENERAL };
+
+	std::array<VkWriteDescriptorSet, 2> const aDescriptorWrites
+	{
+		VkWriteDescriptorSet
+		{
+			.sType{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET },
+			.dstSet{ stage.vDescriptorSets[frameIndex] },
+			.dstBinding{ 0 },
+			.descriptorCount{ 1 },
+			.descriptorType{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER },
+			.pImageInfo{ &inputInfo }
+		},
+		VkWriteDescriptorSet
+		{
+			.sType{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET },
+			.dstSet{ stage.vDescriptorSets[frameIndex] },
+			.dstBinding{ 1 },
+			.descriptorCount{ 1 },
+			.descriptorType{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE },
+			.pImageInfo{ &outputInfo }
+		}
+	};
+
+	vkUpdateDescriptorSets(m_LogicalDevice, static_cast<std::uint32_t>(aDescriptorWrites.size()), aDescriptorWrites.data(), 0, nullptr);
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, stage.pPipeline.get());
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, stage.pipelineLayout, 0, 1, &stage.vDescriptorSets[frameIndex], 0, nullptr);
+	vkCmdPushConstants(commandBuffer, stage.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, pushConstantsSize, pPushConstants);
+	vkCmdDispatch(commandBuffer, (dispatchExtent.width + g_WorkgroupSize - 1) / g_WorkgroupSize, (dispatchExtent.height + g_WorkgroupSize - 1) / g_WorkgroupSize, 1);
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
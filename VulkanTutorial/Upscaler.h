@@ -0,0 +1,73 @@
+#if not defined fro_UPSCALER_H
+#define fro_UPSCALER_H
+
+#include "LayoutCache.h"
+#include "SamplerCache.h"
+#include "ShaderReflection.h"
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace fro
+{
+	// what the upscaled and sharpened images have to be in; both compute shaders store to rgba16f
+	VkFormat constexpr g_UpscaledColorFormat{ VK_FORMAT_R16G16B16A16_SFLOAT };
+
+	// brings a scene rendered below the output resolution up to it in two compute passes, after FSR 1: an edge
+	// adaptive upscale, then a contrast adaptive sharpen that restores what the upscale softened. Each pass
+	// rewrites its frame's descriptor set as it's recorded, so the images can change from frame to frame
+	class Upscaler final
+	{
+	public:
+		Upscaler(VkDevice const logicalDevice, LayoutCache& layoutCache, SamplerCache& samplerCache, std::uint32_t const framesInFlight);
+
+		~Upscaler() = default;
+
+		// outside a render pass; reads the top left renderExtent of sceneColor as ComputeSampledRead, and writes
+		// all of upscaledColor's outputExtent as ComputeStorageWrite
+		void recordUpscale(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex, VkImageView const sceneColor, VkExtent2D const renderExtent,
+			VkImageView const upscaledColor, VkExtent2D const outputExtent) const;
+
+		// outside a render pass; reads upscaledColor as ComputeSampledRead and writes sharpenedColor as
+		// ComputeStorageWrite, both extent large. A sharpness of 0 leaves the image as it is, 1 sharpens the most
+		void recordSharpen(VkCommandBuffer const commandBuffer, std::uint32_t const frameIndex, VkImageView const upscaledColor, VkImageView const sharpenedColor,
+			VkExtent2D const extent, float const sharpness) const;
+
+	private:
+		struct Stage final
+		{
+			std::vector<std::uint32_t> vShaderBytecode;
+			ShaderReflection shaderReflection;
+			std::vector<VkDescriptorSetLayout> vDescriptorSetLayouts;
+			VkPipelineLayout pipelineLayout;
+			UniquePointer<VkPipeline_T> pPipeline;
+			UniquePointer<VkDescriptorPool_T> pDescriptorPool;
+			std::vector<VkDescriptorSet> vDescriptorSets;
+		};
+
+		Upscaler(Upscaler const&) = delete;
+		Upscaler(Upscaler&&) noexcept = delete;
+
+		Upscaler& operator=(Upscaler const&) = delete;
+		Upscaler& operator=(Upscaler&&) noexcept = delete;
+
+		[[nodiscard("upscaler stage ignored!")]]
+		Stage createStage(std::string_view const shaderName, LayoutCache& layoutCache, std::uint32_t const framesInFlight) const;
+
+		// binds input as a sampled image at binding 0 and output as a storage image at binding 1
+		void recordStage(VkCommandBuffer const commandBuffer, Stage const& stage, std::uint32_t const frameIndex, VkImageView const input, VkImageView const output,
+			VkExtent2D const dispatchExtent, void const* const pPushConstants, std::uint32_t const pushConstantsSize) const;
+
+		VkDevice const m_LogicalDevice;
+		// the shaders only fetch texels, which ignores filtering
+		VkSampler const m_Sampler;
+		Stage const m_UpscaleStage;
+		Stage const m_SharpenStage;
+	};
+}
+
+#endif
\ No newline at end of file
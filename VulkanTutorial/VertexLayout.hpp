@@ -0,0 +1,129 @@
+#if not defined fro_VERTEX_LAYOUT_HPP
+#define fro_VERTEX_LAYOUT_HPP
+
+#include <Vulkan/vulkan_core.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace fro
+{
+	// IEEE 754 half floats, which the vertex input stage widens back to floats
+	template<glm::length_t LENGTH>
+	struct HalfVector final
+	{
+		static VkFormat constexpr format{ std::array{ VK_FORMAT_R16_SFLOAT, VK_FORMAT_R16G16_SFLOAT, VK_FORMAT_R16G16B16_SFLOAT, VK_FORMAT_R16G16B16A16_SFLOAT }[LENGTH - 1] };
+
+		HalfVector() = default;
+
+		explicit HalfVector(glm::vec<LENGTH, float> const& value):
+			bits{ glm::packHalf(value) }
+		{
+		}
+
+		glm::vec<LENGTH, std::uint16_t> bits;
+	};
+
+	// fixed point in [0, 1] for unsigned components and [-1, 1] for signed ones, which the vertex input stage
+	// normalizes back to floats
+	template<glm::length_t LENGTH, typename COMPONENT_TYPE>
+	struct NormalizedVector final
+	{
+		static_assert(std::is_integral_v<COMPONENT_TYPE> and sizeof(COMPONENT_TYPE) <= 2, "NormalizedVector takes 8 or 16 bit integer components!");
+
+		static VkFormat constexpr format
+		{
+			std::is_same_v<COMPONENT_TYPE, std::uint8_t> ?
+			std::array{ VK_FORMAT_R8_UNORM, VK_FORMAT_R8G8_UNORM, VK_FORMAT_R8G8B8_UNORM, VK_FORMAT_R8G8B8A8_UNORM }[LENGTH - 1] :
+			std::is_same_v<COMPONENT_TYPE, std::int8_t> ?
+			std::array{ VK_FORMAT_R8_SNORM, VK_FORMAT_R8G8_SNORM, VK_FORMAT_R8G8B8_SNORM, VK_FORMAT_R8G8B8A8_SNORM }[LENGTH - 1] :
+			std::is_same_v<COMPONENT_TYPE, std::uint16_t> ?
+			std::array{ VK_FORMAT_R16_UNORM, VK_FORMAT_R16G16_UNORM, VK_FORMAT_R16G16B16_UNORM, VK_FORMAT_R16G16B16A16_UNORM }[LENGTH - 1] :
+			std::array{ VK_FORMAT_R16_SNORM, VK_FORMAT_R16G16_SNORM, VK_FORMAT_R16G16B16_SNORM, VK_FORMAT_R16G16B16A16_SNORM }[LENGTH - 1]
+		};
+
+		NormalizedVector() = default;
+
+		// values outside the representable range get clamped
+		explicit NormalizedVector(glm::vec<LENGTH, float> const& value):
+			components{ pack(value) }
+		{
+		}
+
+		glm::vec<LENGTH, COMPONENT_TYPE> components;
+
+	private:
+		static glm::vec<LENGTH, COMPONENT_TYPE> pack(glm::vec<LENGTH, float> const& value)
+		{
+			if constexpr (std::is_signed_v<COMPONENT_TYPE>)
+				return glm::packSnorm<COMPONENT_TYPE>(value);
+			else
+				return glm::packUnorm<COMPONENT_TYPE>(value);
+		}
+	};
+
+	template<typename ATTRIBUTE_TYPE>
+	struct VertexAttributeFormat final
+	{
+		static VkFormat constexpr format{ ATTRIBUTE_TYPE::format };
+	};
+
+	template<glm::length_t LENGTH, glm::qualifier QUALIFIER>
+	struct VertexAttributeFormat<glm::vec<LENGTH, float, QUALIFIER>> final
+	{
+		static VkFormat constexpr format{ std::array{ VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT }[LENGTH - 1] };
+	};
+
+	struct VertexAttribute final
+	{
+		VkFormat format;
+		std::uint32_t offset;
+	};
+
+	template<typename ATTRIBUTE_TYPE>
+	[[nodiscard("vertex attribute ignored!")]]
+	VertexAttribute consteval describeVertexAttribute(std::size_t const offset)
+	{
+		return { VertexAttributeFormat<ATTRIBUTE_TYPE>::format, static_cast<std::uint32_t>(offset) };
+	}
+
+	// specialised right after each vertex type, with a static constexpr aAttributes array of describeVertexAttribute()
+	// results; an attribute's index in that array is its shader location
+	template<typename VERTEX_TYPE>
+	struct VertexLayout;
+
+	template<typename VERTEX_TYPE>
+	[[nodiscard("vertex binding description ignored!")]]
+	VkVertexInputBindingDescription constexpr getVertexBindingDescription(std::uint32_t const binding = 0)
+	{
+		return VkVertexInputBindingDescription
+		{
+			.binding{ binding },
+			.stride{ sizeof(VERTEX_TYPE) },
+			.inputRate{ VK_VERTEX_INPUT_RATE_VERTEX }
+		};
+	}
+
+	template<typename VERTEX_TYPE>
+	[[nodiscard("vertex attribute descriptions ignored!")]]
+	auto constexpr getVertexAttributeDescriptions(std::uint32_t const binding = 0)
+	{
+		std::array<VkVertexInputAttributeDescription, VertexLayout<VERTEX_TYPE>::aAttributes.size()> aAttributeDescriptions{};
+		for (std::uint32_t location{}; location < aAttributeDescriptions.size(); ++location)
+			aAttributeDescriptions[location] =
+			{
+				.location{ location },
+				.binding{ binding },
+				.format{ VertexLayout<VERTEX_TYPE>::aAttributes[location].format },
+				.offset{ VertexLayout<VERTEX_TYPE>::aAttributes[location].offset }
+			};
+
+		return aAttributeDescriptions;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,900 @@
+#include "VirtualTexture.h"
+
+#include "BarrierBuilder.h"
+#include "HelperFunctions.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+namespace
+{
+	// caps the upload work a single frame can cause; coarse tiles go first, so a sudden jump in detail blurs
+	// in over a few frames instead of stalling one
+	std::size_t constexpr g_MaxTileUploadsPerFrame{ 32 };
+
+	bool isSparseResidencySupported(VkPhysicalDevice const physicalDevice, std::uint32_t const queueFamilyIndex, fro::AssetPackEntry const& entry)
+	{
+		VkPhysicalDeviceFeatures features;
+		vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+
+		if (not features.sparseBinding or not features.sparseResidencyImage2D)
+			return false;
+
+		if (not (fro::getAvailableQueueFamilies(physicalDevice)[queueFamilyIndex].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT))
+			return false;
+
+		std::uint32_t propertyCount;
+		vkGetPhysicalDeviceSparseImageFormatProperties(physicalDevice, entry.format, VK_IMAGE_TYPE_2D, VK_SAMPLE_COUNT_1_BIT,
+			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_TILING_OPTIMAL, &propertyCount, nullptr);
+
+		std::vector<VkSparseImageFormatProperties> vProperties(propertyCount);
+		vkGetPhysicalDeviceSparseImageFormatProperties(physicalDevice, entry.format, VK_IMAGE_TYPE_2D, VK_SAMPLE_COUNT_1_BIT,
+			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_TILING_OPTIMAL, &propertyCount, vProperties.data());
+
+		// a sparse block has to be exactly one packed tile, so tiles can be bound and copied one to one
+		return std::ranges::any_of(vProperties,
+			[&entry](VkSparseImageFormatProperties const& properties)
+			{
+				return
+					properties.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT and
+					not (properties.flags & VK_SPARSE_IMAGE_FORMAT_NONSTANDARD_BLOCK_SIZE_BIT) and
+					properties.imageGranularity.width == entry.tileSize and
+					properties.imageGranularity.height == entry.tileSize;
+			});
+	}
+
+	VkCommandPool createUploadCommandPool(VkDevice const logicalDevice, std::uint32_t const queueFamilyIndex)
+	{
+		VkCommandPoolCreateInfo const commandPoolCreateInfo
+		{
+			.sType{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO },
+			.flags{ VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT },
+			.queueFamilyIndex{ queueFamilyIndex }
+		};
+
+		VkCommandPool commandPool;
+		if (vkCreateCommandPool(logicalDevice, &commandPoolCreateInfo, nullptr, &commandPool) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateCommandPool() failed!");
+
+		return commandPool;
+	}
+
+	VkDeviceMemory allocateMemory(VkDevice const logicalDevice, VkDeviceSize const size, std::uint32_t const memoryTypeIndex)
+	{
+		VkMemoryAllocateInfo const allocationInfo
+		{
+			.sType{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO },
+			.allocationSize{ size },
+			.memoryTypeIndex{ memoryTypeIndex }
+		};
+
+		VkDeviceMemory memory;
+		if (vkAllocateMemory(logicalDevice, &allocationInfo, nullptr, &memory) != VK_SUCCESS)
+			throw std::runtime_error("vkAllocateMemory() failed!");
+
+		return memory;
+	}
+}
+
+#pragma region Constructors/Destructor
+fro::VirtualTexture::VirtualTexture(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, VkQueue const graphicsQueue, std::uint32_t const graphicsQueueFamilyIndex,
+	SamplerCache& samplerCache, AssetPack const& assetPack, AssetPackEntry const& entry, std::uint32_t const framesInFlight, std::uint32_t const physicalTileCount)
+	: m_LogicalDevice{ logicalDevice }
+	, m_PhysicalDevice{ physicalDevice }
+	, m_GraphicsQueue{ graphicsQueue }
+	, m_AssetPack{ assetPack }
+	, m_Entry{ entry }
+	, m_FramesInFlight{ framesInFlight }
+	, m_PhysicalTileCount{ physicalTileCount }
+	, m_IsSparse{ entry.tileSize != 0 and isSparseResidencySupported(physicalDevice, graphicsQueueFamilyIndex, entry) }
+	, m_pCommandPool{ createUploadCommandPool(logicalDevice, graphicsQueueFamilyIndex), std::bind(vkDestroyCommandPool, logicalDevice, std::placeholders::_1, nullptr) }
+{
+	if (entry.tileSize == 0)
+		throw std::runtime_error(std::format("{} is not a virtual texture!", getName(entry)));
+
+	// the fragment shader reports the tiles it sampled through a storage buffer
+	VkPhysicalDeviceFeatures features;
+	vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+	if (not features.fragmentStoresAndAtomics)
+		throw std::runtime_error("virtual texturing requires fragmentStoresAndAtomics!");
+
+	createTiles();
+
+	if (m_IsSparse)
+		createSparseImage();
+	else
+		createAtlasImage();
+
+	createPageTable(samplerCache);
+	createFeedbackBuffers();
+	createParametersBuffer();
+
+	VkCommandBufferAllocateInfo const allocateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO },
+		.commandPool{ m_pCommandPool.get() },
+		.level{ VK_COMMAND_BUFFER_LEVEL_PRIMARY },
+		.commandBufferCount{ framesInFlight }
+	};
+
+	m_vUploadCommandBuffers.resize(framesInFlight);
+	if (vkAllocateCommandBuffers(m_LogicalDevice, &allocateInfo, m_vUploadCommandBuffers.data()) != VK_SUCCESS)
+		throw std::runtime_error("vkAllocateCommandBuffers() failed!");
+
+	m_vpUploadFences = createFences(m_LogicalDevice, framesInFlight);
+	m_vpBindSemaphores = createSemaphores(m_LogicalDevice, framesInFlight);
+	m_vpStagingBuffers.resize(framesInFlight);
+
+	uploadPinnedTiles();
+}
+
+fro::VirtualTexture::~VirtualTexture()
+{
+	for (UniquePointer<VkFence_T> const& pFence : m_vpUploadFences)
+	{
+		VkFence const fence{ pFence.get() };
+		vkWaitForFences(m_LogicalDevice, 1, &fence, VK_TRUE, UINT64_MAX);
+	}
+}
+#pragma endregion Constructors/Destructor
+
+
+
+#pragma region PublicMethods
+void fro::VirtualTexture::update(std::uint32_t const frameIndex)
+{
+	VkFence const fence{ m_vpUploadFences[frameIndex].get() };
+	vkWaitForFences(m_LogicalDevice, 1, &fence, VK_TRUE, UINT64_MAX);
+	m_vpStagingBuffers[frameIndex] = {};
+
+	++m_Frame;
+
+	std::vector<std::uint32_t> vRequestedTiles{ readFeedback(frameIndex) };
+	m_RequestedTiles = vRequestedTiles.size();
+
+	// coarse tiles first: they cover the most screen, and a tile is only made resident after its parent
+	std::ranges::stable_sort(vRequestedTiles, std::ranges::greater{}, [this](std::uint32_t const tileIndex) { return m_vTiles[tileIndex].level; });
+
+	// evicted slots only come back frames later, so a request that finds none evicts a tile for later
+	// instead, unless enough slots are on their way back already
+	std::vector<std::uint32_t> vUploadedTiles{};
+	std::vector<VkSparseImageMemoryBind> vBinds{};
+	std::size_t awaitedSlots{};
+	for (std::uint32_t const tileIndex : vRequestedTiles)
+	{
+		if (vUploadedTiles.size() + awaitedSlots == g_MaxTileUploadsPerFrame)
+			break;
+
+		Tile const& tile{ m_vTiles[tileIndex] };
+		if (tile.level + 1 < m_Entry.levelCount and not m_vTiles[getParentIndex(tile)].isResident)
+			continue;
+
+		std::optional<std::uint32_t> const slot{ allocateSlot(vBinds) };
+		if (not slot.has_value())
+		{
+			if (awaitedSlots < m_dRetiredSlots.size() or evictTile())
+			{
+				++awaitedSlots;
+				continue;
+			}
+
+			break;
+		}
+
+		makeResident(tileIndex, *slot);
+		if (m_IsSparse)
+			vBinds.push_back(createSparseImageMemoryBind(tile, m_pTileMemory.get()));
+
+		vUploadedTiles.push_back(tileIndex);
+	}
+
+	// evictions alone still have to reach the page table, or the retired slots would be sampled regardless
+	bool const isPageTableDirty{ std::ranges::any_of(m_vDirtyRegions, [](std::optional<TileRegion> const& region) { return region.has_value(); }) };
+	if (vUploadedTiles.empty() and not isPageTableDirty)
+		return;
+
+	m_UploadedTiles += vUploadedTiles.size();
+	updatePageTable();
+
+	VkCommandBuffer const commandBuffer{ m_vUploadCommandBuffers[frameIndex] };
+	vkResetCommandBuffer(commandBuffer, 0);
+
+	VkCommandBufferBeginInfo const beginInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO },
+		.flags{ VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT }
+	};
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+		throw std::runtime_error("vkBeginCommandBuffer() failed!");
+
+	m_vpStagingBuffers[frameIndex] = recordUploads(commandBuffer, vUploadedTiles, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+		throw std::runtime_error("vkEndCommandBuffer() failed!");
+
+	// sparse binding happens on the queue but outside of command buffers, so the copies wait on it explicitly
+	VkSemaphore const bindSemaphore{ m_vpBindSemaphores[frameIndex].get() };
+	if (m_IsSparse)
+		bindSparse(vBinds, std::nullopt, bindSemaphore);
+
+	VkPipelineStageFlags const waitStage{ VK_PIPELINE_STAGE_TRANSFER_BIT };
+	VkSubmitInfo const submitInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_SUBMIT_INFO },
+		.waitSemaphoreCount{ m_IsSparse ? 1u : 0u },
+		.pWaitSemaphores{ &bindSemaphore },
+		.pWaitDstStageMask{ &waitStage },
+		.commandBufferCount{ 1 },
+		.pCommandBuffers{ &commandBuffer }
+	};
+
+	vkResetFences(m_LogicalDevice, 1, &fence);
+	if (vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS)
+		throw std::runtime_error("vkQueueSubmit() failed!");
+}
+
+bool fro::VirtualTexture::isSparse() const
+{
+	return m_IsSparse;
+}
+
+VkImageView fro::VirtualTexture::getPageTableImageView() const
+{
+	return m_pPageTableImageView.get();
+}
+
+VkSampler fro::VirtualTexture::getPageTableSampler() const
+{
+	return m_PageTableSampler;
+}
+
+VkImageView fro::VirtualTexture::getPhysicalImageView() const
+{
+	return m_pPhysicalImageView.get();
+}
+
+VkBuffer fro::VirtualTexture::getFeedbackBuffer(std::uint32_t const frameIndex) const
+{
+	return m_vFeedbackBuffers[frameIndex].pBuffer.first.get();
+}
+
+VkBuffer fro::VirtualTexture::getParametersBuffer() const
+{
+	return m_pParametersBuffer.first.get();
+}
+
+fro::VirtualTextureStatistics fro::VirtualTexture::getStatistics() const
+{
+	return
+	{
+		.residentTiles{ static_cast<std::size_t>(std::ranges::count_if(m_vTiles, &Tile::isResident)) },
+		.physicalTiles{ m_vSlotTiles.size() },
+		.requestedTiles{ m_RequestedTiles },
+		.uploadedTiles{ m_UploadedTiles },
+		.evictedTiles{ m_EvictedTiles }
+	};
+}
+#pragma endregion PublicMethods
+
+
+
+#pragma region PrivateMethods
+void fro::VirtualTexture::createTiles()
+{
+	for (std::uint32_t level{}; level < m_Entry.levelCount; ++level)
+	{
+		m_vLevels.push_back({ getTileCountX(m_Entry, level), getTileCountY(m_Entry, level), static_cast<std::uint32_t>(m_vTiles.size()) });
+
+		for (std::uint32_t y{}; y < m_vLevels.back().tileCountY; ++y)
+			for (std::uint32_t x{}; x < m_vLevels.back().tileCountX; ++x)
+				m_vTiles.push_back({ .level{ level }, .x{ x }, .y{ y } });
+	}
+
+	m_vDirtyRegions.resize(m_Entry.levelCount);
+
+	// one slot on top of the requested ones for the coarsest tile, which never leaves
+	m_vSlotTiles.resize(m_PhysicalTileCount + 1);
+	for (std::uint32_t slot{ m_PhysicalTileCount + 1 }; slot-- > 0;)
+		m_vFreeSlots.push_back(slot);
+}
+
+void fro::VirtualTexture::createSparseImage()
+{
+	VkImageCreateInfo const imageCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO },
+		.flags{ VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT },
+		.imageType{ VK_IMAGE_TYPE_2D },
+		.format{ m_Entry.format },
+		.extent{ m_Entry.aLevels[0].width, m_Entry.aLevels[0].height, 1 },
+		.mipLevels{ m_Entry.levelCount },
+		.arrayLayers{ 1 },
+		.samples{ VK_SAMPLE_COUNT_1_BIT },
+		.tiling{ VK_IMAGE_TILING_OPTIMAL },
+		.usage{ VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT },
+		.sharingMode{ VK_SHARING_MODE_EXCLUSIVE },
+		.initialLayout{ VK_IMAGE_LAYOUT_UNDEFINED }
+	};
+
+	VkImage image;
+	if (vkCreateImage(m_LogicalDevice, &imageCreateInfo, nullptr, &image) != VK_SUCCESS)
+		throw std::runtime_error("vkCreateImage() failed!");
+
+	m_pPhysicalImage = { image, std::bind(vkDestroyImage, m_LogicalDevice, std::placeholders::_1, nullptr) };
+
+	VkMemoryRequirements memoryRequirements;
+	vkGetImageMemoryRequirements(m_LogicalDevice, image, &memoryRequirements);
+	if (memoryRequirements.alignment != m_Entry.tileBytes)
+		throw std::runtime_error(std::format("sparse pages are {} bytes, expected {}!", memoryRequirements.alignment, m_Entry.tileBytes));
+
+	std::uint32_t requirementCount;
+	vkGetImageSparseMemoryRequirements(m_LogicalDevice, image, &requirementCount, nullptr);
+
+	std::vector<VkSparseImageMemoryRequirements> vRequirements(requirementCount);
+	vkGetImageSparseMemoryRequirements(m_LogicalDevice, image, &requirementCount, vRequirements.data());
+
+	auto const colorRequirements{ std::ranges::find_if(vRequirements,
+		[](VkSparseImageMemoryRequirements const& requirements) { return requirements.formatProperties.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT; }) };
+	if (colorRequirements == vRequirements.end())
+		throw std::runtime_error("vkGetImageSparseMemoryRequirements() returned no color requirements!");
+
+	std::uint32_t const memoryTypeIndex{ getMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_PhysicalDevice) };
+	m_pTileMemory = { allocateMemory(m_LogicalDevice, m_vSlotTiles.size() * memoryRequirements.alignment, memoryTypeIndex), std::bind(vkFreeMemory, m_LogicalDevice, std::placeholders::_1, nullptr) };
+
+	// levels smaller than a sparse block share the mip tail, which is bound as a whole and stays resident
+	m_MipTailFirstLevel = std::min(colorRequirements->imageMipTailFirstLod, m_Entry.levelCount);
+	if (m_MipTailFirstLevel < m_Entry.levelCount)
+	{
+		m_MipTailBind =
+		{
+			.resourceOffset{ colorRequirements->imageMipTailOffset },
+			.size{ colorRequirements->imageMipTailSize }
+		};
+
+		m_pMipTailMemory = { allocateMemory(m_LogicalDevice, colorRequirements->imageMipTailSize, memoryTypeIndex), std::bind(vkFreeMemory, m_LogicalDevice, std::placeholders::_1, nullptr) };
+		m_MipTailBind->memory = m_pMipTailMemory.get();
+	}
+
+	m_pPhysicalImageView = createImageView(image, m_Entry.format, m_LogicalDevice, m_Entry.levelCount);
+}
+
+void fro::VirtualTexture::createAtlasImage()
+{
+	std::uint32_t const slotCount{ static_cast<std::uint32_t>(m_vSlotTiles.size()) };
+	while (m_AtlasTileCountX * m_AtlasTileCountX < slotCount)
+		++m_AtlasTileCountX;
+
+	m_AtlasTileCountY = (slotCount + m_AtlasTileCountX - 1) / m_AtlasTileCountX;
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
+
+	// page table entries address atlas tiles with 8 bits per axis
+	if (m_AtlasTileCountX > 256 or m_AtlasTileCountX * m_Entry.tileSize > properties.limits.maxImageDimension2D)
+		throw std::runtime_error(std::format("{} physical tiles don't fit in a single atlas!", slotCount));
+
+	auto pImage
+	{
+		createImage(m_LogicalDevice, m_PhysicalDevice,
+			m_AtlasTileCountX * m_Entry.tileSize, m_AtlasTileCountY * m_Entry.tileSize, 1,
+			m_Entry.format, VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+	};
+
+	m_pPhysicalImage = std::move(pImage.first);
+	m_pTileMemory = std::move(pImage.second);
+	m_pPhysicalImageView = createImageView(m_pPhysicalImage.get(), m_Entry.format, m_LogicalDevice, 1);
+	m_MipTailFirstLevel = m_Entry.levelCount;
+}
+
+void fro::VirtualTexture::createPageTable(SamplerCache& samplerCache)
+{
+	// a page table level is a mip level, so the base is made large enough for every level's tile grid to fit
+	// in the mip it ends up in
+	std::uint32_t width{};
+	std::uint32_t height{};
+	for (std::uint32_t level{}; level < m_Entry.levelCount; ++level)
+	{
+		width = std::max(width, m_vLevels[level].tileCountX << level);
+		height = std::max(height, m_vLevels[level].tileCountY << level);
+	}
+
+	m_pPageTableImage = createImage(m_LogicalDevice, m_PhysicalDevice, width, height, m_Entry.levelCount,
+		VK_FORMAT_R8G8B8A8_UINT, VK_IMAGE_TILING_OPTIMAL,
+		VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	m_pPageTableImageView = createImageView(m_pPageTableImage.first.get(), VK_FORMAT_R8G8B8A8_UINT, m_LogicalDevice, m_Entry.levelCount);
+
+	VkSamplerCreateInfo const samplerCreateInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO },
+		.magFilter{ VK_FILTER_NEAREST },
+		.minFilter{ VK_FILTER_NEAREST },
+		.mipmapMode{ VK_SAMPLER_MIPMAP_MODE_NEAREST },
+		.addressModeU{ VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE },
+		.addressModeV{ VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE },
+		.addressModeW{ VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE },
+		.maxLod{ VK_LOD_CLAMP_NONE }
+	};
+
+	m_PageTableSampler = samplerCache.getSampler(samplerCreateInfo);
+	m_vPageTable.resize(m_vTiles.size());
+}
+
+void fro::VirtualTexture::createFeedbackBuffers()
+{
+	VkDeviceSize const size{ m_vTiles.size() * sizeof(std::uint32_t) };
+
+	for (std::uint32_t index{}; index < m_FramesInFlight; ++index)
+	{
+		FeedbackBuffer feedbackBuffer
+		{
+			.pBuffer
+			{
+				createBuffer(m_LogicalDevice, m_PhysicalDevice,
+					size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+					VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+			}
+		};
+
+		void* pData;
+		if (vkMapMemory(m_LogicalDevice, feedbackBuffer.pBuffer.second.get(), 0, size, 0, &pData) != VK_SUCCESS)
+			throw std::runtime_error("vkMapMemory() failed!");
+
+		feedbackBuffer.pMappedData = static_cast<std::uint32_t*>(pData);
+		std::memset(pData, 0, static_cast<std::size_t>(size));
+
+		m_vFeedbackBuffers.push_back(std::move(feedbackBuffer));
+	}
+}
+
+void fro::VirtualTexture::createParametersBuffer()
+{
+	VirtualTextureParameters parameters
+	{
+		.virtualSize{ m_Entry.aLevels[0].width, m_Entry.aLevels[0].height, m_Entry.levelCount, 0u },
+		.physicalLayout{ m_AtlasTileCountX, m_AtlasTileCountY, m_Entry.tileSize, 0u }
+	};
+
+	for (std::uint32_t level{}; level < m_Entry.levelCount; ++level)
+		parameters.aLevels[level] = { m_vLevels[level].tileCountX, m_vLevels[level].tileCountY, m_vLevels[level].firstTile, 0u };
+
+	m_pParametersBuffer = createBuffer(m_LogicalDevice, m_PhysicalDevice,
+		sizeof(parameters), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	void* pData;
+	if (vkMapMemory(m_LogicalDevice, m_pParametersBuffer.second.get(), 0, sizeof(parameters), 0, &pData) != VK_SUCCESS)
+		throw std::runtime_error("vkMapMemory() failed!");
+
+	std::memcpy(pData, &parameters, sizeof(parameters));
+	vkUnmapMemory(m_LogicalDevice, m_pParametersBuffer.second.get());
+}
+
+void fro::VirtualTexture::uploadPinnedTiles()
+{
+	// the coarsest level and the mip tail are what every lookup falls back to, so they never leave
+	std::vector<std::uint32_t> vPinnedTiles{};
+	std::vector<VkSparseImageMemoryBind> vBinds{};
+	for (std::uint32_t tileIndex{}; tileIndex < m_vTiles.size(); ++tileIndex)
+	{
+		Tile& tile{ m_vTiles[tileIndex] };
+		if (tile.level + 1 < m_Entry.levelCount and tile.level < m_MipTailFirstLevel)
+			continue;
+
+		tile.isPinned = true;
+		if (tile.level >= m_MipTailFirstLevel)
+			tile.isResident = true;
+		else
+		{
+			std::uint32_t const slot{ m_vFreeSlots.back() };
+			m_vFreeSlots.pop_back();
+
+			makeResident(tileIndex, slot);
+			if (m_IsSparse)
+				vBinds.push_back(createSparseImageMemoryBind(tile, m_pTileMemory.get()));
+		}
+
+		vPinnedTiles.push_back(tileIndex);
+	}
+
+	for (std::uint32_t level{}; level < m_Entry.levelCount; ++level)
+		m_vDirtyRegions[level] = { 0, 0, m_vLevels[level].tileCountX - 1, m_vLevels[level].tileCountY - 1 };
+
+	updatePageTable();
+
+	if (m_IsSparse)
+	{
+		bindSparse(vBinds, m_MipTailBind, VK_NULL_HANDLE);
+		vkQueueWaitIdle(m_GraphicsQueue);
+	}
+
+	VkCommandBuffer const commandBuffer{ beginSingleTimeCommands(m_pCommandPool.get(), m_LogicalDevice) };
+	auto const pStagingBuffer{ recordUploads(commandBuffer, vPinnedTiles, VK_IMAGE_LAYOUT_UNDEFINED) };
+	endSingleTimeCommands(commandBuffer, m_GraphicsQueue, m_pCommandPool.get(), m_LogicalDevice);
+}
+
+std::vector<std::uint32_t> fro::VirtualTexture::readFeedback(std::uint32_t const frameIndex)
+{
+	std::uint32_t* const pFeedback{ m_vFeedbackBuffers[frameIndex].pMappedData };
+
+	// a requested tile keeps its ancestors alive too, and any of them that aren't resident get requested as well
+	std::vector<std::uint32_t> vRequestedTiles{};
+	for (std::uint32_t tileIndex{}; tileIndex < m_vTiles.size(); ++tileIndex)
+	{
+		if (pFeedback[tileIndex] == 0)
+			continue;
+
+		pFeedback[tileIndex] = 0;
+
+		for (std::uint32_t ancestorIndex{ tileIndex };;)
+		{
+			Tile& ancestor{ m_vTiles[ancestorIndex] };
+			if (ancestor.lastRequestedFrame == m_Frame)
+				break;
+
+			ancestor.lastRequestedFrame = m_Frame;
+			if (not ancestor.isResident)
+				vRequestedTiles.push_back(ancestorIndex);
+
+			if (ancestor.level + 1 == m_Entry.levelCount)
+				break;
+
+			ancestorIndex = getParentIndex(ancestor);
+		}
+	}
+
+	return vRequestedTiles;
+}
+
+std::optional<std::uint32_t> fro::VirtualTexture::allocateSlot(std::vector<VkSparseImageMemoryBind>& vBinds)
+{
+	if (not m_vFreeSlots.empty())
+	{
+		std::uint32_t const slot{ m_vFreeSlots.back() };
+		m_vFreeSlots.pop_back();
+
+		return slot;
+	}
+
+	// sparse binding isn't ordered against the frames that may still sample a retired slot, but it is against
+	// the fence wait this frame started with; slots of tiles requested again this frame wait another frame, so
+	// that their unbind never lands in the same batch as their rebind
+	auto const reusableSlot{ std::ranges::find_if(m_dRetiredSlots,
+		[this](RetiredSlot const& retiredSlot)
+		{
+			return retiredSlot.retiredFrame + m_FramesInFlight <= m_Frame and m_vTiles[retiredSlot.tileIndex].lastRequestedFrame != m_Frame;
+		}) };
+
+	if (reusableSlot == m_dRetiredSlots.end())
+		return std::nullopt;
+
+	Tile const& tile{ m_vTiles[reusableSlot->tileIndex] };
+	std::uint32_t const slot{ reusableSlot->slot };
+
+	// a tile made resident again in the meantime already had its page bound to its new slot
+	if (m_IsSparse and not tile.isResident)
+		vBinds.push_back(createSparseImageMemoryBind(tile, VK_NULL_HANDLE));
+
+	m_dRetiredSlots.erase(reusableSlot);
+	return slot;
+}
+
+bool fro::VirtualTexture::evictTile()
+{
+	// feedback lags behind by the frames in flight, so tiles requested more recently than that may still be
+	// sampled; tiles with resident children stay as well, so that every resident tile has resident ancestors
+	std::optional<std::uint32_t> victimIndex{};
+	for (std::optional<std::uint32_t> const tileIndex : m_vSlotTiles)
+	{
+		if (not tileIndex.has_value())
+			continue;
+
+		Tile const& tile{ m_vTiles[*tileIndex] };
+		if (tile.isPinned or tile.lastRequestedFrame + 2 * m_FramesInFlight >= m_Frame or hasResidentChildren(tile))
+			continue;
+
+		if (not victimIndex.has_value() or tile.lastRequestedFrame < m_vTiles[*victimIndex].lastRequestedFrame)
+			victimIndex = tileIndex;
+	}
+
+	if (not victimIndex.has_value())
+		return false;
+
+	// the page table stops pointing at the victim right away, its page stays bound until the slot is reused
+	Tile& victim{ m_vTiles[*victimIndex] };
+	std::uint32_t const slot{ *victim.slot };
+
+	victim.isResident = false;
+	victim.slot.reset();
+	m_vSlotTiles[slot].reset();
+	m_dRetiredSlots.push_back({ slot, *victimIndex, m_Frame });
+	markDirty(victim);
+	++m_EvictedTiles;
+
+	return true;
+}
+
+void fro::VirtualTexture::makeResident(std::uint32_t const tileIndex, std::uint32_t const slot)
+{
+	Tile& tile{ m_vTiles[tileIndex] };
+	tile.slot = slot;
+	tile.isResident = true;
+
+	m_vSlotTiles[slot] = tileIndex;
+	markDirty(tile);
+}
+
+void fro::VirtualTexture::markDirty(Tile const& tile)
+{
+	// every finer tile that falls back to this one is affected as well
+	TileRegion region{ tile.x, tile.y, tile.x, tile.y };
+	for (std::uint32_t level{ tile.level };; --level)
+	{
+		std::optional<TileRegion>& dirtyRegion{ m_vDirtyRegions[level] };
+		if (dirtyRegion.has_value())
+			dirtyRegion =
+			{
+				std::min(dirtyRegion->minimumX, region.minimumX),
+				std::min(dirtyRegion->minimumY, region.minimumY),
+				std::max(dirtyRegion->maximumX, region.maximumX),
+				std::max(dirtyRegion->maximumY, region.maximumY)
+			};
+		else
+			dirtyRegion = region;
+
+		if (level == 0)
+			break;
+
+		region = getChildRegion(level, region);
+	}
+}
+
+void fro::VirtualTexture::updatePageTable()
+{
+	// coarse to fine, so that parents are up to date by the time their children fall back to them
+	for (std::uint32_t level{ m_Entry.levelCount }; level-- > 0;)
+	{
+		if (not m_vDirtyRegions[level].has_value())
+			continue;
+
+		TileRegion const& region{ *m_vDirtyRegions[level] };
+		for (std::uint32_t y{ region.minimumY }; y <= region.maximumY; ++y)
+			for (std::uint32_t x{ region.minimumX }; x <= region.maximumX; ++x)
+			{
+				std::uint32_t const tileIndex{ getTileIndex(level, x, y) };
+				Tile const& tile{ m_vTiles[tileIndex] };
+
+				m_vPageTable[tileIndex] = tile.isResident ? getPageTableEntry(tile) : m_vPageTable[getParentIndex(tile)];
+			}
+	}
+}
+
+void fro::VirtualTexture::bindSparse(std::vector<VkSparseImageMemoryBind> const& vBinds, std::optional<VkSparseMemoryBind> const& mipTailBind, VkSemaphore const signalSemaphore)
+{
+	VkSparseImageMemoryBindInfo const imageBindInfo
+	{
+		.image{ m_pPhysicalImage.get() },
+		.bindCount{ static_cast<std::uint32_t>(vBinds.size()) },
+		.pBinds{ vBinds.data() }
+	};
+
+	VkSparseImageOpaqueMemoryBindInfo const opaqueBindInfo
+	{
+		.image{ m_pPhysicalImage.get() },
+		.bindCount{ 1 },
+		.pBinds{ mipTailBind.has_value() ? &*mipTailBind : nullptr }
+	};
+
+	VkBindSparseInfo const bindSparseInfo
+	{
+		.sType{ VK_STRUCTURE_TYPE_BIND_SPARSE_INFO },
+		.imageOpaqueBindCount{ mipTailBind.has_value() ? 1u : 0u },
+		.pImageOpaqueBinds{ &opaqueBindInfo },
+		.imageBindCount{ vBinds.empty() ? 0u : 1u },
+		.pImageBinds{ &imageBindInfo },
+		.signalSemaphoreCount{ signalSemaphore ? 1u : 0u },
+		.pSignalSemaphores{ &signalSemaphore }
+	};
+
+	if (vkQueueBindSparse(m_GraphicsQueue, 1, &bindSparseInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+		throw std::runtime_error("vkQueueBindSparse() failed!");
+}
+
+std::pair<fro::UniquePointer<VkBuffer_T>, fro::UniquePointer<VkDeviceMemory_T>> fro::VirtualTexture::recordUploads(VkCommandBuffer const commandBuffer,
+	std::vector<std::uint32_t> const& vTileIndices, VkImageLayout const oldLayout)
+{
+	VkDeviceSize stagingSize{ vTileIndices.size() * m_Entry.tileBytes };
+	for (std::optional<TileRegion> const& region : m_vDirtyRegions)
+		if (region.has_value())
+			stagingSize += static_cast<VkDeviceSize>(region->maximumX - region->minimumX + 1) * (region->maximumY - region->minimumY + 1) * sizeof(std::uint32_t);
+
+	auto pStagingBuffer
+	{
+		createBuffer(m_LogicalDevice, m_PhysicalDevice,
+			stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+	};
+
+	void* pData;
+	if (vkMapMemory(m_LogicalDevice, pStagingBuffer.second.get(), 0, stagingSize, 0, &pData) != VK_SUCCESS)
+		throw std::runtime_error("vkMapMemory() failed!");
+
+	std::uint8_t* const pMappedData{ static_cast<std::uint8_t*>(pData) };
+	VkDeviceSize stagingOffset{};
+
+	// tiles are copied out of the mapped pack as-is; in a sparse image a tile lands where it belongs, clipped
+	// to the level's edge, in the atlas it fills its slot
+	std::vector<VkBufferImageCopy> vTileRegions{};
+	for (std::uint32_t const tileIndex : vTileIndices)
+	{
+		Tile const& tile{ m_vTiles[tileIndex] };
+
+		std::span<std::uint8_t const> const tileBytes{ m_AssetPack.getTile(m_Entry, tile.level, tile.x, tile.y) };
+		std::memcpy(pMappedData + stagingOffset, tileBytes.data(), tileBytes.size());
+
+		VkBufferImageCopy region
+		{
+			.bufferOffset{ stagingOffset },
+			.bufferRowLength{ m_Entry.tileSize },
+			.bufferImageHeight{ m_Entry.tileSize },
+			.imageSubresource
+			{
+				.aspectMask{ VK_IMAGE_ASPECT_COLOR_BIT },
+				.layerCount{ 1 }
+			}
+		};
+
+		if (m_IsSparse)
+		{
+			VkSparseImageMemoryBind const bind{ createSparseImageMemoryBind(tile, VK_NULL_HANDLE) };
+
+			region.imageSubresource.mipLevel = tile.level;
+			region.imageOffset = bind.offset;
+			region.imageExtent = bind.extent;
+		}
+		else
+		{
+			region.imageOffset = { static_cast<std::int32_t>(*tile.slot % m_AtlasTileCountX * m_Entry.tileSize), static_cast<std::int32_t>(*tile.slot / m_AtlasTileCountX * m_Entry.tileSize), 0 };
+			region.imageExtent = { m_Entry.tileSize, m_Entry.tileSize, 1 };
+		}
+
+		vTileRegions.push_back(region);
+		stagingOffset += m_Entry.tileBytes;
+	}
+
+	std::vector<VkBufferImageCopy> vPageTableRegions{};
+	for (std::uint32_t level{}; level < m_Entry.levelCount; ++level)
+	{
+		std::optional<TileRegion>& region{ m_vDirtyRegions[level] };
+		if (not region.has_value())
+			continue;
+
+		std::uint32_t const width{ region->maximumX - region->minimumX + 1 };
+		std::uint32_t const height{ region->maximumY - region->minimumY + 1 };
+
+		vPageTableRegions.push_back
+		(
+			VkBufferImageCopy
+			{
+				.bufferOffset{ stagingOffset },
+				.imageSubresource
+				{
+					.aspectMask{ VK_IMAGE_ASPECT_COLOR_BIT },
+					.mipLevel{ level },
+					.layerCount{ 1 }
+				},
+				.imageOffset{ static_cast<std::int32_t>(region->minimumX), static_cast<std::int32_t>(region->minimumY), 0 },
+				.imageExtent{ width, height, 1 }
+			}
+		);
+
+		for (std::uint32_t y{ region->minimumY }; y <= region->maximumY; ++y)
+		{
+			std::memcpy(pMappedData + stagingOffset, &m_vPageTable[getTileIndex(level, region->minimumX, y)], width * sizeof(std::uint32_t));
+			stagingOffset += width * sizeof(std::uint32_t);
+		}
+
+		region.reset();
+	}
+
+	vkUnmapMemory(m_LogicalDevice, pStagingBuffer.second.get());
+
+	// the previous frame's fragment shaders may still read what gets overwritten
+	ResourceState const srcState{ oldLayout == VK_IMAGE_LAYOUT_UNDEFINED ? g_DiscardedResourceState : getResourceState(ResourceUsage::FragmentSampledRead) };
+	VkImageSubresourceRange const physicalImageRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, m_IsSparse ? m_Entry.levelCount : 1, 0, 1 };
+	VkImageSubresourceRange const pageTableImageRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, m_Entry.levelCount, 0, 1 };
+
+	BarrierBuilder barrierBuilder{};
+	barrierBuilder
+		.addImageBarrier(m_pPhysicalImage.get(), physicalImageRange, srcState, getResourceState(ResourceUsage::TransferWrite))
+		.addImageBarrier(m_pPageTableImage.first.get(), pageTableImageRange, srcState, getResourceState(ResourceUsage::TransferWrite))
+		.flush(commandBuffer);
+
+	if (not vTileRegions.empty())
+		vkCmdCopyBufferToImage(commandBuffer, pStagingBuffer.first.get(), m_pPhysicalImage.get(),
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<std::uint32_t>(vTileRegions.size()), vTileRegions.data());
+
+	if (not vPageTableRegions.empty())
+		vkCmdCopyBufferToImage(commandBuffer, pStagingBuffer.first.get(), m_pPageTableImage.first.get(),
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<std::uint32_t>(vPageTableRegions.size()), vPageTableRegions.data());
+
+	barrierBuilder
+		.addImageBarrier(m_pPhysicalImage.get(), physicalImageRange, ResourceUsage::TransferWrite, ResourceUsage::FragmentSampledRead)
+		.addImageBarrier(m_pPageTableImage.first.get(), pageTableImageRange, ResourceUsage::TransferWrite, ResourceUsage::FragmentSampledRead)
+		.flush(commandBuffer);
+
+	return pStagingBuffer;
+}
+
+VkSparseImageMemoryBind fro::VirtualTexture::createSparseImageMemoryBind(Tile const& tile, VkDeviceMemory const memory) const
+{
+	AssetPackLevel const& level{ m_Entry.aLevels[tile.level] };
+
+	return VkSparseImageMemoryBind
+	{
+		.subresource
+		{
+			.aspectMask{ VK_IMAGE_ASPECT_COLOR_BIT },
+			.mipLevel{ tile.level }
+		},
+		.offset{ static_cast<std::int32_t>(tile.x * m_Entry.tileSize), static_cast<std::int32_t>(tile.y * m_Entry.tileSize), 0 },
+		.extent{ std::min(m_Entry.tileSize, level.width - tile.x * m_Entry.tileSize), std::min(m_Entry.tileSize, level.height - tile.y * m_Entry.tileSize), 1 },
+		.memory{ memory },
+		.memoryOffset{ memory ? *tile.slot * static_cast<VkDeviceSize>(m_Entry.tileBytes) : 0 }
+	};
+}
+
+fro::VirtualTexture::TileRegion fro::VirtualTexture::getChildRegion(std::uint32_t const level, TileRegion const& region) const
+{
+	// tiles past the last parent's children (odd level sizes) fall back to that last parent too
+	Level const& parentLevel{ m_vLevels[level] };
+	Level const& childLevel{ m_vLevels[level - 1] };
+
+	return
+	{
+		std::min(region.minimumX * 2, childLevel.tileCountX - 1),
+		std::min(region.minimumY * 2, childLevel.tileCountY - 1),
+		region.maximumX + 1 == parentLevel.tileCountX ? childLevel.tileCountX - 1 : std::min(region.maximumX * 2 + 1, childLevel.tileCountX - 1),
+		region.maximumY + 1 == parentLevel.tileCountY ? childLevel.tileCountY - 1 : std::min(region.maximumY * 2 + 1, childLevel.tileCountY - 1)
+	};
+}
+
+std::uint32_t fro::VirtualTexture::getTileIndex(std::uint32_t const level, std::uint32_t const x, std::uint32_t const y) const
+{
+	return m_vLevels[level].firstTile + y * m_vLevels[level].tileCountX + x;
+}
+
+std::uint32_t fro::VirtualTexture::getParentIndex(Tile const& tile) const
+{
+	Level const& parentLevel{ m_vLevels[tile.level + 1] };
+
+	return getTileIndex(tile.level + 1, std::min(tile.x / 2, parentLevel.tileCountX - 1), std::min(tile.y / 2, parentLevel.tileCountY - 1));
+}
+
+std::uint32_t fro::VirtualTexture::getPageTableEntry(Tile const& tile) const
+{
+	// R and G hold the atlas tile, B the level; a sparse image is sampled directly and only needs the level
+	std::uint32_t const slot{ m_IsSparse ? 0 : tile.slot.value_or(0) };
+
+	return slot % m_AtlasTileCountX | slot / m_AtlasTileCountX << 8 | tile.level << 16;
+}
+
+bool fro::VirtualTexture::hasResidentChildren(Tile const& tile) const
+{
+	if (tile.level == 0)
+		return false;
+
+	TileRegion const children{ getChildRegion(tile.level, { tile.x, tile.y, tile.x, tile.y }) };
+	for (std::uint32_t y{ children.minimumY }; y <= children.maximumY; ++y)
+		for (std::uint32_t x{ children.minimumX }; x <= children.maximumX; ++x)
+			if (m_vTiles[getTileIndex(tile.level - 1, x, y)].isResident)
+				return true;
+
+	return false;
+}
+#pragma endregion PrivateMethods
\ No newline at end of file
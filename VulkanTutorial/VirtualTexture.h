@@ -0,0 +1,197 @@
+#if not defined fro_VIRTUAL_TEXTURE_H
+#define fro_VIRTUAL_TEXTURE_H
+
+#include "AssetPack.h"
+#include "SamplerCache.h"
+#include "Typenames.hpp"
+
+#include <Vulkan/vulkan_core.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace fro
+{
+	// std140 layout of the VIRTUAL_TEXTURE hardCodedTriangle.frag parameter block
+	struct VirtualTextureParameters final
+	{
+		// width, height, level count, padding; whether the physical texture is the sparse image is specialized instead
+		glm::uvec4 virtualSize;
+		// atlas tiles per row, atlas tiles per column, tile size
+		glm::uvec4 physicalLayout;
+		// tiles per row, tiles per column, index of the level's first tile in the feedback buffer
+		std::array<glm::uvec4, g_AssetPackMaxLevels> aLevels;
+	};
+
+	struct VirtualTextureStatistics final
+	{
+		std::size_t residentTiles;
+		std::size_t physicalTiles;
+		std::size_t requestedTiles;
+		std::size_t uploadedTiles;
+		std::size_t evictedTiles;
+	};
+
+	// a tiled asset pack entry of which only the tiles the fragment shader asked for last are resident. Tiles
+	// live in a sparse image bound page by page when the device supports sparse residency at the tile's
+	// granularity, and in a fixed-size atlas addressed through a page table otherwise; either way the page table
+	// tells the shader which level actually is resident for every tile, so missing detail falls back to the
+	// nearest coarser resident tile
+	class VirtualTexture final
+	{
+	public:
+		// the pack has to outlive the virtual texture; physicalTileCount is the number of tiles that can be
+		// resident at once, on top of the always-resident coarsest level (and mip tail)
+		VirtualTexture(VkDevice const logicalDevice, VkPhysicalDevice const physicalDevice, VkQueue const graphicsQueue, std::uint32_t const graphicsQueueFamilyIndex,
+			SamplerCache& samplerCache, AssetPack const& assetPack, AssetPackEntry const& entry, std::uint32_t const framesInFlight, std::uint32_t const physicalTileCount);
+
+		~VirtualTexture();
+
+		// reads back the tiles frameIndex asked for when it was last rendered and streams in the missing ones;
+		// call once per frame, after the frame's fence wait and before its command buffer gets submitted
+		void update(std::uint32_t const frameIndex);
+
+		[[nodiscard("virtual texture sparse mode ignored!")]]
+		bool isSparse() const;
+
+		[[nodiscard("page table image view ignored!")]]
+		VkImageView getPageTableImageView() const;
+
+		[[nodiscard("page table sampler ignored!")]]
+		VkSampler getPageTableSampler() const;
+
+		[[nodiscard("physical texture image view ignored!")]]
+		VkImageView getPhysicalImageView() const;
+
+		[[nodiscard("feedback buffer ignored!")]]
+		VkBuffer getFeedbackBuffer(std::uint32_t const frameIndex) const;
+
+		[[nodiscard("parameters buffer ignored!")]]
+		VkBuffer getParametersBuffer() const;
+
+		[[nodiscard("virtual texture statistics ignored!")]]
+		VirtualTextureStatistics getStatistics() const;
+
+	private:
+		struct Level final
+		{
+			std::uint32_t tileCountX;
+			std::uint32_t tileCountY;
+			std::uint32_t firstTile;
+		};
+
+		struct Tile final
+		{
+			std::uint32_t level;
+			std::uint32_t x;
+			std::uint32_t y;
+			std::optional<std::uint32_t> slot;
+			std::uint64_t lastRequestedFrame;
+			bool isResident;
+			bool isPinned;
+		};
+
+		struct FeedbackBuffer final
+		{
+			std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>> pBuffer;
+			std::uint32_t* pMappedData;
+		};
+
+		// a slot whose tile got evicted, but that frames still in flight may sample through the old page table
+		struct RetiredSlot final
+		{
+			std::uint32_t slot;
+			std::uint32_t tileIndex;
+			std::uint64_t retiredFrame;
+		};
+
+		// an inclusive rectangle of a level's tiles
+		struct TileRegion final
+		{
+			std::uint32_t minimumX;
+			std::uint32_t minimumY;
+			std::uint32_t maximumX;
+			std::uint32_t maximumY;
+		};
+
+		VirtualTexture(VirtualTexture const&) = delete;
+		VirtualTexture(VirtualTexture&&) noexcept = delete;
+
+		VirtualTexture& operator=(VirtualTexture const&) = delete;
+		VirtualTexture& operator=(VirtualTexture&&) noexcept = delete;
+
+		void createTiles();
+		void createSparseImage();
+		void createAtlasImage();
+		void createPageTable(SamplerCache& samplerCache);
+		void createFeedbackBuffers();
+		void createParametersBuffer();
+		void uploadPinnedTiles();
+		std::vector<std::uint32_t> readFeedback(std::uint32_t const frameIndex);
+		std::optional<std::uint32_t> allocateSlot(std::vector<VkSparseImageMemoryBind>& vBinds);
+		bool evictTile();
+		void makeResident(std::uint32_t const tileIndex, std::uint32_t const slot);
+		void markDirty(Tile const& tile);
+		void updatePageTable();
+		void bindSparse(std::vector<VkSparseImageMemoryBind> const& vBinds, std::optional<VkSparseMemoryBind> const& mipTailBind, VkSemaphore const signalSemaphore);
+		std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>> recordUploads(VkCommandBuffer const commandBuffer, std::vector<std::uint32_t> const& vTileIndices, VkImageLayout const oldLayout);
+		VkSparseImageMemoryBind createSparseImageMemoryBind(Tile const& tile, VkDeviceMemory const memory) const;
+		TileRegion getChildRegion(std::uint32_t const level, TileRegion const& region) const;
+		std::uint32_t getTileIndex(std::uint32_t const level, std::uint32_t const x, std::uint32_t const y) const;
+		std::uint32_t getParentIndex(Tile const& tile) const;
+		std::uint32_t getPageTableEntry(Tile const& tile) const;
+		bool hasResidentChildren(Tile const& tile) const;
+
+		VkDevice const m_LogicalDevice;
+		VkPhysicalDevice const m_PhysicalDevice;
+		VkQueue const m_GraphicsQueue;
+		AssetPack const& m_AssetPack;
+		AssetPackEntry const& m_Entry;
+		std::uint32_t const m_FramesInFlight;
+		std::uint32_t const m_PhysicalTileCount;
+		bool const m_IsSparse;
+		UniquePointer<VkCommandPool_T> const m_pCommandPool;
+
+		std::vector<Level> m_vLevels{};
+		std::vector<Tile> m_vTiles{};
+		std::vector<std::optional<std::uint32_t>> m_vSlotTiles{};
+		std::vector<std::uint32_t> m_vFreeSlots{};
+		std::deque<RetiredSlot> m_dRetiredSlots{};
+		std::uint32_t m_AtlasTileCountX{ 1 };
+		std::uint32_t m_AtlasTileCountY{ 1 };
+		std::uint32_t m_MipTailFirstLevel{};
+		std::optional<VkSparseMemoryBind> m_MipTailBind{};
+
+		// memory is declared before the images bound to it, so that it outlives them
+		UniquePointer<VkDeviceMemory_T> m_pTileMemory{};
+		UniquePointer<VkDeviceMemory_T> m_pMipTailMemory{};
+		UniquePointer<VkImage_T> m_pPhysicalImage{};
+		UniquePointer<VkImageView_T> m_pPhysicalImageView{};
+
+		// RGBA8 per tile: the atlas tile holding its texels (or those of its nearest resident ancestor) and
+		// the level that tile belongs to; mirrored on the CPU, where dirty regions are recomputed coarse to fine
+		std::pair<UniquePointer<VkImage_T>, UniquePointer<VkDeviceMemory_T>> m_pPageTableImage{};
+		UniquePointer<VkImageView_T> m_pPageTableImageView{};
+		VkSampler m_PageTableSampler{};
+		std::vector<std::uint32_t> m_vPageTable{};
+		std::vector<std::optional<TileRegion>> m_vDirtyRegions{};
+
+		std::vector<FeedbackBuffer> m_vFeedbackBuffers{};
+		std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>> m_pParametersBuffer{};
+
+		std::vector<VkCommandBuffer> m_vUploadCommandBuffers{};
+		std::vector<UniquePointer<VkFence_T>> m_vpUploadFences{};
+		std::vector<UniquePointer<VkSemaphore_T>> m_vpBindSemaphores{};
+		std::vector<std::pair<UniquePointer<VkBuffer_T>, UniquePointer<VkDeviceMemory_T>>> m_vpStagingBuffers{};
+
+		std::uint64_t m_Frame{};
+		std::size_t m_RequestedTiles{};
+		std::size_t m_UploadedTiles{};
+		std::size_t m_EvictedTiles{};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,62 +1,111 @@
 #include "VulkanApplication.h"
 
+#include "FormatSupport.h"
 #include "HelperFunctions.h"
+#include "Ktx2Texture.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+
+#if defined fro_RUNTIME_SHADER_COMPILATION
+#include "ShaderCompiler.h"
+#endif
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #undef GLFW_INCLUDE_VULKAN
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-#undef STB_IMAGE_IMPLEMENTATION
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/glm.hpp>
 #include <stdexcept>
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <span>
 
 #pragma region Constructors/Destructor
 fro::VulkanApplication::VulkanApplication():
 	m_pInstance{ createInstance(), std::bind(vkDestroyInstance, std::placeholders::_1, nullptr) },
 	m_pWindowSurface{ createWindowSurface(m_pInstance.get(), m_Window.getWindow()), std::bind(vkDestroySurfaceKHR, m_pInstance.get(), std::placeholders::_1, nullptr) },
 	m_PhysicalDevice{ pickSuitedPhysicalDevice(m_pInstance.get(), m_pWindowSurface.get(), vPhysicalDeviceExtensionNames) },
-	m_pLogicalDevice{ createLogicalDevice(m_PhysicalDevice, m_pWindowSurface.get(), vPhysicalDeviceExtensionNames), std::bind(vkDestroyDevice, std::placeholders::_1, nullptr) },
+	m_pLogicalDevice{ createLogicalDevice(m_PhysicalDevice, m_pWindowSurface.get(), vPhysicalDeviceExtensionNames, vOptionalPhysicalDeviceExtensionNames), std::bind(vkDestroyDevice, std::placeholders::_1, nullptr) },
 	m_GraphicsQueue{ getHandleToQueue(m_pLogicalDevice.get(), getAvailableQueueFamiliesIndices(m_PhysicalDevice, m_pWindowSurface.get()).graphics.value(), 0) },
 	m_PresentQueue{ getHandleToQueue(m_pLogicalDevice.get(), getAvailableQueueFamiliesIndices(m_PhysicalDevice, m_pWindowSurface.get()).present.value(), 0) },
 	m_pSwapChain{ createSwapChain(m_Window.getWindow(), m_PhysicalDevice, m_pWindowSurface.get(), m_pLogicalDevice.get(), m_SwapChainImageFormat, m_SwapChainImageExtent), std::bind(vkDestroySwapchainKHR, m_pLogicalDevice.get(), std::placeholders::_1, nullptr) },
 	m_vSwapChainImages{ getSwapChainImages(m_pLogicalDevice.get(), m_pSwapChain.get()) },
-	m_vpSwapChainImageViews{ createSwapChainImageViews(m_vSwapChainImages, m_SwapChainImageFormat, m_pLogicalDevice.get()) },
-	m_pDescriptorSetLayout{ createDescriptorSetLayout(m_pLogicalDevice.get()), std::bind(vkDestroyDescriptorSetLayout, m_pLogicalDevice.get(), std::placeholders::_1, nullptr) },
+	m_pAssetPack{ std::filesystem::exists(assetPackPath) ? std::make_unique<AssetPack>(assetPackPath) : nullptr },
+	m_pVirtualTextureEntry{ findVirtualTexture() },
+	m_VertexShaderVariants{ "Shaders", "hardCodedTriangle.vert", shaderc_shader_kind::shaderc_vertex_shader },
+	m_FragmentShaderVariants{ "Shaders", "hardCodedTriangle.frag", shaderc_shader_kind::shaderc_fragment_shader },
+	m_vVertexShaderBytecode{ m_VertexShaderVariants.getBytecode({}) },
+	m_vFragmentShaderBytecode{ m_FragmentShaderVariants.getBytecode(m_pVirtualTextureEntry ? std::vector<std::string_view>{ "VIRTUAL_TEXTURE" } : std::vector<std::string_view>{}) },
+	m_vDepthOnlyVertexShaderBytecode{ m_VertexShaderVariants.getBytecode({ "DEPTH_ONLY" }) },
+	m_ShaderReflection{ mergeShaderReflections({ reflectShader(m_vVertexShaderBytecode, VK_SHADER_STAGE_VERTEX_BIT), reflectShader(m_vFragmentShaderBytecode, VK_SHADER_STAGE_FRAGMENT_BIT) }) },
+	m_LayoutCache{ m_pLogicalDevice.get() },
+	m_SamplerCache{ m_pLogicalDevice.get(), m_PhysicalDevice, g_DefaultSamplerQuality },
+	m_vDescriptorSetLayouts{ m_LayoutCache.getDescriptorSetLayouts(m_ShaderReflection) },
 	m_FramesInFlight{ 2 },
-	m_pDescriptorPool{ createDescriptorPool(m_FramesInFlight, m_pLogicalDevice.get()), std::bind(vkDestroyDescriptorPool, m_pLogicalDevice.get(), std::placeholders::_1, nullptr) },
-	m_pPipelineLayout{ createPipelineLayout(m_pLogicalDevice.get(), m_pDescriptorSetLayout.get()), std::bind(vkDestroyPipelineLayout, m_pLogicalDevice.get(), std::placeholders::_1, nullptr) },
-	m_pRenderPass{ createRenderPass(m_SwapChainImageFormat, m_pLogicalDevice.get()), std::bind(vkDestroyRenderPass, m_pLogicalDevice.get(), std::placeholders::_1, nullptr) },
-	m_pPipeline{ createPipeline(m_pLogicalDevice.get(), m_SwapChainImageExtent, m_pPipelineLayout.get(), m_pRenderPass.get()), std::bind(vkDestroyPipeline, m_pLogicalDevice.get(), std::placeholders::_1, nullptr) },
-	m_vpSwapChainFrameBuffers{ createFramebuffers(m_vpSwapChainImageViews, m_pRenderPass.get(), m_SwapChainImageExtent, m_pLogicalDevice.get()) },
+	m_pDescriptorPool{ createDescriptorPool(m_ShaderReflection.vvDescriptorSetLayoutBindings.at(0), m_FramesInFlight, m_pLogicalDevice.get()), std::bind(vkDestroyDescriptorPool, m_pLogicalDevice.get(), std::placeholders::_1, nullptr) },
+	m_PipelineLayout{ m_LayoutCache.getPipelineLayout(m_vDescriptorSetLayouts, m_ShaderReflection.vPushConstantRanges) },
+	m_DepthFormat{ getDepthFormat(m_PhysicalDevice) },
+	m_AttachmentSampleCounts{ getAttachmentSampleCounts(m_PhysicalDevice) },
+	m_SampleCount{ m_AttachmentSampleCounts & g_DefaultSampleCount ? g_DefaultSampleCount : VK_SAMPLE_COUNT_1_BIT },
+	m_PipelineLibrary{ m_pLogicalDevice.get(), m_PhysicalDevice, m_PipelineLayout, m_FramesInFlight },
+	m_IsDepthPrePassEnabled{},
+	m_IsExtendedDynamicStateEnabled{ true },
+	m_RenderedSampleCount{ m_SampleCount },
+	m_IsDepthPrePassRendered{ m_IsDepthPrePassEnabled },
+	m_IsExtendedDynamicStateRendered{ m_IsExtendedDynamicStateEnabled },
+	m_MaterialStateSweep{},
 	m_pCommandPool{ createCommandPool(m_PhysicalDevice, m_pWindowSurface.get(), m_pLogicalDevice.get()), std::bind(vkDestroyCommandPool, m_pLogicalDevice.get(), std::placeholders::_1, nullptr) },
 	m_vCommandBuffers{ createCommandBuffers(m_pCommandPool.get(), m_pLogicalDevice.get(), m_FramesInFlight) },
+	m_RenderGraph{ m_pLogicalDevice.get(), m_PhysicalDevice, m_FramesInFlight },
+	m_PipelineStatisticsQueries{ m_pLogicalDevice.get(), m_PhysicalDevice, m_FramesInFlight },
+	m_TimestampQueries{ m_pLogicalDevice.get(), m_PhysicalDevice, m_FramesInFlight },
+	m_ResolutionController{ g_ResolutionControllerSettings },
+	m_IsDynamicResolutionEnabled{ true },
+	m_Upscaler{ m_pLogicalDevice.get(), m_LayoutCache, m_SamplerCache, m_FramesInFlight },
 	m_vpImageAvailableSemaphores{ createSemaphores(m_pLogicalDevice.get(), m_FramesInFlight) },
 	m_vpRenderFinishedSemaphores{ createSemaphores(m_pLogicalDevice.get(), m_FramesInFlight) },
 	m_vpInFlightFences{ createFences(m_pLogicalDevice.get(), m_FramesInFlight) },
 	m_CurrentFrame{},
 	m_FramebufferResized{},
-	m_vVertices
+	m_SwapChainRecreateTime{},
+	m_Mesh{ loadMesh() },
+	m_vVertices{ quantizeVertices(m_Mesh.vVertices) },
+	m_Indices{ packIndices(m_Mesh.vIndices, m_Mesh.vVertices.size()) },
+	m_GeometryBuffer{ m_pLogicalDevice.get(), m_PhysicalDevice, m_pCommandPool.get(), m_GraphicsQueue, sizeof(QuantizedVertex), m_Indices.type, g_GeometryVertexCapacity, g_GeometryIndexCapacity },
+	m_MeshHandle{ m_GeometryBuffer.addMesh(std::as_bytes(std::span{ m_vVertices }), m_Indices) },
+	m_IsMeshletCullingEnabled{},
+	m_pPackedTexture{ m_pAssetPack ? m_pAssetPack->findSupportedEntry(vPackedTextureNames, m_PhysicalDevice) : nullptr },
+	m_TextureLoader{ m_pLogicalDevice.get(), m_PhysicalDevice, m_GraphicsQueue, getAvailableQueueFamiliesIndices(m_PhysicalDevice, m_pWindowSurface.get()).graphics.value() },
+	m_pTextureStreamer{ m_pPackedTexture and not m_pVirtualTextureEntry ? std::make_unique<TextureStreamer>(m_TextureLoader, *m_pAssetPack, m_PhysicalDevice, g_TextureStreamingBudget, m_FramesInFlight) : nullptr },
+	m_pVirtualTexture
 	{
-		{ { -0.5f, -0.5f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f } },
-		{ { 0.5f, -0.5f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f } },
-		{ { 0.5f, 0.5f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f } },
-		{ { -0.5f, 0.5f }, { 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f } }
+		m_pVirtualTextureEntry ?
+		std::make_unique<VirtualTexture>(m_pLogicalDevice.get(), m_PhysicalDevice, m_GraphicsQueue, getAvailableQueueFamiliesIndices(m_PhysicalDevice, m_pWindowSurface.get()).graphics.value(),
+			m_SamplerCache, *m_pAssetPack, *m_pVirtualTextureEntry, m_FramesInFlight, g_VirtualTexturePhysicalTiles) :
+		nullptr
 	},
-	m_vIndices{ 0, 1, 2, 2, 3, 0 },
-	m_pVertexBuffer{ createVertexBuffer() },
-	m_pIndexBuffer{ createIndexBuffer() },
-	m_pTextureImageSampler{ createTextureSampler(m_pLogicalDevice.get(), m_PhysicalDevice) }
+	m_TextureHandle{ m_pVirtualTexture ? std::nullopt : std::optional{ loadTexture() } }
 {
+	// both depth pre-pass settings get compiled up front, so toggling it doesn't have to fall back
+	m_PipelineLibrary.prepare(getForwardPipelineDescription(m_SampleCount, false, m_IsExtendedDynamicStateEnabled));
+	m_PipelineLibrary.prepare(getForwardPipelineDescription(m_SampleCount, true, m_IsExtendedDynamicStateEnabled));
+	m_PipelineLibrary.prepare(getDepthPrePassPipelineDescription(m_SampleCount, m_IsExtendedDynamicStateEnabled));
+
 	glfwSetWindowUserPointer(m_Window.getWindow(), this);
 	glfwSetFramebufferSizeCallback(m_Window.getWindow(), framebufferResizeCallback);
+	glfwSetKeyCallback(m_Window.getWindow(), keyCallback);
 
 	createUniformBuffers();
-	createTextureImage();
-	createTextureImageView();
 	createDescriptorSets();
+	createMeshletCuller();
 }
 
 fro::VulkanApplication::~VulkanApplication()
@@ -96,15 +145,69 @@ void fro::VulkanApplication::render()
 
 	vkResetFences(m_pLogicalDevice.get(), 1, aFences);
 
+	// this frame's descriptor set is no longer in use, so it can pick up textures that became resident since,
+	// and samplers that follow a changed quality setting
+	m_TextureLoader.processUploads();
+	if (m_pTextureStreamer)
+	{
+		m_pTextureStreamer->request(m_TextureHandle.value(), getTextureScreenSpaceSize());
+		m_pTextureStreamer->update();
+	}
+
+	if (m_pVirtualTexture)
+		m_pVirtualTexture->update(m_CurrentFrame);
+
+	if (m_pMeshletCuller)
+		m_pMeshletCuller->update(m_CurrentFrame);
+
+	m_PipelineStatisticsQueries.update(m_CurrentFrame);
+	m_PipelineLibrary.update();
+	reportMaterialStatePipelines();
+
+	// the measurement is a couple of frames old by now, which the controller's smoothing is slow enough to absorb
+	m_TimestampQueries.update(m_CurrentFrame);
+	if (std::optional<double> const frameTime{ m_TimestampQueries.getFrameTime() }; frameTime.has_value() and m_IsDynamicResolutionEnabled)
+		m_ResolutionController.update(frameTime.value());
+
+	if (m_vDescriptorSetResidencyVersions[m_CurrentFrame] != m_TextureLoader.getResidencyVersion() or
+		m_vDescriptorSetSamplerQualityVersions[m_CurrentFrame] != m_SamplerCache.getQualityVersion())
+		writeDescriptorSet(m_CurrentFrame);
+
 	vkResetCommandBuffer(m_vCommandBuffers[m_CurrentFrame], 0);
 
 	updateUniformBuffer();
 
-	recordCommandBuffer(m_vCommandBuffers[m_CurrentFrame], imageIndex, m_pRenderPass.get(), m_vpSwapChainFrameBuffers, m_SwapChainImageExtent, m_pPipeline.get(), m_pVertexBuffer.first.get(), m_pIndexBuffer.first.get(), m_vIndices, m_pPipelineLayout.get(), m_vDescriptorSets, m_CurrentFrame);
+	// while the requested setup's pipelines compile, the frame renders with the setup it rendered with last, and skips
+	// its draws when even those aren't there
+	std::optional<FramePipelines> framePipelines{ getFramePipelines(m_SampleCount, m_IsDepthPrePassEnabled, m_IsExtendedDynamicStateEnabled) };
+	if (framePipelines.has_value())
+	{
+		m_RenderedSampleCount = m_SampleCount;
+		m_IsDepthPrePassRendered = m_IsDepthPrePassEnabled;
+		m_IsExtendedDynamicStateRendered = m_IsExtendedDynamicStateEnabled;
+	}
+	else
+		framePipelines = getFramePipelines(m_RenderedSampleCount, m_IsDepthPrePassRendered, m_IsExtendedDynamicStateRendered);
+
+	if (not framePipelines.has_value())
+		m_PipelineLibrary.markFrameHitched();
+
+	GraphicsPipeline const* const pPipeline{ framePipelines.has_value() ? &framePipelines->pipeline : nullptr };
+	GraphicsPipeline const* const pDepthPrePassPipeline
+	{
+		framePipelines.has_value() and framePipelines->depthPrePassPipeline.has_value() ? &framePipelines->depthPrePassPipeline.value() : nullptr
+	};
+
+	std::size_t const lod{ selectMeshLod() };
+	recordCommandBuffer(m_vCommandBuffers[m_CurrentFrame], m_RenderGraph, imageIndex, m_vSwapChainImages, m_SwapChainImageExtent, g_SceneColorFormat, getRenderExtent(),
+		m_DepthFormat, m_RenderedSampleCount, pDepthPrePassPipeline, pPipeline,
+		m_GeometryBuffer.getVertexBuffer(), m_GeometryBuffer.getIndexBuffer(), m_GeometryBuffer.getIndexType(), m_GeometryBuffer.getAllocation(m_MeshHandle), m_Mesh.vLods[lod], lod,
+		m_IsMeshletCullingEnabled ? m_pMeshletCuller.get() : nullptr, m_PipelineLayout, m_vDescriptorSets,
+		m_pVirtualTexture ? m_pVirtualTexture->getFeedbackBuffer(m_CurrentFrame) : VK_NULL_HANDLE, m_Upscaler, g_UpscaleSharpness, m_PipelineStatisticsQueries, m_TimestampQueries, m_CurrentFrame);
 
 	VkSemaphore const aWaitSemaphores[]{ m_vpImageAvailableSemaphores[m_CurrentFrame].get() };
 	VkSemaphore const aSignalSemaphores[]{ m_vpRenderFinishedSemaphores[m_CurrentFrame].get() };
-	VkPipelineStageFlags const aWaitStages[]{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+	VkPipelineStageFlags const aWaitStages[]{ VK_PIPELINE_STAGE_TRANSFER_BIT };
 	VkSubmitInfo const submitInfo
 	{
 		.sType{ VK_STRUCTURE_TYPE_SUBMIT_INFO },
@@ -157,8 +260,10 @@ void fro::VulkanApplication::recreateSwapChain()
 
 	vkDeviceWaitIdle(m_pLogicalDevice.get());
 
-	m_vpSwapChainFrameBuffers.clear();
-	m_vpSwapChainImageViews.clear();
+	// with dynamic rendering there are no framebuffers to rebuild, only the swap chain; the scene's images are
+	// render graph transients, which follow the new extent by themselves
+	auto const recreateStart{ std::chrono::high_resolution_clock::now() };
+
 	m_vSwapChainImages.clear();
 	m_pSwapChain.reset();
 
@@ -168,64 +273,136 @@ void fro::VulkanApplication::recreateSwapChain()
 		std::bind(vkDestroySwapchainKHR, m_pLogicalDevice.get(), std::placeholders::_1, nullptr)
 	};
 	m_vSwapChainImages = getSwapChainImages(m_pLogicalDevice.get(), m_pSwapChain.get());
-	m_vpSwapChainImageViews = createSwapChainImageViews(m_vSwapChainImages, m_SwapChainImageFormat, m_pLogicalDevice.get());
-	m_vpSwapChainFrameBuffers = createFramebuffers(m_vpSwapChainImageViews, m_pRenderPass.get(), m_SwapChainImageExtent, m_pLogicalDevice.get());
+
+	m_SwapChainRecreateTime = std::chrono::duration<double, std::milli>{ std::chrono::high_resolution_clock::now() - recreateStart }.count();
 }
 
-std::pair<std::unique_ptr<VkBuffer_T, std::function<void(VkBuffer_T*)>>, std::unique_ptr<VkDeviceMemory_T, std::function<void(VkDeviceMemory_T*)>>>
-fro::VulkanApplication::createVertexBuffer()
+std::optional<fro::VulkanApplication::FramePipelines> fro::VulkanApplication::getFramePipelines(VkSampleCountFlagBits const sampleCount, bool const isDepthPrePassEnabled,
+	bool const isExtendedDynamicStateEnabled)
 {
-	VkDeviceSize const bufferSize{ sizeof(m_vVertices[0]) * m_vVertices.size() };
-
-	auto pStagingBuffer
+	// both are asked for before bailing, so both get queued
+	std::optional<GraphicsPipeline> const pipeline{ m_PipelineLibrary.getPipeline(getForwardPipelineDescription(sampleCount, isDepthPrePassEnabled, isExtendedDynamicStateEnabled)) };
+	std::optional<GraphicsPipeline> const depthPrePassPipeline
 	{
-		createBuffer(m_pLogicalDevice.get(), m_PhysicalDevice,
-		bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+		isDepthPrePassEnabled ? m_PipelineLibrary.getPipeline(getDepthPrePassPipelineDescription(sampleCount, isExtendedDynamicStateEnabled)) : std::nullopt
 	};
 
-	void* data;
-	vkMapMemory(m_pLogicalDevice.get(), pStagingBuffer.second.get(), 0, bufferSize, 0, &data);
-	memcpy(data, m_vVertices.data(), static_cast<std::size_t>(bufferSize));
-	vkUnmapMemory(m_pLogicalDevice.get(), pStagingBuffer.second.get());
+	if (not pipeline.has_value() or (isDepthPrePassEnabled and not depthPrePassPipeline.has_value()))
+		return std::nullopt;
+
+	return FramePipelines{ pipeline.value(), depthPrePassPipeline };
+}
 
-	auto pVertexBuffer
+fro::GraphicsPipelineDescription fro::VulkanApplication::getForwardPipelineDescription(VkSampleCountFlagBits const sampleCount, bool const isDepthPrePassEnabled,
+	bool const isExtendedDynamicStateEnabled) const
+{
+	// with the depth pre-pass, the forward pass only shades what has the depth the pre-pass wrote
+	return
 	{
-		createBuffer(m_pLogicalDevice.get(), m_PhysicalDevice,
-		bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+		.pVertexShaderBytecode{ &m_vVertexShaderBytecode },
+		.pFragmentShaderBytecode{ &m_vFragmentShaderBytecode },
+		.colorAttachmentFormat{ g_SceneColorFormat },
+		.depthState{ m_DepthFormat, isDepthPrePassEnabled ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS, isDepthPrePassEnabled ? VK_FALSE : VK_TRUE },
+		.materialState{ g_MaterialState },
+		.sampleCount{ sampleCount },
+		.isStateDynamic{ isExtendedDynamicStateEnabled },
+		.vFragmentSpecializationConstants{ getFragmentSpecializationConstants() }
 	};
+}
 
-	copyBuffer(pStagingBuffer.first.get(), pVertexBuffer.first.get(), bufferSize, m_pCommandPool.get(), m_pLogicalDevice.get(), m_GraphicsQueue);
-
-	return pVertexBuffer;
+fro::GraphicsPipelineDescription fro::VulkanApplication::getDepthPrePassPipelineDescription(VkSampleCountFlagBits const sampleCount, bool const isExtendedDynamicStateEnabled) const
+{
+	return
+	{
+		.pVertexShaderBytecode{ &m_vDepthOnlyVertexShaderBytecode },
+		.pFragmentShaderBytecode{ nullptr },
+		.colorAttachmentFormat{ g_SceneColorFormat },
+		.depthState{ m_DepthFormat, VK_COMPARE_OP_LESS, VK_TRUE },
+		.materialState{ g_MaterialState },
+		.sampleCount{ sampleCount },
+		.isStateDynamic{ isExtendedDynamicStateEnabled }
+	};
 }
 
-std::pair<std::unique_ptr<VkBuffer_T, std::function<void(VkBuffer_T*)>>, std::unique_ptr<VkDeviceMemory_T, std::function<void(VkDeviceMemory_T*)>>>
-fro::VulkanApplication::createIndexBuffer()
+std::vector<std::uint32_t> fro::VulkanApplication::getFragmentSpecializationConstants() const
 {
-	VkDeviceSize const bufferSize{ sizeof(m_vIndices[0]) * m_vIndices.size() };
+	// IS_SPARSE, which only the VIRTUAL_TEXTURE variant declares
+	if (not m_pVirtualTexture)
+		return {};
 
-	auto pStagingBuffer
+	return { m_pVirtualTexture->isSparse() ? 1u : 0u };
+}
+
+void fro::VulkanApplication::createMaterialStatePipelines()
+{
+	std::array constexpr aCullModes{ VK_CULL_MODE_NONE, VK_CULL_MODE_BACK_BIT, VK_CULL_MODE_FRONT_BIT };
+	std::array constexpr aFrontFaces{ VK_FRONT_FACE_COUNTER_CLOCKWISE, VK_FRONT_FACE_CLOCKWISE };
+	std::array constexpr aBlendEnables{ VK_FALSE, VK_TRUE };
+	// opaque, decals drawn on top of it, and the forward pass after a depth pre-pass
+	std::array const aDepthStates
 	{
-		createBuffer(m_pLogicalDevice.get(), m_PhysicalDevice, bufferSize,
-		VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+		DepthState{ m_DepthFormat, VK_COMPARE_OP_LESS, VK_TRUE },
+		DepthState{ m_DepthFormat, VK_COMPARE_OP_LESS_OR_EQUAL, VK_FALSE },
+		DepthState{ m_DepthFormat, VK_COMPARE_OP_EQUAL, VK_FALSE }
 	};
 
-	void* data;
-	vkMapMemory(m_pLogicalDevice.get(), pStagingBuffer.second.get(), 0, bufferSize, 0, &data);
-	memcpy(data, m_vIndices.data(), static_cast<size_t>(bufferSize));
-	vkUnmapMemory(m_pLogicalDevice.get(), pStagingBuffer.second.get());
+	PipelineLibraryStatistics const statisticsBefore{ m_PipelineLibrary.getStatistics() };
+	auto const creationStart{ std::chrono::high_resolution_clock::now() };
 
-	auto pIndexBuffer
+	std::size_t materialStateCount{};
+	for (VkSampleCountFlags sampleCount{ VK_SAMPLE_COUNT_1_BIT }; sampleCount <= VK_SAMPLE_COUNT_64_BIT; sampleCount <<= 1)
 	{
-		createBuffer(m_pLogicalDevice.get(), m_PhysicalDevice, bufferSize,
-		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+		if (not (sampleCount & m_AttachmentSampleCounts))
+			continue;
+
+		for (VkCullModeFlags const cullMode : aCullModes)
+			for (VkFrontFace const frontFace : aFrontFaces)
+				for (VkBool32 const isBlendEnabled : aBlendEnables)
+					for (DepthState const& depthState : aDepthStates)
+					{
+						m_PipelineLibrary.prepare(
+							{
+								.pVertexShaderBytecode{ &m_vVertexShaderBytecode },
+								.pFragmentShaderBytecode{ &m_vFragmentShaderBytecode },
+								.colorAttachmentFormat{ g_SceneColorFormat },
+								.depthState{ depthState },
+								.materialState{ cullMode, frontFace, isBlendEnabled },
+								.sampleCount{ static_cast<VkSampleCountFlagBits>(sampleCount) },
+								.isStateDynamic{ m_IsExtendedDynamicStateEnabled },
+								.vFragmentSpecializationConstants{ getFragmentSpecializationConstants() }
+							});
+						++materialStateCount;
+					}
+	}
+
+	// the workers build them in the background; frames keep rendering with the mode they rendered with last until
+	// the new mode's forward pipelines are among the ready ones, and the sweep gets reported once it's done
+	m_MaterialStateSweep =
+	{
+		.isExtendedDynamicStateEnabled{ m_IsExtendedDynamicStateEnabled },
+		.materialStateCount{ materialStateCount },
+		.newPipelineCount{ m_PipelineLibrary.getStatistics().pipelineCount - statisticsBefore.pipelineCount },
+		.creationTimeBefore{ statisticsBefore.creationTime },
+		.start{ creationStart }
 	};
+}
 
-	copyBuffer(pStagingBuffer.first.get(), pIndexBuffer.first.get(), bufferSize, m_pCommandPool.get(), m_pLogicalDevice.get(), m_GraphicsQueue);
+void fro::VulkanApplication::reportMaterialStatePipelines()
+{
+	if (not m_MaterialStateSweep.has_value())
+		return;
+
+	// background links included, which is what waiting on the workers used to cover
+	PipelineLibraryStatistics const statistics{ m_PipelineLibrary.getStatistics() };
+	if (statistics.pendingPipelineCount != 0 or statistics.pendingOptimizationCount != 0)
+		return;
 
-	return pIndexBuffer;
+	std::chrono::duration<double, std::milli> const creationTime{ std::chrono::high_resolution_clock::now() - m_MaterialStateSweep->start };
+	std::cout << std::format("extended dynamic state {}: {} material states took {} new pipelines, created in {:.3f}ms on the workers, {:.3f}ms wall time ({} pipelines in total)\n",
+		m_MaterialStateSweep->isExtendedDynamicStateEnabled ? "on" : "off", m_MaterialStateSweep->materialStateCount, m_MaterialStateSweep->newPipelineCount,
+		statistics.creationTime - m_MaterialStateSweep->creationTimeBefore, creationTime.count(), statistics.pipelineCount);
+
+	m_MaterialStateSweep.reset();
 }
 
 void fro::VulkanApplication::createUniformBuffers()
@@ -255,8 +432,8 @@ void fro::VulkanApplication::updateUniformBuffer()
 	UniformBufferObject uniformBufferObject
 	{
 		.modelMatrix{ glm::rotate(glm::mat4(1.0f), deltaSeconds * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)) },
-		.viewMatrix{ glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)) },
-		.projectionMatrix{ glm::perspective(glm::radians(45.0f), m_SwapChainImageExtent.width / static_cast<float>(m_SwapChainImageExtent.height), 0.1f, 10.0f) }
+		.viewMatrix{ glm::lookAt(g_CameraPosition, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)) },
+		.projectionMatrix{ glm::perspectiveRH_ZO(glm::radians(g_FieldOfViewDegrees), m_SwapChainImageExtent.width / static_cast<float>(m_SwapChainImageExtent.height), g_NearPlane, 10.0f) }
 	};
 
 	uniformBufferObject.projectionMatrix[1][1] *= -1;
@@ -266,7 +443,7 @@ void fro::VulkanApplication::updateUniformBuffer()
 
 void fro::VulkanApplication::createDescriptorSets()
 {
-	std::vector<VkDescriptorSetLayout> vLayouts(m_FramesInFlight, m_pDescriptorSetLayout.get());
+	std::vector<VkDescriptorSetLayout> vLayouts(m_FramesInFlight, m_vDescriptorSetLayouts.at(0));
 	VkDescriptorSetAllocateInfo const allocationInfo
 	{
 		.sType{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO  },
@@ -279,168 +456,193 @@ void fro::VulkanApplication::createDescriptorSets()
 	if (vkAllocateDescriptorSets(m_pLogicalDevice.get(), &allocationInfo, m_vDescriptorSets.data()) != VK_SUCCESS)
 		throw std::runtime_error("vkAllocateDescriptorSets() failed!");
 
-	for (std::size_t index{}; index < m_FramesInFlight; ++index)
-	{
-		VkDescriptorBufferInfo const bufferInfo
-		{
-			.buffer{ m_vpUniformBuffers[index].first.get() },
-			.offset{ 0 },
-			.range{ sizeof(UniformBufferObject) }
-		};
-
-		VkDescriptorImageInfo imageInfo{};
-		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		imageInfo.imageView = m_pTextureImageView.get();
-		imageInfo.sampler = m_pTextureImageSampler.get();
-
-		std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-
-		descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrites[0].dstSet = m_vDescriptorSets[index];
-		descriptorWrites[0].dstBinding = 0;
-		descriptorWrites[0].dstArrayElement = 0;
-		descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		descriptorWrites[0].descriptorCount = 1;
-		descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-		descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrites[1].dstSet = m_vDescriptorSets[index];
-		descriptorWrites[1].dstBinding = 1;
-		descriptorWrites[1].dstArrayElement = 0;
-		descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		descriptorWrites[1].descriptorCount = 1;
-		descriptorWrites[1].pImageInfo = &imageInfo;
-
-		vkUpdateDescriptorSets(m_pLogicalDevice.get(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-	}
+	m_vDescriptorSetResidencyVersions.resize(m_FramesInFlight);
+	m_vDescriptorSetSamplerQualityVersions.resize(m_FramesInFlight);
+	for (std::uint32_t index{}; index < m_FramesInFlight; ++index)
+		writeDescriptorSet(index);
 }
 
-void fro::VulkanApplication::createTextureImage()
+void fro::VulkanApplication::createMeshletCuller()
 {
-	int textureWidth;
-	int textureHeight;
-	int textureChannels;
+	std::uint32_t const graphicsQueueFamilyIndex{ getAvailableQueueFamiliesIndices(m_PhysicalDevice, m_pWindowSurface.get()).graphics.value() };
+	if (not (getAvailableQueueFamilies(m_PhysicalDevice)[graphicsQueueFamilyIndex].queueFlags & VK_QUEUE_COMPUTE_BIT))
+		return;
 
-	stbi_uc* const pPixels{ stbi_load("Textures/texture.jpg", &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha) };
-	VkDeviceSize const imageSize{ static_cast<std::uint64_t>(textureWidth * textureHeight * 4) };
+	std::vector<VkBuffer> vUniformBuffers{};
+	for (auto const& pUniformBuffer : m_vpUniformBuffers)
+		vUniformBuffers.push_back(pUniformBuffer.first.get());
 
-	if (not pPixels)
-		throw std::runtime_error("stbi_load() failed!");
+	std::vector<std::vector<Meshlet>> vvLodMeshlets{};
+	for (MeshLod const& lod : m_Mesh.vLods)
+		vvLodMeshlets.push_back(buildMeshlets(m_Mesh, lod));
+
+	m_pMeshletCuller = std::make_unique<MeshletCuller>(m_pLogicalDevice.get(), m_PhysicalDevice, m_pCommandPool.get(), m_GraphicsQueue,
+		m_LayoutCache, vvLodMeshlets, vUniformBuffers);
+	m_IsMeshletCullingEnabled = true;
+}
 
-	auto pStagingBuffer
+void fro::VulkanApplication::writeDescriptorSet(std::uint32_t index)
+{
+	VkDescriptorBufferInfo const bufferInfo
 	{
-		createBuffer(m_pLogicalDevice.get(), m_PhysicalDevice,
-			imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+		.buffer{ m_vpUniformBuffers[index].first.get() },
+		.offset{ 0 },
+		.range{ sizeof(UniformBufferObject) }
 	};
 
-	void* data;
-	vkMapMemory(m_pLogicalDevice.get(), pStagingBuffer.second.get(), 0, imageSize, 0, &data);
-	memcpy(data, pPixels, static_cast<std::size_t>(imageSize));
-	vkUnmapMemory(m_pLogicalDevice.get(), pStagingBuffer.second.get());
+	VkDescriptorImageInfo imageInfo{};
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	imageInfo.imageView = m_pVirtualTexture ? m_pVirtualTexture->getPageTableImageView() : getTextureImageView();
+	imageInfo.sampler = m_pVirtualTexture ? m_pVirtualTexture->getPageTableSampler() : getTextureSampler();
+
+	std::vector<VkWriteDescriptorSet> descriptorWrites(2);
+
+	descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrites[0].dstSet = m_vDescriptorSets[index];
+	descriptorWrites[0].dstBinding = 0;
+	descriptorWrites[0].dstArrayElement = 0;
+	descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	descriptorWrites[0].descriptorCount = 1;
+	descriptorWrites[0].pBufferInfo = &bufferInfo;
+
+	descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrites[1].dstSet = m_vDescriptorSets[index];
+	descriptorWrites[1].dstBinding = 1;
+	descriptorWrites[1].dstArrayElement = 0;
+	descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	descriptorWrites[1].descriptorCount = 1;
+	descriptorWrites[1].pImageInfo = &imageInfo;
+
+	// a virtual texture's page table takes binding 1, the tiles it points into, the feedback and the parameters follow
+	VkDescriptorImageInfo physicalImageInfo{};
+	VkDescriptorBufferInfo feedbackBufferInfo{};
+	VkDescriptorBufferInfo parametersBufferInfo{};
+	if (m_pVirtualTexture)
+	{
+		physicalImageInfo = { getTextureSampler(), m_pVirtualTexture->getPhysicalImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		feedbackBufferInfo = { m_pVirtualTexture->getFeedbackBuffer(index), 0, VK_WHOLE_SIZE };
+		parametersBufferInfo = { m_pVirtualTexture->getParametersBuffer(), 0, sizeof(VirtualTextureParameters) };
+
+		descriptorWrites.push_back({ .sType{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET }, .dstSet{ m_vDescriptorSets[index] }, .dstBinding{ 2 },
+			.descriptorCount{ 1 }, .descriptorType{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER }, .pImageInfo{ &physicalImageInfo } });
+		descriptorWrites.push_back({ .sType{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET }, .dstSet{ m_vDescriptorSets[index] }, .dstBinding{ 3 },
+			.descriptorCount{ 1 }, .descriptorType{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER }, .pBufferInfo{ &feedbackBufferInfo } });
+		descriptorWrites.push_back({ .sType{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET }, .dstSet{ m_vDescriptorSets[index] }, .dstBinding{ 4 },
+			.descriptorCount{ 1 }, .descriptorType{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER }, .pBufferInfo{ &parametersBufferInfo } });
+	}
+
+	vkUpdateDescriptorSets(m_pLogicalDevice.get(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+
+	m_vDescriptorSetResidencyVersions[index] = m_TextureLoader.getResidencyVersion();
+	m_vDescriptorSetSamplerQualityVersions[index] = m_SamplerCache.getQualityVersion();
+}
 
-	stbi_image_free(pPixels);
+fro::AssetPackEntry const* fro::VulkanApplication::findVirtualTexture() const
+{
+	if (not m_pAssetPack)
+		return nullptr;
 
-	m_pTextureImage = createImage(m_pLogicalDevice.get(), m_PhysicalDevice,
-		textureWidth, textureHeight,
-		VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
-		VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	AssetPackEntry const* const pEntry{ m_pAssetPack->findEntry(virtualTextureName) };
+	if (not pEntry or pEntry->tileSize == 0)
+		return nullptr;
 
-	transitionImageLayout(m_pTextureImage.first.get(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	copyBufferToImage(pStagingBuffer.first.get(), m_pTextureImage.first.get(), static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
+	// the shader writes its tile feedback from the fragment stage
+	VkPhysicalDeviceFeatures features;
+	vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &features);
 
-	transitionImageLayout(m_pTextureImage.first.get(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	return features.fragmentStoresAndAtomics ? pEntry : nullptr;
 }
 
-void fro::VulkanApplication::transitionImageLayout(VkImage image, VkFormat, VkImageLayout oldLayout, VkImageLayout newLayout)
+fro::Mesh fro::VulkanApplication::loadMesh() const
 {
-	VkCommandBuffer const commandBuffer{ beginSingleTimeCommands(m_pCommandPool.get(), m_pLogicalDevice.get()) };
-
-	VkImageMemoryBarrier barrier{};
-	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-	barrier.oldLayout = oldLayout;
-	barrier.newLayout = newLayout;
-	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.image = image;
-	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	barrier.subresourceRange.baseMipLevel = 0;
-	barrier.subresourceRange.levelCount = 1;
-	barrier.subresourceRange.baseArrayLayer = 0;
-	barrier.subresourceRange.layerCount = 1;
-	barrier.srcAccessMask = 0; // TODO
-	barrier.dstAccessMask = 0; // TODO
-
-	VkPipelineStageFlags sourceStage;
-	VkPipelineStageFlags destinationStage;
-
-	if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-		barrier.srcAccessMask = 0;
-		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-		sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-		destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-	}
-	else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	if (not std::filesystem::exists(meshPath))
+		return Mesh
+		{
+			.vVertices
+			{
+				{ { -0.5f, -0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f } },
+				{ { 0.5f, -0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f } },
+				{ { 0.5f, 0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f } },
+				{ { -0.5f, 0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f } }
+			},
+			.vIndices{ 0, 1, 2, 2, 3, 0 },
+			.vLods{ { 0, 6, 0.0f } }
+		};
 
-		sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-	}
-	else {
-		throw std::invalid_argument("unsupported layout transition!");
+	Mesh mesh{ loadObj(meshPath) };
+	MeshOptimizationReport const report{ optimizeMesh(mesh) };
+
+	std::cout << std::format("{}: {} vertices, {} after deduplication, {} triangles\n", meshPath, report.inputVertexCount, report.vertexCount, report.triangleCount);
+	std::cout << std::format("ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, optimized in {:.3f}s ({:.0f} vertices/s)\n",
+		report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr, report.seconds, static_cast<double>(report.inputVertexCount) / report.seconds);
+
+	// positions get uploaded as half floats, so the model is scaled to the quad's size around the origin
+	glm::vec3 minimum{ std::numeric_limits<float>::max() };
+	glm::vec3 maximum{ std::numeric_limits<float>::lowest() };
+	for (Vertex const& vertex : mesh.vVertices)
+	{
+		minimum = glm::min(minimum, vertex.position);
+		maximum = glm::max(maximum, vertex.position);
 	}
 
-	vkCmdPipelineBarrier(
-		commandBuffer,
-		sourceStage, destinationStage,
-		0,
-		0, nullptr,
-		0, nullptr,
-		1, &barrier
-	);
+	glm::vec3 const center{ (minimum + maximum) / 2.0f };
+	glm::vec3 const size{ maximum - minimum };
+	float const extent{ std::max({ size.x, size.y, size.z, std::numeric_limits<float>::min() }) };
+	for (Vertex& vertex : mesh.vVertices)
+		vertex.position = (vertex.position - center) / extent;
 
-	endSingleTimeCommands(commandBuffer, m_GraphicsQueue, m_pCommandPool.get(), m_pLogicalDevice.get());
+	// after scaling, so the levels' errors are in the units selectMeshLod() projects
+	generateLods(mesh);
+	for (std::size_t lod{}; lod < mesh.vLods.size(); ++lod)
+		std::cout << std::format("LOD {}: {} triangles, error {:.5f}\n", lod, mesh.vLods[lod].indexCount / 3, mesh.vLods[lod].error);
+
+	return mesh;
 }
 
-void fro::VulkanApplication::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
+std::size_t fro::VulkanApplication::loadTexture()
 {
-	VkCommandBuffer commandBuffer = beginSingleTimeCommands(m_pCommandPool.get(), m_pLogicalDevice.get());
-
-	VkBufferImageCopy region{};
-	region.bufferOffset = 0;
-	region.bufferRowLength = 0;
-	region.bufferImageHeight = 0;
-
-	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	region.imageSubresource.mipLevel = 0;
-	region.imageSubresource.baseArrayLayer = 0;
-	region.imageSubresource.layerCount = 1;
-
-	region.imageOffset = { 0, 0, 0 };
-	region.imageExtent = {
-		width,
-		height,
-		1
-	};
+	// packed payloads are upload-ready and streamed in by on-screen size, loose KTX2 files still need
+	// their level index read, JPEGs a full decode
+	if (m_pTextureStreamer)
+		return m_pTextureStreamer->add(*m_pPackedTexture);
+
+	return m_TextureLoader.load(std::string(findSupportedKtx2Texture(vKtx2TexturePaths, m_PhysicalDevice).value_or("Textures/texture.jpg")));
+}
+
+VkImageView fro::VulkanApplication::getTextureImageView() const
+{
+	if (m_pTextureStreamer)
+		return m_pTextureStreamer->getImageView(m_TextureHandle.value());
+
+	return m_TextureLoader.getImageView(m_TextureHandle.value());
+}
+
+VkSampler fro::VulkanApplication::getTextureSampler()
+{
+	return m_SamplerCache.getSampler(m_SamplerCache.applyQuality(getTextureSamplerCreateInfo()));
+}
 
-	vkCmdCopyBufferToImage(
-		commandBuffer,
-		buffer,
-		image,
-		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-		1,
-		&region
-	);
+float fro::VulkanApplication::getTextureScreenSpaceSize() const
+{
+	// the textured quad is a unit square around the origin, so this is its projected height when facing the camera
+	float const distance{ glm::length(g_CameraPosition) };
+	float const viewHeight{ 2.0f * distance * std::tan(glm::radians(g_FieldOfViewDegrees) / 2.0f) };
 
-	endSingleTimeCommands(commandBuffer, m_GraphicsQueue, m_pCommandPool.get(), m_pLogicalDevice.get());
+	return static_cast<float>(getRenderExtent().height) / viewHeight;
 }
 
-void fro::VulkanApplication::createTextureImageView()
+std::size_t fro::VulkanApplication::selectMeshLod() const
 {
-	m_pTextureImageView = createImageView(m_pTextureImage.first.get(), VK_FORMAT_R8G8B8A8_SRGB, m_pLogicalDevice.get());
+	// the mesh fits a unit cube around the origin, so nothing of it comes closer than its half diagonal allows
+	float const distance{ std::max(glm::length(g_CameraPosition) - std::sqrt(3.0f) / 2.0f, g_NearPlane) };
+	float const viewHeight{ 2.0f * distance * std::tan(glm::radians(g_FieldOfViewDegrees) / 2.0f) };
+
+	return selectLod(m_Mesh.vLods, static_cast<float>(getRenderExtent().height) / viewHeight, g_MaxLodErrorPixels);
+}
+
+VkExtent2D fro::VulkanApplication::getRenderExtent() const
+{
+	return m_ResolutionController.getRenderExtent(m_SwapChainImageExtent);
 }
 
 void fro::VulkanApplication::framebufferResizeCallback(GLFWwindow* window, int, int)
@@ -448,4 +650,120 @@ void fro::VulkanApplication::framebufferResizeCallback(GLFWwindow* window, int,
 	VulkanApplication* pApp{ reinterpret_cast<VulkanApplication*>(glfwGetWindowUserPointer(window)) };
 	pApp->m_FramebufferResized = true;
 }
+
+void fro::VulkanApplication::keyCallback(GLFWwindow* window, int key, int, int action, int)
+{
+	if (action == GLFW_RELEASE)
+		return;
+
+	VulkanApplication* pApp{ reinterpret_cast<VulkanApplication*>(glfwGetWindowUserPointer(window)) };
+	if (key == GLFW_KEY_M)
+	{
+		pApp->m_IsMeshletCullingEnabled = not pApp->m_IsMeshletCullingEnabled and pApp->m_pMeshletCuller;
+		return;
+	}
+
+	// creates the pipelines a scene with every combination of material state would need in the new mode, so toggling
+	// back and forth compares how many each needs
+	if (key == GLFW_KEY_D)
+	{
+		pApp->m_IsExtendedDynamicStateEnabled = not pApp->m_IsExtendedDynamicStateEnabled;
+		pApp->createMaterialStatePipelines();
+		return;
+	}
+
+	// reports how much the mode being left shaded, so toggling back and forth compares the two
+	if (key == GLFW_KEY_P)
+	{
+		if (std::optional<PipelineStatistics> const statistics{ pApp->m_PipelineStatisticsQueries.getStatistics() })
+		{
+			VkExtent2D const renderExtent{ pApp->getRenderExtent() };
+			double const pixelCount{ static_cast<double>(renderExtent.width) * renderExtent.height };
+			std::cout << std::format("depth pre-pass {}: {} fragment shader invocations, {:.2f} per pixel\n", pApp->m_IsDepthPrePassEnabled ? "on" : "off",
+				statistics->fragmentShaderInvocations, static_cast<double>(statistics->fragmentShaderInvocations) / pixelCount);
+		}
+
+		pApp->m_IsDepthPrePassEnabled = not pApp->m_IsDepthPrePassEnabled;
+		return;
+	}
+
+#if defined fro_RUNTIME_SHADER_COMPILATION
+	// what the extra spirv-opt passes saved on every shader compiled so far; embedded shaders get theirs printed by
+	// ShaderBaker
+	if (key == GLFW_KEY_S)
+	{
+		for (ShaderStatistics const& statistics : ShaderCompiler::getStatistics())
+			std::cout << std::format("{} ({}): {} bytes and {} instructions compiled, {} bytes and {} instructions optimized\n", statistics.name,
+				statistics.profile == ShaderCompileProfile::Release ? "release" : "debug", statistics.compiledSize.byteSize, statistics.compiledSize.instructionCount,
+				statistics.optimizedSize.byteSize, statistics.optimizedSize.instructionCount);
+
+		return;
+	}
+#endif
+
+	// going back to a fixed resolution renders at the full output resolution
+	if (key == GLFW_KEY_R)
+	{
+		pApp->m_IsDynamicResolutionEnabled = not pApp->m_IsDynamicResolutionEnabled;
+		if (not pApp->m_IsDynamicResolutionEnabled)
+			pApp->m_ResolutionController.reset();
+
+		std::optional<double> const frameTime{ pApp->m_TimestampQueries.getFrameTime() };
+		std::cout << std::format("dynamic resolution {}, last GPU frame time {:.3f}ms, rendering at {:.0f}% scale\n",
+			pApp->m_IsDynamicResolutionEnabled ? "on" : "off", frameTime.value_or(0.0), pApp->m_ResolutionController.getScale() * 100.0f);
+		return;
+	}
+
+	// resizing recreates the swap chain on every size change, so its cost is only reported when asked for
+	if (key == GLFW_KEY_C)
+	{
+		std::cout << std::format("swap chain last recreated at {}x{} in {:.3f}ms\n",
+			pApp->m_SwapChainImageExtent.width, pApp->m_SwapChainImageExtent.height, pApp->m_SwapChainRecreateTime);
+		return;
+	}
+
+	// the render graph picks up the new sample count for its transient attachments on the next frame by itself, and
+	// frames keep rendering with the old one until the pipeline library has the pipelines for it
+	if (key == GLFW_KEY_N)
+	{
+		VkSampleCountFlags sampleCount{ static_cast<VkSampleCountFlags>(pApp->m_SampleCount) };
+		do
+			sampleCount = sampleCount == VK_SAMPLE_COUNT_64_BIT ? static_cast<VkSampleCountFlags>(VK_SAMPLE_COUNT_1_BIT) : sampleCount << 1;
+		while (not (sampleCount & pApp->m_AttachmentSampleCounts));
+
+		pApp->m_SampleCount = static_cast<VkSampleCountFlagBits>(sampleCount);
+
+		PipelineLibraryStatistics const statistics{ pApp->m_PipelineLibrary.getStatistics() };
+		std::cout << std::format("switching to {} samples, {} pipeline libraries, {} fast linked and {} optimized pipelines, {} pipelines and {} optimizations pending, {} of {} frames waited on pipeline compiles and {} skipped their draws\n",
+			static_cast<std::uint32_t>(pApp->m_SampleCount), statistics.libraryCount, statistics.fastLinkedPipelineCount, statistics.optimizedPipelineCount,
+			statistics.pendingPipelineCount, statistics.pendingOptimizationCount, statistics.waitingFrameCount, statistics.frameCount, statistics.hitchedFrameCount);
+		return;
+	}
+
+	SamplerQuality quality{ pApp->m_SamplerCache.getQuality() };
+
+	switch (key)
+	{
+	case GLFW_KEY_LEFT_BRACKET:
+		quality.maxAnisotropy /= 2.0f;
+		break;
+
+	case GLFW_KEY_RIGHT_BRACKET:
+		quality.maxAnisotropy *= 2.0f;
+		break;
+
+	case GLFW_KEY_MINUS:
+		quality.mipLodBias -= g_SamplerLodBiasStep;
+		break;
+
+	case GLFW_KEY_EQUAL:
+		quality.mipLodBias += g_SamplerLodBiasStep;
+		break;
+
+	default:
+		return;
+	}
+
+	pApp->m_SamplerCache.setQuality(quality);
+}
 #pragma endregion PublicMethods
\ No newline at end of file
@@ -1,6 +1,22 @@
 #pragma once
 
+#include "AssetPack.h"
+#include "GeometryBuffer.h"
 #include "HelperStructs.h"
+#include "LayoutCache.h"
+#include "MeshletCuller.h"
+#include "PipelineLibrary.h"
+#include "PipelineStatisticsQueries.h"
+#include "RenderGraph.h"
+#include "ResolutionController.h"
+#include "SamplerCache.h"
+#include "ShaderReflection.h"
+#include "ShaderVariants.h"
+#include "TextureLoader.h"
+#include "TextureStreamer.h"
+#include "TimestampQueries.h"
+#include "Upscaler.h"
+#include "VirtualTexture.h"
 #include "Window.h"
 
 #include <Vulkan/vulkan_core.h>
@@ -8,6 +24,7 @@
 #include <functional>
 #include <optional>
 #include <array>
+#include <chrono>
 #include <xstring>
 
 struct GLFWwindow;
@@ -17,6 +34,39 @@ namespace fro
 	constexpr int g_WindowWidth{ 800 };
 	constexpr int g_WindowHeight{ 600 };
 	std::vector<std::string_view> const vPhysicalDeviceExtensionNames{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+	std::vector<std::string_view> const vOptionalPhysicalDeviceExtensionNames
+	{
+		VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+		VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+		VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+		VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME
+	};
+	glm::vec3 const g_CameraPosition{ 2.0f, 2.0f, 2.0f };
+	float constexpr g_FieldOfViewDegrees{ 45.0f };
+	float constexpr g_NearPlane{ 0.1f };
+	// how far, in pixels, the drawn level of detail may stray from the full detail mesh
+	float constexpr g_MaxLodErrorPixels{ 1.0f };
+	VkDeviceSize constexpr g_TextureStreamingBudget{ 256ull * 1024 * 1024 };
+	std::vector<std::string_view> const vKtx2TexturePaths{ "Textures/texture_bc7.ktx2", "Textures/texture_astc.ktx2", "Textures/texture_etc2.ktx2" };
+	std::string_view const assetPackPath{ "Textures/textures.frpk" };
+	std::vector<std::string_view> const vPackedTextureNames{ "texture_bc7", "texture_astc", "texture_etc2", "texture" };
+	std::string_view const virtualTextureName{ "texture_virtual" };
+	std::string_view const meshPath{ "Models/model.obj" };
+	std::uint32_t constexpr g_VirtualTexturePhysicalTiles{ 1024 };
+	// initial geometry buffer capacities, in vertices and indices; it grows to fit
+	std::uint32_t constexpr g_GeometryVertexCapacity{ 1 << 20 };
+	std::uint32_t constexpr g_GeometryIndexCapacity{ 1 << 22 };
+	// tried first, falling back to no multisampling
+	VkSampleCountFlagBits constexpr g_DefaultSampleCount{ VK_SAMPLE_COUNT_4_BIT };
+	// the scene renders in this before it gets upscaled to the swap chain; any format the upscaler can sample works
+	VkFormat constexpr g_SceneColorFormat{ VK_FORMAT_R16G16B16A16_SFLOAT };
+	// a 60 frames per second budget, rendering at no less than half the output resolution per axis
+	ResolutionControllerSettings constexpr g_ResolutionControllerSettings{ 1000.0 / 60.0, 0.5f, 1.0f, 0.05, 0.05f };
+	float constexpr g_UpscaleSharpness{ 0.8f };
+	MaterialState constexpr g_MaterialState{ VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_COUNTER_CLOCKWISE, VK_FALSE };
+	// at runtime M toggles meshlet culling, P the depth pre-pass, D extended dynamic state, N steps through the sample counts, R toggles dynamic resolution, [ and ] halve and double the anisotropy, - and = shift the LOD bias by half a level
+	SamplerQuality constexpr g_DefaultSamplerQuality{ 16.0f, 0.0f };
+	float constexpr g_SamplerLodBiasStep{ 0.5f };
 
 	class VulkanApplication final
 	{
@@ -28,6 +78,23 @@ namespace fro
 		void run();
 
 	private:
+		// the forward pipeline tests for EQUAL depth when there's a depth pre-pass pipeline
+		struct FramePipelines final
+		{
+			GraphicsPipeline pipeline;
+			std::optional<GraphicsPipeline> depthPrePassPipeline;
+		};
+
+		// what the D key queued, reported once the workers are done with it
+		struct MaterialStateSweep final
+		{
+			bool isExtendedDynamicStateEnabled;
+			std::size_t materialStateCount;
+			std::size_t newPipelineCount;
+			double creationTimeBefore;
+			std::chrono::high_resolution_clock::time_point start;
+		};
+
 		VulkanApplication(const VulkanApplication&) = delete;
 		VulkanApplication(VulkanApplication&&) noexcept = delete;
 
@@ -36,18 +103,28 @@ namespace fro
 
 		void render();
 		void recreateSwapChain();
-		std::pair<std::unique_ptr<VkBuffer_T, std::function<void(VkBuffer_T*)>>, std::unique_ptr<VkDeviceMemory_T, std::function<void(VkDeviceMemory_T*)>>>
-		createVertexBuffer();
-		std::pair<std::unique_ptr<VkBuffer_T, std::function<void(VkBuffer_T*)>>, std::unique_ptr<VkDeviceMemory_T, std::function<void(VkDeviceMemory_T*)>>>
-		createIndexBuffer();
+		std::optional<FramePipelines> getFramePipelines(VkSampleCountFlagBits const sampleCount, bool const isDepthPrePassEnabled, bool const isExtendedDynamicStateEnabled);
+		GraphicsPipelineDescription getForwardPipelineDescription(VkSampleCountFlagBits const sampleCount, bool const isDepthPrePassEnabled, bool const isExtendedDynamicStateEnabled) const;
+		GraphicsPipelineDescription getDepthPrePassPipelineDescription(VkSampleCountFlagBits const sampleCount, bool const isExtendedDynamicStateEnabled) const;
+		// the fragment shader's specialization constants, by constant_id
+		std::vector<std::uint32_t> getFragmentSpecializationConstants() const;
+		void createMaterialStatePipelines();
+		void reportMaterialStatePipelines();
 		void createUniformBuffers();
 		void updateUniformBuffer();
 		void createDescriptorSets();
-		void createTextureImage();
-		void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-		void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
-		void createTextureImageView();
+		void createMeshletCuller();
+		void writeDescriptorSet(std::uint32_t index);
+		AssetPackEntry const* findVirtualTexture() const;
+		Mesh loadMesh() const;
+		std::size_t loadTexture();
+		VkImageView getTextureImageView() const;
+		VkSampler getTextureSampler();
+		float getTextureScreenSpaceSize() const;
+		std::size_t selectMeshLod() const;
+		VkExtent2D getRenderExtent() const;
 		static void framebufferResizeCallback(GLFWwindow* window, int width, int height);
+		static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
 		Window const m_Window{ "Vulkan", g_WindowWidth, g_WindowHeight };
 
@@ -61,38 +138,72 @@ namespace fro
 		VkFormat m_SwapChainImageFormat;
 		VkExtent2D m_SwapChainImageExtent;
 		std::vector<VkImage> m_vSwapChainImages;
-		std::vector<std::unique_ptr<VkImageView_T, std::function<void(VkImageView_T*)>>> m_vpSwapChainImageViews;
-		std::unique_ptr<VkDescriptorSetLayout_T, std::function<void(VkDescriptorSetLayout_T*)>> const m_pDescriptorSetLayout;
+		std::unique_ptr<AssetPack> const m_pAssetPack;
+		// a tiled entry in the asset pack switches the quad over to virtual texturing, which needs its own shader variant
+		AssetPackEntry const* const m_pVirtualTextureEntry;
+		ShaderVariants m_VertexShaderVariants;
+		ShaderVariants m_FragmentShaderVariants;
+		std::vector<std::uint32_t> const& m_vVertexShaderBytecode;
+		std::vector<std::uint32_t> const& m_vFragmentShaderBytecode;
+		std::vector<std::uint32_t> const& m_vDepthOnlyVertexShaderBytecode;
+		ShaderReflection const m_ShaderReflection;
+		LayoutCache m_LayoutCache;
+		SamplerCache m_SamplerCache;
+		std::vector<VkDescriptorSetLayout> const m_vDescriptorSetLayouts;
 		std::uint32_t const m_FramesInFlight;
 		std::unique_ptr<VkDescriptorPool_T, std::function<void(VkDescriptorPool_T*)>> m_pDescriptorPool;
-		std::unique_ptr<VkPipelineLayout_T, std::function<void(VkPipelineLayout_T*)>> const m_pPipelineLayout;
-		std::unique_ptr<VkRenderPass_T, std::function<void(VkRenderPass_T*)>> const m_pRenderPass;
-		std::unique_ptr<VkPipeline_T, std::function<void(VkPipeline_T*)>> const m_pPipeline;
-		std::vector<std::unique_ptr<VkFramebuffer_T, std::function<void(VkFramebuffer_T*)>>> m_vpSwapChainFrameBuffers;
+		VkPipelineLayout const m_PipelineLayout;
+		VkFormat const m_DepthFormat;
+		VkSampleCountFlags const m_AttachmentSampleCounts;
+		VkSampleCountFlagBits m_SampleCount;
+		// the forward and depth pre-pass pipelines are looked up every frame, for the current sample count, depth
+		// pre-pass and extended dynamic state setting
+		PipelineLibrary m_PipelineLibrary;
+		bool m_IsDepthPrePassEnabled;
+		bool m_IsExtendedDynamicStateEnabled;
+		// what the last frame whose pipelines were all ready rendered with
+		VkSampleCountFlagBits m_RenderedSampleCount;
+		bool m_IsDepthPrePassRendered;
+		bool m_IsExtendedDynamicStateRendered;
+		std::optional<MaterialStateSweep> m_MaterialStateSweep;
 		std::unique_ptr<VkCommandPool_T, std::function<void(VkCommandPool_T*)>> const m_pCommandPool;
 		std::vector<VkCommandBuffer> const m_vCommandBuffers;
+		RenderGraph m_RenderGraph;
+		PipelineStatisticsQueries m_PipelineStatisticsQueries;
+		TimestampQueries m_TimestampQueries;
+		ResolutionController m_ResolutionController;
+		bool m_IsDynamicResolutionEnabled;
+		Upscaler const m_Upscaler;
 		std::vector<std::unique_ptr<VkSemaphore_T, std::function<void(VkSemaphore_T*)>>> const m_vpImageAvailableSemaphores;
 		std::vector<std::unique_ptr<VkSemaphore_T, std::function<void(VkSemaphore_T*)>>> const m_vpRenderFinishedSemaphores;
 		std::vector<std::unique_ptr<VkFence_T, std::function<void(VkFence_T*)>>> const m_vpInFlightFences;
 		uint32_t m_CurrentFrame;
 		bool m_FramebufferResized;
-		std::vector<Vertex> const m_vVertices;
-		std::vector<std::uint16_t> const m_vIndices;
-		std::pair<
-			std::unique_ptr<VkBuffer_T, std::function<void(VkBuffer_T*)>>,
-			std::unique_ptr<VkDeviceMemory_T, std::function<void(VkDeviceMemory_T*)>>> m_pVertexBuffer;
-		std::pair<
-			std::unique_ptr<VkBuffer_T, std::function<void(VkBuffer_T*)>>,
-			std::unique_ptr<VkDeviceMemory_T, std::function<void(VkDeviceMemory_T*)>>> m_pIndexBuffer;
+		// how long the last swap chain recreation took, in milliseconds; the C key reports it
+		double m_SwapChainRecreateTime;
+		// the quad, unless there's a model to import, which then comes with its levels of detail
+		Mesh const m_Mesh;
+		std::vector<QuantizedVertex> const m_vVertices;
+		PackedIndices const m_Indices;
+		// every mesh's vertices and indices, sharing the first mesh's index type
+		GeometryBuffer m_GeometryBuffer;
+		GeometryBuffer::MeshHandle const m_MeshHandle;
 		std::vector<std::pair<
 			std::unique_ptr<VkBuffer_T, std::function<void(VkBuffer_T*)>>,
 			std::unique_ptr<VkDeviceMemory_T, std::function<void(VkDeviceMemory_T*)>>>> m_vpUniformBuffers;
 		std::vector<void*> m_vUniformBuffersMapped;
 		std::vector<VkDescriptorSet> m_vDescriptorSets;
-		std::pair<
-			std::unique_ptr<VkImage_T, std::function<void(VkImage_T*)>>,
-			std::unique_ptr<VkDeviceMemory_T, std::function<void(VkDeviceMemory_T*)>>> m_pTextureImage;
-		std::unique_ptr<VkImageView_T, std::function<void(VkImageView_T*)>> m_pTextureImageView;
-		std::unique_ptr<VkSampler_T, std::function<void(VkSampler_T*)>> m_pTextureImageSampler;
+		std::vector<std::uint64_t> m_vDescriptorSetResidencyVersions;
+		std::vector<std::uint64_t> m_vDescriptorSetSamplerQualityVersions;
+		// null when the graphics queue can't run compute work
+		std::unique_ptr<MeshletCuller> m_pMeshletCuller;
+		bool m_IsMeshletCullingEnabled;
+		AssetPackEntry const* const m_pPackedTexture;
+		TextureLoader m_TextureLoader;
+		std::unique_ptr<TextureStreamer> const m_pTextureStreamer;
+		std::unique_ptr<VirtualTexture> const m_pVirtualTexture;
+		// a TextureStreamer handle when the texture is streamed from the asset pack, a TextureLoader one otherwise,
+		// and none for a virtual texture
+		std::optional<std::size_t> const m_TextureHandle;
 	};
 }
\ No newline at end of file